@@ -6,6 +6,8 @@ import com.facebook.react.bridge.JavaScriptContextHolder;
 import com.facebook.react.bridge.ReactApplicationContext;
 import com.facebook.react.bridge.ReactContextBaseJavaModule;
 import com.facebook.react.bridge.ReactMethod;
+import com.facebook.react.turbomodule.core.CallInvokerHolderImpl;
+import java.io.File;
 
 public class VisionJsiProcessorModule extends ReactContextBaseJavaModule {
   public static final String NAME = "VisionJsiProcessor";
@@ -25,13 +27,17 @@ public class VisionJsiProcessorModule extends ReactContextBaseJavaModule {
   }
 
   // Native method from C++.
-  public static native void nativeInstall(long jsi);
+  public static native void nativeInstall(long jsi, CallInvokerHolderImpl callInvokerHolder, String modelCacheDir);
 
   @ReactMethod(isBlockingSynchronousMethod = true)
   public void install() {
     JavaScriptContextHolder jsContext = getReactApplicationContext().getJavaScriptContextHolder();
     if(jsContext.get() != 0) {
-      nativeInstall(jsContext.get());
+      CallInvokerHolderImpl callInvokerHolder =
+        (CallInvokerHolderImpl) getReactApplicationContext().getJSCallInvokerHolder();
+      // Optimized models are derived data, so they live in the cache dir the OS may clear.
+      File modelCacheDir = new File(getReactApplicationContext().getCacheDir(), "onnx-models");
+      nativeInstall(jsContext.get(), callInvokerHolder, modelCacheDir.getAbsolutePath());
     } else {
       Log.e("VisionJSIProcessor", "JSI Runtime is not available in debug mode");
     }
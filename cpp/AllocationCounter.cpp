@@ -0,0 +1,100 @@
+#include "AllocationCounter.h"
+
+#ifdef DCSP_COUNT_ALLOCATIONS
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+
+static thread_local uint64_t threadAllocations = 0;
+static thread_local int pauseDepth = 0;
+
+
+uint64_t ThreadAllocationCount() {
+    return threadAllocations;
+}
+
+
+AllocationPause::AllocationPause() {
+    pauseDepth++;
+}
+
+
+AllocationPause::~AllocationPause() {
+    pauseDepth--;
+}
+
+
+static void *CountedAlloc(size_t size, size_t alignment) {
+    if (pauseDepth == 0) {
+        threadAllocations++;
+    }
+    if (size == 0) {
+        size = 1;
+    }
+    void *ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = std::malloc(size);
+    } else if (posix_memalign(&ptr, alignment, size) != 0) {
+        ptr = nullptr;
+    }
+    return ptr;
+}
+
+
+void *operator new(size_t size) {
+    void *ptr = CountedAlloc(size, alignof(std::max_align_t));
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    void *ptr = CountedAlloc(size, static_cast<size_t>(alignment));
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return CountedAlloc(size, alignof(std::max_align_t));
+}
+
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return CountedAlloc(size, alignof(std::max_align_t));
+}
+
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+
+// Debug instrumentation for the zero-allocation hot path. Builds that define
+// DCSP_COUNT_ALLOCATIONS and link AllocationCounter.cpp replace the global operator new with a
+// version that counts calls per thread; everywhere else these compile to nothing.
+//
+// Calls into ONNX Runtime allocate internally and are outside our control, so they are wrapped in
+// AllocationPause and left out of the count.
+#ifdef DCSP_COUNT_ALLOCATIONS
+
+// operator new calls made on this thread outside an AllocationPause.
+uint64_t ThreadAllocationCount();
+
+class AllocationPause {
+public:
+    AllocationPause();
+
+    ~AllocationPause();
+
+    AllocationPause(const AllocationPause &) = delete;
+
+    AllocationPause &operator=(const AllocationPause &) = delete;
+};
+
+#else
+
+inline uint64_t ThreadAllocationCount() { return 0; }
+
+class AllocationPause {
+public:
+    AllocationPause() {}
+};
+
+#endif
+
+constexpr bool AllocationCountingEnabled() {
+#ifdef DCSP_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
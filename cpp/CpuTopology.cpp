@@ -0,0 +1,101 @@
+#include "CpuTopology.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+
+static long ReadMaxFrequency(int cpu) {
+    char path[96];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+    FILE *file = std::fopen(path, "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    long frequency = 0;
+    if (std::fscanf(file, "%ld", &frequency) != 1) {
+        frequency = 0;
+    }
+    std::fclose(file);
+    return frequency;
+}
+
+
+static CPU_TOPOLOGY DetectCpuTopology() {
+    CPU_TOPOLOGY topology;
+#if defined(__linux__)
+    topology.coreCount = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+#else
+    topology.coreCount = static_cast<int>(std::thread::hardware_concurrency());
+#endif
+    topology.coreCount = std::max(topology.coreCount, 1);
+
+    std::vector<long> frequencies(topology.coreCount);
+    long slowest = 0;
+    for (int cpu = 0; cpu < topology.coreCount; cpu++) {
+        frequencies[cpu] = ReadMaxFrequency(cpu);
+        if (frequencies[cpu] > 0 && (slowest == 0 || frequencies[cpu] < slowest)) {
+            slowest = frequencies[cpu];
+        }
+    }
+    bool heterogeneous = std::any_of(frequencies.begin(), frequencies.end(),
+                                     [slowest](long f) { return f > slowest; });
+    for (int cpu = 0; cpu < topology.coreCount; cpu++) {
+        if (heterogeneous && frequencies[cpu] <= slowest) {
+            topology.littleCores.push_back(cpu);
+        } else {
+            topology.bigCores.push_back(cpu);
+        }
+    }
+    return topology;
+}
+
+
+const CPU_TOPOLOGY &GetCpuTopology() {
+    static const CPU_TOPOLOGY topology = DetectCpuTopology();
+    return topology;
+}
+
+
+char *PinCurrentThread(const std::vector<int> &cores) {
+#if defined(__linux__)
+    if (cores.empty()) {
+        return RET_OK;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu: cores) {
+        CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        return "[DCSP_ONNX]:sched_setaffinity failed.";
+    }
+#endif
+    return RET_OK;
+}
+
+
+std::string IntraOpAffinityString(int threads, const std::vector<int> &cores) {
+    if (threads <= 1 || cores.empty()) {
+        return "";
+    }
+    std::string cpuList;
+    for (size_t i = 0; i < cores.size(); i++) {
+        if (i > 0) {
+            cpuList += ',';
+        }
+        cpuList += std::to_string(cores[i] + 1);
+    }
+    std::string affinity;
+    for (int t = 1; t < threads; t++) {
+        if (t > 1) {
+            affinity += ';';
+        }
+        affinity += cpuList;
+    }
+    return affinity;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <string>
+#include <vector>
+
+
+typedef struct _CPU_TOPOLOGY {
+    int coreCount = 0;
+    // 0-based logical CPU ids. On big.LITTLE parts "little" is the slowest cluster (by
+    // cpuinfo_max_freq) and "big" is everything else; on uniform parts all cores are big.
+    std::vector<int> bigCores;
+    std::vector<int> littleCores;
+} CPU_TOPOLOGY;
+
+
+// Reads /sys/devices/system/cpu once and caches the result.
+const CPU_TOPOLOGY &GetCpuTopology();
+
+// Restricts the calling thread to cores (Linux/Android only, no-op elsewhere).
+char *PinCurrentThread(const std::vector<int> &cores);
+
+// Value for ORT's intra-op affinity settings: one entry per pool thread (threads - 1, the caller
+// is the remaining one), each allowing every core in cores. ORT numbers processors from 1.
+std::string IntraOpAffinityString(int threads, const std::vector<int> &cores);
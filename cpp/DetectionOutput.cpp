@@ -0,0 +1,90 @@
+#include "DetectionOutput.h"
+#include <cstdio>
+#include <cstring>
+
+
+void PackDetections(const std::vector<DCSP_RESULT> &results, float *oPacked) {
+    size_t count = results.size();
+    oPacked[0] = static_cast<float>(count);
+    oPacked[1] = static_cast<float>(PACKED_FIELD_COUNT);
+    float *classIds = oPacked + PACKED_HEADER_SIZE;
+    float *confidences = classIds + count;
+    float *xs = confidences + count;
+    float *ys = xs + count;
+    float *widths = ys + count;
+    float *heights = widths + count;
+    float *trackIds = heights + count;
+    for (size_t i = 0; i < count; i++) {
+        const DCSP_RESULT &res = results[i];
+        classIds[i] = static_cast<float>(res.classId);
+        confidences[i] = res.confidence;
+        xs[i] = static_cast<float>(res.box.x);
+        ys[i] = static_cast<float>(res.box.y);
+        widths[i] = static_cast<float>(res.box.width);
+        heights[i] = static_cast<float>(res.box.height);
+        trackIds[i] = static_cast<float>(res.trackId);
+    }
+}
+
+
+static const char *DetectionClassName(const DCSP_RESULT &res, const std::vector<std::string> &classes) {
+    return (res.classId >= 0 && res.classId < static_cast<int>(classes.size()))
+           ? classes[res.classId].c_str() : "unknown";
+}
+
+
+// printf spelling of the ostringstream formatting (std::fixed, precision 5) used originally.
+// track_id is only present for tracked detections, untracked output is unchanged.
+static int WriteDetectionJson(const DCSP_RESULT &res, const char *className, char *oBuffer, size_t capacity) {
+    if (res.trackId >= 0) {
+        return snprintf(oBuffer, capacity,
+                        "{ \"class_id\": %d, \"class_name\": \"%s\", \"confidence\": %.5f, \"box\": [%d, %d, %d, %d], "
+                        "\"track_id\": %d }",
+                        res.classId, className, static_cast<double>(res.confidence),
+                        res.box.x, res.box.y, res.box.width, res.box.height, res.trackId);
+    }
+    return snprintf(oBuffer, capacity,
+                    "{ \"class_id\": %d, \"class_name\": \"%s\", \"confidence\": %.5f, \"box\": [%d, %d, %d, %d] }",
+                    res.classId, className, static_cast<double>(res.confidence),
+                    res.box.x, res.box.y, res.box.width, res.box.height);
+}
+
+
+std::string FormatDetectionJson(const DCSP_RESULT &res, const std::vector<std::string> &classes) {
+    const char *className = DetectionClassName(res, classes);
+    int length = WriteDetectionJson(res, className, nullptr, 0);
+    std::string text(length, '\0');
+    WriteDetectionJson(res, className, text.data(), text.size() + 1);
+    return text;
+}
+
+
+const char *FormatDetectionJson(const DCSP_RESULT &res, const std::vector<std::string> &classes,
+                                FrameArena &arena, size_t &oLength) {
+    const char *className = DetectionClassName(res, classes);
+    // Enough for the fixed text, six ints and any confidence in [0, 1000); anything longer
+    // is measured and formatted again.
+    size_t capacity = 160 + strlen(className);
+    char *text = arena.AllocateArray<char>(capacity);
+    int length = WriteDetectionJson(res, className, text, capacity);
+    if (static_cast<size_t>(length) >= capacity) {
+        capacity = static_cast<size_t>(length) + 1;
+        text = arena.AllocateArray<char>(capacity);
+        WriteDetectionJson(res, className, text, capacity);
+    }
+    oLength = static_cast<size_t>(length);
+    return text;
+}
+
+
+bool ParseDetectionOutputFormat(const std::string &name, DETECTION_OUTPUT_FORMAT &oFormat) {
+    if (name == "json") {
+        oFormat = DETECTION_OUTPUT_JSON;
+        return true;
+    }
+    if (name == "packed") {
+        oFormat = DETECTION_OUTPUT_PACKED;
+        return true;
+    }
+    return false;
+}
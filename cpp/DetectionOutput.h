@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Inference.h"
+#include "FrameArena.h"
+
+
+enum DETECTION_OUTPUT_FORMAT {
+    // One JSON string per detection (original API).
+    DETECTION_OUTPUT_JSON = 0,
+    // A single Float32Array, see PackDetections.
+    DETECTION_OUTPUT_PACKED = 1
+};
+
+
+// Packed layout, struct-of-arrays so JS can read each field as a contiguous subarray:
+//   [0] count, [1] field count (PACKED_FIELD_COUNT),
+//   then `count` values each of classId, confidence, x, y, width, height, trackId (-1 if untracked).
+// New fields are only ever appended, so readers that know the first N fields keep working.
+constexpr int PACKED_HEADER_SIZE = 2;
+constexpr int PACKED_FIELD_COUNT = 7;
+
+
+inline size_t PackedDetectionsLength(size_t count) {
+    return PACKED_HEADER_SIZE + PACKED_FIELD_COUNT * count;
+}
+
+
+// Writes PackedDetectionsLength(results.size()) floats into oPacked.
+void PackDetections(const std::vector<DCSP_RESULT> &results, float *oPacked);
+
+
+std::string FormatDetectionJson(const DCSP_RESULT &result, const std::vector<std::string> &classes);
+
+// Same text, formatted into the arena instead of a std::string. Valid until the arena's next Reset().
+const char *FormatDetectionJson(const DCSP_RESULT &result, const std::vector<std::string> &classes,
+                                FrameArena &arena, size_t &oLength);
+
+
+bool ParseDetectionOutputFormat(const std::string &name, DETECTION_OUTPUT_FORMAT &oFormat);
@@ -0,0 +1,427 @@
+#include "DetectorHostObject.h"
+#include "ModelRegistry.h"
+#include "Log.h"
+#include <stdexcept>
+
+static std::string getStringProperty(jsi::Runtime &runtime, const jsi::Object &object, const char *name,
+                                     const std::string &fallback) {
+  jsi::Value value = object.getProperty(runtime, name);
+  return value.isString() ? value.asString(runtime).utf8(runtime) : fallback;
+}
+
+static double getNumberProperty(jsi::Runtime &runtime, const jsi::Object &object, const char *name, double fallback) {
+  jsi::Value value = object.getProperty(runtime, name);
+  return value.isNumber() ? value.asNumber() : fallback;
+}
+
+DETECTOR_CONFIG parseDetectorConfig(jsi::Runtime &runtime, const jsi::Object &object) {
+  DETECTOR_CONFIG config;
+  config.modelPath = getStringProperty(runtime, object, "modelPath", "");
+  if (config.modelPath.empty()) {
+    throw jsi::JSError(runtime, "createDetector: modelPath is required");
+  }
+  config.modelType = getStringProperty(runtime, object, "modelType", config.modelType);
+  config.inputWidth = static_cast<int>(getNumberProperty(runtime, object, "inputWidth", config.inputWidth));
+  config.inputHeight = static_cast<int>(getNumberProperty(runtime, object, "inputHeight", config.inputHeight));
+  if (config.inputWidth <= 0 || config.inputHeight <= 0) {
+    throw jsi::JSError(runtime, "createDetector: invalid model input dimensions");
+  }
+  config.confidenceThreshold = static_cast<float>(
+      getNumberProperty(runtime, object, "confidenceThreshold", config.confidenceThreshold));
+  config.nmsThreshold = static_cast<float>(getNumberProperty(runtime, object, "nmsThreshold", config.nmsThreshold));
+  config.scoreThreshold = static_cast<float>(
+      getNumberProperty(runtime, object, "scoreThreshold", config.scoreThreshold));
+  config.frameWidth = static_cast<int>(getNumberProperty(runtime, object, "frameWidth", 0));
+  config.frameHeight = static_cast<int>(getNumberProperty(runtime, object, "frameHeight", 0));
+  config.frameChannels = static_cast<int>(getNumberProperty(runtime, object, "frameChannels", 3));
+  jsi::Value tracking = object.getProperty(runtime, "tracking");
+  config.tracking = tracking.isBool() && tracking.getBool();
+  config.tracker.detectInterval = static_cast<int>(
+      getNumberProperty(runtime, object, "detectInterval", config.tracker.detectInterval));
+  config.tracker.maxAge = static_cast<int>(getNumberProperty(runtime, object, "trackMaxAge", config.tracker.maxAge));
+  config.tracker.minTrackConfidence = static_cast<float>(
+      getNumberProperty(runtime, object, "minTrackConfidence", config.tracker.minTrackConfidence));
+  if (config.tracker.detectInterval < 1) {
+    throw jsi::JSError(runtime, "createDetector: detectInterval must be at least 1");
+  }
+  config.motionGate.threshold = static_cast<float>(
+      getNumberProperty(runtime, object, "motionThreshold", config.motionGate.threshold));
+  config.motionGate.maxSkipFrames = static_cast<int>(
+      getNumberProperty(runtime, object, "motionMaxSkipFrames", config.motionGate.maxSkipFrames));
+  if (config.motionGate.threshold < 0 || config.motionGate.maxSkipFrames < 0) {
+    throw jsi::JSError(runtime, "createDetector: motionThreshold and motionMaxSkipFrames must be non-negative");
+  }
+
+  jsi::Value tiles = object.getProperty(runtime, "tiles");
+  if (tiles.isObject()) {
+    jsi::Object tileOptions = tiles.asObject(runtime);
+    config.tiled = true;
+    config.tiles.columns = static_cast<int>(getNumberProperty(runtime, tileOptions, "columns", config.tiles.columns));
+    config.tiles.rows = static_cast<int>(getNumberProperty(runtime, tileOptions, "rows", config.tiles.rows));
+    config.tiles.overlap = static_cast<float>(getNumberProperty(runtime, tileOptions, "overlap", config.tiles.overlap));
+    config.tiles.mergeThreshold = static_cast<float>(
+        getNumberProperty(runtime, tileOptions, "mergeThreshold", config.tiles.mergeThreshold));
+    jsi::Value fullFrame = tileOptions.getProperty(runtime, "fullFrame");
+    if (fullFrame.isBool()) config.tiles.fullFrame = fullFrame.getBool();
+    if (config.tiles.columns < 1 || config.tiles.rows < 1 || config.tiles.overlap < 0 || config.tiles.overlap >= 1) {
+      throw jsi::JSError(runtime, "createDetector: tiles needs columns and rows >= 1 and an overlap in [0, 1)");
+    }
+  }
+
+  std::string executionProvider = getStringProperty(runtime, object, "executionProvider", "cpu");
+  if (!ParseExecutionProvider(executionProvider, config.executionProvider)) {
+    throw jsi::JSError(runtime, std::string("createDetector: executionProvider must be ") + EXECUTION_PROVIDER_NAMES);
+  }
+
+  std::string outputFormat = getStringProperty(runtime, object, "outputFormat", "json");
+  if (!ParseDetectionOutputFormat(outputFormat, config.outputFormat)) {
+    throw jsi::JSError(runtime, "createDetector: outputFormat must be \"json\" or \"packed\"");
+  }
+
+  jsi::Value classesValue = object.getProperty(runtime, "classes");
+  if (!classesValue.isObject() || !classesValue.asObject(runtime).isArray(runtime)) {
+    throw jsi::JSError(runtime, "createDetector: classes must be an array of strings");
+  }
+  jsi::Array classes = classesValue.asObject(runtime).asArray(runtime);
+  size_t length = classes.length(runtime);
+  config.classes.reserve(length);
+  for (size_t i = 0; i < length; i++) {
+    jsi::Value name = classes.getValueAtIndex(runtime, i);
+    if (!name.isString()) throw jsi::JSError(runtime, "createDetector: classes must contain only strings");
+    config.classes.push_back(name.asString(runtime).utf8(runtime));
+  }
+  return config;
+}
+
+DetectionResultSink::DetectionResultSink(std::shared_ptr<react::CallInvoker> callInvoker,
+                                         std::vector<std::string> classes, DETECTION_OUTPUT_FORMAT outputFormat)
+    : callInvoker(std::move(callInvoker)), classes(std::move(classes)), outputFormat(outputFormat) {}
+
+DetectionResultSink::~DetectionResultSink() {
+  releaseOnJsThread(std::move(callback));
+}
+
+void DetectionResultSink::setCallback(std::shared_ptr<jsi::Function> newCallback) {
+  std::shared_ptr<jsi::Function> previous;
+  {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    previous = std::move(callback);
+    callback = std::move(newCallback);
+  }
+  releaseOnJsThread(std::move(previous));
+}
+
+void DetectionResultSink::releaseOnJsThread(std::shared_ptr<jsi::Function> function) {
+  if (!function || !callInvoker) return;
+  callInvoker->invokeAsync([function = std::move(function)](jsi::Runtime &) mutable { function.reset(); });
+}
+
+void DetectionResultSink::post(uint64_t frameId, double latencyMs, char *error, std::vector<DCSP_RESULT> &&results) {
+  {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    if (!callback) return;
+  }
+  std::string errorMessage = error != RET_OK ? error : "";
+  auto self = shared_from_this();
+  callInvoker->invokeAsync([self, frameId, latencyMs, errorMessage, results = std::move(results)](jsi::Runtime &runtime) {
+    std::shared_ptr<jsi::Function> target;
+    {
+      std::lock_guard<std::mutex> lock(self->callbackMutex);
+      target = self->callback;
+    }
+    if (!target) return;
+
+    jsi::Object info(runtime);
+    info.setProperty(runtime, "frameId", static_cast<double>(frameId));
+    info.setProperty(runtime, "latencyMs", latencyMs);
+    if (!errorMessage.empty()) {
+      info.setProperty(runtime, "error", jsi::String::createFromUtf8(runtime, errorMessage));
+    }
+    try {
+      target->call(runtime, detectionsToJsi(runtime, results, self->classes, self->outputFormat), info);
+    } catch (const std::exception &e) {
+      DCSP_LOGE("OnnxDetector", "Result callback threw: %s", e.what());
+    }
+  });
+}
+
+DetectorHostObject::DetectorHostObject(DETECTOR_CONFIG config, std::shared_ptr<react::CallInvoker> callInvoker)
+    : config(std::move(config)), callInvoker(std::move(callInvoker)) {
+  MODEL_KEY key;
+  key.modelPath = this->config.modelPath;
+  key.modelType = this->config.modelType;
+  key.inputWidth = this->config.inputWidth;
+  key.inputHeight = this->config.inputHeight;
+  key.provider = this->config.executionProvider;
+  modelKey = key;
+  if (this->config.tracking) {
+    tracker = std::make_unique<Tracker>(this->config.tracker);
+  }
+  if (this->config.motionGate.threshold > 0.f) {
+    motionGate = std::make_unique<MotionGate>(this->config.motionGate);
+  }
+  // A new detector retries a model whose earlier load failed; its frames only rethrow that error.
+  ModelRegistry::instance().load(modelKey, true);
+}
+
+DetectorHostObject::~DetectorHostObject() {
+  if (pipeline) {
+    // The processor may be shared and outlive this detector; drop the tensors over our slots.
+    std::vector<float *> blobs = pipeline->SlotBlobs();
+    pipeline.reset();
+    processor->unregisterInputBlobs(blobs);
+  }
+}
+
+std::shared_ptr<OnnxFrameProcessor> DetectorHostObject::readyProcessor() {
+  std::lock_guard<std::mutex> lock(processorMutex);
+  if (!processor) {
+    processor = ModelRegistry::instance().acquireIfReady(modelKey);
+  }
+  return processor;
+}
+
+InferencePipeline &DetectorHostObject::ensurePipeline(const std::shared_ptr<OnnxFrameProcessor> &model) {
+  std::lock_guard<std::mutex> lock(pipelineMutex);
+  if (!pipeline) {
+    if (!resultSink) {
+      resultSink = std::make_shared<DetectionResultSink>(callInvoker, config.classes, config.outputFormat);
+    }
+    auto sink = resultSink;
+    pipeline = std::make_unique<InferencePipeline>(
+        model->inputSize(),
+        [this, model](const DCSP_BLOB &blob, std::vector<DCSP_RESULT> &oResult) -> char * {
+          return model->processFrame(blob, config.confidenceThreshold, config.nmsThreshold, config.scoreThreshold,
+                                     oResult);
+        },
+        [sink](uint64_t frameId, double latencyMs, char *error, std::vector<DCSP_RESULT> &&results) {
+          sink->post(frameId, latencyMs, error, std::move(results));
+        });
+    // The slots never move, so their input tensors are created once and only rebound per frame.
+    model->registerInputBlobs(pipeline->SlotBlobs());
+    DCSP_LOGI("OnnxDetector", "Inference pipeline started for %s",
+              config.modelPath.c_str());
+  }
+  return *pipeline;
+}
+
+std::vector<jsi::PropNameID> DetectorHostObject::getPropertyNames(jsi::Runtime &runtime) {
+  std::vector<jsi::PropNameID> result;
+  result.push_back(jsi::PropNameID::forUtf8(runtime, "detect"));
+  result.push_back(jsi::PropNameID::forUtf8(runtime, "detectAsync"));
+  result.push_back(jsi::PropNameID::forUtf8(runtime, "setResultCallback"));
+  result.push_back(jsi::PropNameID::forUtf8(runtime, "pipelineStats"));
+  result.push_back(jsi::PropNameID::forUtf8(runtime, "ready"));
+  result.push_back(jsi::PropNameID::forUtf8(runtime, "modelPath"));
+  result.push_back(jsi::PropNameID::forUtf8(runtime, "inputWidth"));
+  result.push_back(jsi::PropNameID::forUtf8(runtime, "inputHeight"));
+  return result;
+}
+
+// The host functions hold the detector weakly: one kept by JS after the detector was collected
+// throws instead of calling into a destroyed object.
+static std::shared_ptr<DetectorHostObject> lockDetector(jsi::Runtime &runtime,
+                                                        const std::weak_ptr<DetectorHostObject> &detector,
+                                                        const std::string &function) {
+  std::shared_ptr<DetectorHostObject> self = detector.lock();
+  if (!self) {
+    throw jsi::JSError(runtime, function + ": the detector has been released");
+  }
+  return self;
+}
+
+jsi::Function DetectorHostObject::createHostFunction(jsi::Runtime &runtime, const std::string &name) {
+  std::weak_ptr<DetectorHostObject> weakSelf = weak_from_this();
+  if (name == "setResultCallback") {
+    return jsi::Function::createFromHostFunction(
+        runtime, jsi::PropNameID::forUtf8(runtime, name), 1,
+        [weakSelf, name](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *arguments,
+                         size_t count) -> jsi::Value {
+          std::shared_ptr<DetectorHostObject> self = lockDetector(runtime, weakSelf, name);
+          jsi::Value none = jsi::Value::undefined();
+          self->setResultCallback(runtime, count > 0 ? arguments[0] : none);
+          return jsi::Value::undefined();
+        });
+  }
+  bool async = name == "detectAsync";
+  return jsi::Function::createFromHostFunction(
+      runtime, jsi::PropNameID::forUtf8(runtime, name), 1,
+      [weakSelf, name, async](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *arguments,
+                              size_t count) -> jsi::Value {
+        if (count != 1) {
+          throw jsi::JSError(runtime, name + "(frame) expects exactly one argument");
+        }
+        std::shared_ptr<DetectorHostObject> self = lockDetector(runtime, weakSelf, name);
+        return async ? self->detectAsync(runtime, arguments[0]) : self->detect(runtime, arguments[0]);
+      });
+}
+
+jsi::Value DetectorHostObject::get(jsi::Runtime &runtime, const jsi::PropNameID &propName) {
+  auto name = propName.utf8(runtime);
+
+  if (name == "detect" || name == "detectAsync" || name == "setResultCallback") {
+    return createHostFunction(runtime, name);
+  }
+  if (name == "pipelineStats") {
+    PIPELINE_STATS stats;
+    {
+      std::lock_guard<std::mutex> lock(pipelineMutex);
+      if (pipeline) stats = pipeline->Stats();
+    }
+    jsi::Object result(runtime);
+    result.setProperty(runtime, "submitted", static_cast<double>(stats.submitted));
+    result.setProperty(runtime, "completed", static_cast<double>(stats.completed));
+    result.setProperty(runtime, "dropped", static_cast<double>(stats.dropped));
+    return result;
+  }
+  if (name == "ready") {
+    try {
+      return jsi::Value(readyProcessor() != nullptr);
+    } catch (const std::exception &e) {
+      throw jsi::JSError(runtime, std::string("Model failed to load: ") + e.what());
+    }
+  }
+  if (name == "modelPath") {
+    return jsi::String::createFromUtf8(runtime, config.modelPath);
+  }
+  if (name == "inputWidth") {
+    return jsi::Value(config.inputWidth);
+  }
+  if (name == "inputHeight") {
+    return jsi::Value(config.inputHeight);
+  }
+  return jsi::Value::undefined();
+}
+
+void DetectorHostObject::setResultCallback(jsi::Runtime &runtime, const jsi::Value &callbackValue) {
+  std::shared_ptr<jsi::Function> callback;
+  if (callbackValue.isObject() && callbackValue.asObject(runtime).isFunction(runtime)) {
+    callback = std::make_shared<jsi::Function>(callbackValue.asObject(runtime).asFunction(runtime));
+  } else if (!callbackValue.isNull() && !callbackValue.isUndefined()) {
+    throw jsi::JSError(runtime, "setResultCallback expects a function or null");
+  }
+  if (!callInvoker) {
+    throw jsi::JSError(runtime, "setResultCallback: no JS CallInvoker available");
+  }
+  std::lock_guard<std::mutex> lock(pipelineMutex);
+  if (!resultSink) {
+    resultSink = std::make_shared<DetectionResultSink>(callInvoker, config.classes, config.outputFormat);
+  }
+  resultSink->setCallback(std::move(callback));
+}
+
+template<typename Fn>
+void DetectorHostObject::withImage(jsi::Runtime &runtime, const jsi::Value &frame, Fn &&fn) {
+  jsi::Object input = frame.asObject(runtime);
+  try {
+    if (input.isHostObject<vision::FrameHostObject>(runtime)) {
+      auto cameraFrame = input.getHostObject<vision::FrameHostObject>(runtime);
+      LockedYuvFrame locked(cameraFrame->getFrame());
+      fn(locked.image(), locked.meta());
+    } else {
+      if (config.frameWidth <= 0 || config.frameHeight <= 0) {
+        throw jsi::JSError(runtime, "detect: frameWidth/frameHeight must be configured for TypedArray input");
+      }
+      cv::Mat image = typedArrayToMat(runtime, std::move(input), config.frameHeight, config.frameWidth,
+                                      config.frameChannels);
+      fn(image, CaptureMetaNow());
+    }
+  } catch (const jsi::JSError &) {
+    throw;
+  } catch (const std::exception &e) {
+    DCSP_LOGE("OnnxDetector", "Exception in detect: %s", e.what());
+    throw jsi::JSError(runtime, std::string("ONNX Processing Error: ") + e.what());
+  }
+}
+
+jsi::Value DetectorHostObject::detect(jsi::Runtime &runtime, const jsi::Value &frame) {
+  // detect runs synchronously on the frame processor thread; reusing the vector keeps it off the heap.
+  static thread_local std::vector<DCSP_RESULT> detections;
+  std::unique_lock<std::mutex> streamLock(streamMutex, std::defer_lock);
+  if (tracker || motionGate) {
+    streamLock.lock();
+  }
+  if (tracker) {
+    if (!tracker->NeedsDetection()) {
+      // Skipped frame: answered from the tracks alone, the camera frame is not even locked.
+      tracker->Predict(detections);
+      return detectionsToJsi(runtime, detections, config.classes, config.outputFormat);
+    }
+  }
+  bool ready = true;
+  withImage(runtime, frame, [&](const auto &image, const CAPTURE_META &meta) {
+    std::shared_ptr<OnnxFrameProcessor> model = readyProcessor();
+    if (!model) {
+      ready = false;
+      return;
+    }
+    if (motionGate && !motionGate->NeedsInference(image)) {
+      // Static scene: the last inferred detections, track IDs included; the tracker is not advanced.
+      detections = motionGate->Cached();
+    } else {
+      char *runResult = config.tiled
+          ? model->processFrameTiled(image, config.tiles, config.confidenceThreshold, config.nmsThreshold,
+                                     detections)
+          : model->processFrame(image, config.confidenceThreshold, config.nmsThreshold, config.scoreThreshold,
+                                detections);
+      // A failed run neither ages the tracks nor replaces the gate's reference.
+      if (runResult != RET_OK) throw std::runtime_error(runResult);
+      if (tracker) tracker->Update(detections);
+      if (motionGate) motionGate->Commit(detections);
+    }
+    if (FrameCaptureActive()) {
+      CAPTURE_SETTINGS settings = MakeCaptureSettings(config.confidenceThreshold, config.nmsThreshold,
+                                                      config.inputWidth, config.inputHeight, true);
+      CaptureFrame(image, meta, &detections, &settings);
+    }
+  });
+  if (!ready) {
+    return jsi::Value::null();
+  }
+  return detectionsToJsi(runtime, detections, config.classes, config.outputFormat);
+}
+
+jsi::Value DetectorHostObject::detectAsync(jsi::Runtime &runtime, const jsi::Value &frame) {
+  if (!callInvoker) {
+    throw jsi::JSError(runtime, "detectAsync: no JS CallInvoker available");
+  }
+  uint64_t frameId = 0;
+  withImage(runtime, frame, [&](const auto &image, const CAPTURE_META &meta) {
+    std::shared_ptr<OnnxFrameProcessor> model = readyProcessor();
+    if (!model) {
+      return;
+    }
+    // Results arrive later on the inference thread, so async frames are recorded without reference output.
+    if (FrameCaptureActive()) CaptureFrame(image, meta, nullptr);
+    char *submitResult = ensurePipeline(model).Submit(image, frameId);
+    if (submitResult != RET_OK) {
+      throw std::runtime_error(submitResult);
+    }
+  });
+  if (frameId == 0) {
+    return jsi::Value::null();
+  }
+  return jsi::Value(static_cast<double>(frameId));
+}
+
+void DetectorHostObject::registerCreateDetector(jsi::Runtime &runtime,
+                                                std::shared_ptr<react::CallInvoker> callInvoker) {
+  auto createDetector = [callInvoker](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                                      size_t count) -> jsi::Value {
+    if (count != 1 || !args[0].isObject()) {
+      throw jsi::JSError(runtime, "createDetector(config) expects a config object");
+    }
+    DETECTOR_CONFIG config = parseDetectorConfig(runtime, args[0].asObject(runtime));
+    try {
+      auto detector = std::make_shared<DetectorHostObject>(std::move(config), callInvoker);
+      return jsi::Object::createFromHostObject(runtime, detector);
+    } catch (const std::exception &e) {
+      throw jsi::JSError(runtime, std::string("createDetector failed: ") + e.what());
+    }
+  };
+
+  auto func = jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "createDetector"), 1,
+                                                    createDetector);
+  runtime.global().setProperty(runtime, "createDetector", func);
+  DCSP_LOGI("OnnxDetector", "JSI function 'createDetector' registered");
+}
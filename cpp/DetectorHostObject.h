@@ -0,0 +1,127 @@
+#ifndef DETECTOR_HOST_OBJECT_H
+#define DETECTOR_HOST_OBJECT_H
+
+#include <jsi/jsi.h>
+#include <ReactCommon/CallInvoker.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "onnxFrameProcessor.h"
+#include "InferencePipeline.h"
+#include "ModelRegistry.h"
+#include "Tracker.h"
+#include "MotionGate.h"
+
+using namespace facebook;
+
+// Everything processOnnxFrame used to receive positionally on every frame, bound once.
+typedef struct _DETECTOR_CONFIG {
+  std::string modelPath;
+  std::string modelType = "onnx";
+  int inputWidth = 640;
+  int inputHeight = 640;
+  EXECUTION_PROVIDER executionProvider = EP_CPU;
+  std::vector<std::string> classes;
+  float confidenceThreshold = 0.5f;
+  float nmsThreshold = 0.5f;
+  float scoreThreshold = 0.5f;
+  DETECTION_OUTPUT_FORMAT outputFormat = DETECTION_OUTPUT_JSON;
+  // Geometry of TypedArray frames; unused when detect() is given a VisionCamera Frame.
+  int frameWidth = 0;
+  int frameHeight = 0;
+  int frameChannels = 3;
+  // Attach a Tracker to detect(): stable trackIds, and with tracker.detectInterval > 1 the
+  // skipped frames are answered from the tracks' motion model without running the model.
+  bool tracking = false;
+  TRACKER_PARAM tracker;
+  // Gate detect() on frame-to-frame change; threshold 0 leaves it off.
+  MOTION_GATE_PARAM motionGate;
+  // Sliced inference in detect() for small objects; detectAsync always runs the whole frame.
+  bool tiled = false;
+  TILE_PARAM tiles;
+} DETECTOR_CONFIG;
+
+DETECTOR_CONFIG parseDetectorConfig(jsi::Runtime &runtime, const jsi::Object &config);
+
+// Hands pipeline results to the JS thread through the CallInvoker. Shared with the queued
+// invocations so a late result never touches a destroyed detector.
+class DetectionResultSink : public std::enable_shared_from_this<DetectionResultSink> {
+public:
+  DetectionResultSink(std::shared_ptr<react::CallInvoker> callInvoker, std::vector<std::string> classes,
+                      DETECTION_OUTPUT_FORMAT outputFormat);
+
+  // Releases any callback still held on the JS thread.
+  ~DetectionResultSink();
+
+  // Callable from any thread; nullptr stops delivery. The replaced callback is released on the JS thread.
+  void setCallback(std::shared_ptr<jsi::Function> callback);
+
+  void post(uint64_t frameId, double latencyMs, char *error, std::vector<DCSP_RESULT> &&results);
+
+private:
+  // The callback is a JS runtime Function: whichever thread drops it, the last reference dies on the JS thread.
+  void releaseOnJsThread(std::shared_ptr<jsi::Function> function);
+
+  std::shared_ptr<react::CallInvoker> callInvoker;
+  std::vector<std::string> classes;
+  DETECTION_OUTPUT_FORMAT outputFormat;
+  std::mutex callbackMutex;
+  std::shared_ptr<jsi::Function> callback;
+};
+
+// Returned by createDetector(config), which only starts loading the model. Until it is ready
+// detect and detectAsync return null (see the `ready` property). detect(frame) runs inline; detectAsync(frame) only
+// letterboxes the frame and queues it for the detector's inference thread, whose results
+// arrive on the JS thread through the callback given to setResultCallback.
+class DetectorHostObject : public jsi::HostObject, public std::enable_shared_from_this<DetectorHostObject> {
+public:
+  DetectorHostObject(DETECTOR_CONFIG config, std::shared_ptr<react::CallInvoker> callInvoker);
+
+  ~DetectorHostObject() override;
+
+  jsi::Value get(jsi::Runtime &runtime, const jsi::PropNameID &name) override;
+  std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime &runtime) override;
+
+  jsi::Value detect(jsi::Runtime &runtime, const jsi::Value &frame);
+
+  jsi::Value detectAsync(jsi::Runtime &runtime, const jsi::Value &frame);
+
+  // null or undefined stops delivery.
+  void setResultCallback(jsi::Runtime &runtime, const jsi::Value &callback);
+
+  static void registerCreateDetector(jsi::Runtime &runtime, std::shared_ptr<react::CallInvoker> callInvoker);
+
+private:
+  // detect, detectAsync and setResultCallback, created afresh on every read: the detector is
+  // reachable from both the JS and the frame processor runtime, and may be destroyed on either
+  // thread, so it must not own Functions of any runtime.
+  jsi::Function createHostFunction(jsi::Runtime &runtime, const std::string &name);
+
+  // Calls fn(image, meta) with the frame as a locked YUV_IMAGE or, for TypedArrays, a cv::Mat view.
+  template<typename Fn>
+  void withImage(jsi::Runtime &runtime, const jsi::Value &frame, Fn &&fn);
+
+  // nullptr while the model is still loading; throws if loading failed.
+  std::shared_ptr<OnnxFrameProcessor> readyProcessor();
+
+  InferencePipeline &ensurePipeline(const std::shared_ptr<OnnxFrameProcessor> &model);
+
+  DETECTOR_CONFIG config;
+  std::shared_ptr<react::CallInvoker> callInvoker;
+  MODEL_KEY modelKey;
+  // Shared through ModelRegistry with any other user of the same model; set once loaded.
+  std::mutex processorMutex;
+  std::shared_ptr<OnnxFrameProcessor> processor;
+  std::shared_ptr<DetectionResultSink> resultSink;
+  // Per detector, not per processor: a shared processor can serve several unrelated streams.
+  std::mutex streamMutex;
+  std::unique_ptr<Tracker> tracker;
+  std::unique_ptr<MotionGate> motionGate;
+  std::mutex pipelineMutex;
+  // Declared last: its thread reads config, so it must stop first.
+  std::unique_ptr<InferencePipeline> pipeline;
+};
+
+#endif
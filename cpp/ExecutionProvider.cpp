@@ -0,0 +1,93 @@
+#include "ExecutionProvider.h"
+#include <algorithm>
+#include <unordered_map>
+
+#if __has_include("nnapi_provider_factory.h")
+#include "nnapi_provider_factory.h"
+#define DCSP_HAVE_NNAPI 1
+#endif
+
+
+const char *ExecutionProviderName(EXECUTION_PROVIDER provider) {
+    switch (provider) {
+        case EP_CPU:
+            return "cpu";
+        case EP_XNNPACK:
+            return "xnnpack";
+        case EP_NNAPI:
+            return "nnapi";
+        case EP_CUDA:
+            return "cuda";
+        case EP_AUTO:
+            return "auto";
+    }
+    return "unknown";
+}
+
+
+bool ParseExecutionProvider(const std::string &name, EXECUTION_PROVIDER &oProvider) {
+    for (EXECUTION_PROVIDER provider: {EP_CPU, EP_XNNPACK, EP_NNAPI, EP_CUDA, EP_AUTO}) {
+        if (name == ExecutionProviderName(provider)) {
+            oProvider = provider;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool IsProviderAvailable(EXECUTION_PROVIDER provider) {
+    const char *ortName = nullptr;
+    switch (provider) {
+        case EP_CPU:
+            return true;
+        case EP_XNNPACK:
+            ortName = "XnnpackExecutionProvider";
+            break;
+        case EP_NNAPI:
+#ifndef DCSP_HAVE_NNAPI
+            return false;
+#endif
+            ortName = "NnapiExecutionProvider";
+            break;
+        case EP_CUDA:
+            ortName = "CUDAExecutionProvider";
+            break;
+        case EP_AUTO:
+            return false;
+    }
+    std::vector<std::string> available = Ort::GetAvailableProviders();
+    return std::find(available.begin(), available.end(), ortName) != available.end();
+}
+
+
+char *AppendExecutionProvider(Ort::SessionOptions &sessionOption, EXECUTION_PROVIDER provider, int numThreads) {
+    switch (provider) {
+        case EP_CPU:
+            return RET_OK;
+        case EP_XNNPACK: {
+            std::unordered_map<std::string, std::string> xnnpackOptions;
+            xnnpackOptions["intra_op_num_threads"] = std::to_string(std::max(numThreads, 1));
+            sessionOption.AppendExecutionProvider("XNNPACK", xnnpackOptions);
+            return RET_OK;
+        }
+        case EP_NNAPI: {
+#ifdef DCSP_HAVE_NNAPI
+            // Never fall back to NNAPI's slow reference CPU implementation; ORT's CPU EP takes those nodes.
+            Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nnapi(sessionOption, NNAPI_FLAG_CPU_DISABLED));
+            return RET_OK;
+#else
+            return "[DCSP_ONNX]:This build has no NNAPI execution provider.";
+#endif
+        }
+        case EP_CUDA: {
+            OrtCUDAProviderOptions cudaOption;
+            cudaOption.device_id = 0;
+            sessionOption.AppendExecutionProvider_CUDA(cudaOption);
+            return RET_OK;
+        }
+        case EP_AUTO:
+            break;
+    }
+    return "[DCSP_ONNX]:EP_AUTO must be resolved before creating the session.";
+}
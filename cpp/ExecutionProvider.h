@@ -0,0 +1,41 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <string>
+#include "onnxruntime_cxx_api.h"
+
+
+enum EXECUTION_PROVIDER {
+    EP_CPU = 0,
+    // ORT's XNNPACK kernels; available on any ARM/x86 CPU build that includes them.
+    EP_XNNPACK = 1,
+    // Android NNAPI (GPU/DSP/NPU where the vendor driver supports the ops).
+    EP_NNAPI = 2,
+    EP_CUDA = 3,
+    // Benchmark every available provider on the model at load time and keep the fastest.
+    EP_AUTO = 4
+};
+
+
+// Each trial session is timed over this many runs (after two warm-up runs), median wins.
+constexpr int PROVIDER_TRIAL_RUNS = 5;
+
+
+// Every name ParseExecutionProvider accepts, for error messages.
+constexpr const char *EXECUTION_PROVIDER_NAMES = "\"cpu\", \"xnnpack\", \"nnapi\", \"cuda\" or \"auto\"";
+
+
+const char *ExecutionProviderName(EXECUTION_PROVIDER provider);
+
+// "cpu", "xnnpack", "nnapi", "cuda" or "auto".
+bool ParseExecutionProvider(const std::string &name, EXECUTION_PROVIDER &oProvider);
+
+// Whether this ORT build (and, for NNAPI, this binary) can run the provider.
+bool IsProviderAvailable(EXECUTION_PROVIDER provider);
+
+// Registers provider on sessionOption; EP_CPU needs nothing. numThreads sizes XNNPACK's own pool, the
+// session's intra-op pool should then be a single thread.
+char *AppendExecutionProvider(Ort::SessionOptions &sessionOption, EXECUTION_PROVIDER provider, int numThreads);
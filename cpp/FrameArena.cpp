@@ -0,0 +1,76 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+
+// Block sizes and alignments are kept to multiples of this so SIMD kernels can load any slice
+// with aligned moves.
+static constexpr size_t ARENA_BLOCK_ALIGN = 64;
+
+
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+FrameArena::FrameArena(size_t initialBytes) {
+    blocks.reserve(4);
+    AddBlock(initialBytes);
+}
+
+
+FrameArena::~FrameArena() {
+    for (const ARENA_BLOCK &block: blocks) {
+        ::operator delete(block.data, std::align_val_t(ARENA_BLOCK_ALIGN));
+    }
+}
+
+
+void FrameArena::AddBlock(size_t minBytes) {
+    size_t size = AlignUp(std::max<size_t>(minBytes, ARENA_BLOCK_ALIGN), ARENA_BLOCK_ALIGN);
+    auto *data = static_cast<uint8_t *>(::operator new(size, std::align_val_t(ARENA_BLOCK_ALIGN)));
+    blocks.push_back({data, size});
+    offset = 0;
+}
+
+
+void *FrameArena::Allocate(size_t bytes, size_t alignment) {
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    const ARENA_BLOCK &current = blocks.back();
+    size_t start = AlignUp(offset, alignment);
+    if (start + bytes > current.size) {
+        // Grow geometrically so a frame that keeps outgrowing the arena chains few blocks.
+        AddBlock(std::max(bytes + alignment, 2 * current.size));
+        start = 0;
+    }
+    used += start - offset + bytes;
+    offset = start + bytes;
+    return blocks.back().data + start;
+}
+
+
+void FrameArena::Reset() {
+    highWater = std::max(highWater, used);
+    if (blocks.size() > 1) {
+        size_t total = Capacity();
+        for (const ARENA_BLOCK &block: blocks) {
+            ::operator delete(block.data, std::align_val_t(ARENA_BLOCK_ALIGN));
+        }
+        blocks.clear();
+        AddBlock(total);
+    }
+    offset = 0;
+    used = 0;
+}
+
+
+size_t FrameArena::Capacity() const {
+    size_t total = 0;
+    for (const ARENA_BLOCK &block: blocks) {
+        total += block.size;
+    }
+    return total;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Bump allocator for per-frame scratch. Allocate() hands out aligned slices of a block and Reset()
+// releases all of them at once at the end of the frame. When a frame outgrows the current block
+// another one is chained on, and the next Reset() folds the chain into a single block of the
+// combined size, so after the first few frames every frame is served from one block without
+// touching the heap. Not thread-safe: one arena per processor / thread.
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialBytes = 64 * 1024);
+
+    ~FrameArena();
+
+    FrameArena(const FrameArena &) = delete;
+
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    void *Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T *AllocateArray(size_t count) {
+        return static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Invalidates everything handed out since the previous Reset.
+    void Reset();
+
+    // Bytes handed out since the last Reset, including alignment padding.
+    size_t Used() const { return used; }
+
+    // Largest Used() seen at any Reset.
+    size_t HighWater() const { return highWater; }
+
+    size_t Capacity() const;
+
+private:
+    typedef struct _ARENA_BLOCK {
+        uint8_t *data;
+        size_t size;
+    } ARENA_BLOCK;
+
+    void AddBlock(size_t minBytes);
+
+    std::vector<ARENA_BLOCK> blocks;
+    size_t offset = 0;
+    size_t used = 0;
+    size_t highWater = 0;
+};
+
+
+// Standard allocator over a FrameArena, for containers that live no longer than one frame.
+// deallocate() is a no-op; the memory comes back with the arena's Reset().
+template<typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(FrameArena &arena) : arena(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t count) { return arena->AllocateArray<T>(count); }
+
+    void deallocate(T *, size_t) {}
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+
+private:
+    template<typename U> friend
+    class ArenaAllocator;
+
+    FrameArena *arena;
+};
@@ -0,0 +1,455 @@
+#include "FrameCapture.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+
+static uint64_t AlignRecord(uint64_t bytes) {
+    return (bytes + 7) & ~static_cast<uint64_t>(7);
+}
+
+
+FrameRecorder::~FrameRecorder() {
+    Close();
+}
+
+
+char *FrameRecorder::Open(const std::string &path) {
+    Close();
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return "[DCSP_ONNX]:Cannot create capture file.";
+    }
+    CAPTURE_FILE_HEADER header = {};
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        Close();
+        return "[DCSP_ONNX]:Cannot write capture header.";
+    }
+    framesWritten = 0;
+    settingsWritten = false;
+    settingsMixed = false;
+    return RET_OK;
+}
+
+
+void FrameRecorder::Close() {
+    if (file != nullptr) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+
+char *FrameRecorder::WriteSettings(const CAPTURE_SETTINGS &settings) {
+    // Patched into the header in place; records keep being appended at the end.
+    bool ok = std::fseek(file, offsetof(CAPTURE_FILE_HEADER, settings), SEEK_SET) == 0 &&
+              std::fwrite(&settings, sizeof(settings), 1, file) == 1;
+    if (std::fseek(file, 0, SEEK_END) != 0 || !ok) {
+        return "[DCSP_ONNX]:Capture write failed.";
+    }
+    headerSettings = settings;
+    settingsWritten = true;
+    return RET_OK;
+}
+
+
+char *FrameRecorder::WriteRecord(CAPTURE_RECORD_HEADER &header, const std::vector<DCSP_RESULT> *detections,
+                                 const CAPTURE_SETTINGS *settings, const uint8_t *payload) {
+    if (file == nullptr) {
+        return "[DCSP_ONNX]:Capture file is not open.";
+    }
+    detectionScratch.clear();
+    if (detections != nullptr) {
+        for (const DCSP_RESULT &result: *detections) {
+            CAPTURE_DETECTION detection;
+            detection.classId = result.classId;
+            detection.confidence = result.confidence;
+            detection.x = result.box.x;
+            detection.y = result.box.y;
+            detection.width = result.box.width;
+            detection.height = result.box.height;
+            detectionScratch.push_back(detection);
+        }
+    }
+    header.detectionCount = static_cast<uint32_t>(detectionScratch.size());
+    static const uint8_t padding[8] = {};
+    size_t paddingBytes = AlignRecord(header.payloadBytes) - header.payloadBytes;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (detectionScratch.empty() ||
+               std::fwrite(detectionScratch.data(), sizeof(CAPTURE_DETECTION), detectionScratch.size(), file) ==
+               detectionScratch.size()) &&
+              std::fwrite(payload, 1, header.payloadBytes, file) == header.payloadBytes &&
+              std::fwrite(padding, 1, paddingBytes, file) == paddingBytes;
+    if (!ok) {
+        return "[DCSP_ONNX]:Capture write failed.";
+    }
+    framesWritten++;
+    if (detections == nullptr || settings == nullptr) {
+        return RET_OK;
+    }
+    if (!settingsWritten) {
+        return WriteSettings(*settings);
+    }
+    if (!settingsMixed && std::memcmp(settings, &headerSettings, sizeof(headerSettings)) != 0) {
+        // The header holds one set; replays decode every frame with the first one.
+        DCSP_LOGW("DCSP_ONNX", "Capture frames use different thresholds or input sizes; replay uses the first.");
+        settingsMixed = true;
+    }
+    return RET_OK;
+}
+
+
+char *FrameRecorder::Write(const cv::Mat &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                           const CAPTURE_SETTINGS *settings) {
+    if (iImg.depth() != CV_8U || (iImg.channels() != 3 && iImg.channels() != 4)) {
+        return "[DCSP_ONNX]:Only 8-bit 3- and 4-channel frames can be captured.";
+    }
+    CAPTURE_RECORD_HEADER header;
+    header.format = iImg.channels() == 3 ? CAPTURE_BGR8 : CAPTURE_BGRA8;
+    header.width = iImg.cols;
+    header.height = iImg.rows;
+    header.stride = iImg.cols * iImg.channels();
+    header.orientation = meta.orientation;
+    header.timestampNs = meta.timestampNs;
+    header.payloadBytes = static_cast<uint64_t>(header.stride) * iImg.rows;
+    if (iImg.isContinuous()) {
+        return WriteRecord(header, detections, settings, iImg.data);
+    }
+    scratch.resize(header.payloadBytes);
+    for (int r = 0; r < iImg.rows; r++) {
+        std::memcpy(scratch.data() + static_cast<size_t>(r) * header.stride, iImg.ptr(r), header.stride);
+    }
+    return WriteRecord(header, detections, settings, scratch.data());
+}
+
+
+char *FrameRecorder::Write(const YUV_IMAGE &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                           const CAPTURE_SETTINGS *settings) {
+    if (iImg.y == nullptr || iImg.u == nullptr || iImg.v == nullptr || iImg.width <= 0 || iImg.height <= 0) {
+        return "[DCSP_ONNX]:Invalid YUV frame.";
+    }
+    // Even luma stride so the chroma planes are exactly stride / 2 wide, as WrapI420 expects.
+    int stride = (iImg.width + 1) & ~1;
+    int chromaStride = stride / 2;
+    int chromaWidth = (iImg.width + 1) / 2;
+    int chromaHeight = (iImg.height + 1) / 2;
+    size_t lumaBytes = static_cast<size_t>(stride) * iImg.height;
+    size_t chromaBytes = static_cast<size_t>(chromaStride) * chromaHeight;
+    scratch.assign(lumaBytes + 2 * chromaBytes, 0);
+
+    for (int r = 0; r < iImg.height; r++) {
+        std::memcpy(scratch.data() + static_cast<size_t>(r) * stride,
+                    iImg.y + static_cast<size_t>(r) * iImg.yRowStride, iImg.width);
+    }
+    uint8_t *uPlane = scratch.data() + lumaBytes;
+    uint8_t *vPlane = uPlane + chromaBytes;
+    for (int r = 0; r < chromaHeight; r++) {
+        const uint8_t *uRow = iImg.u + static_cast<size_t>(r) * iImg.uvRowStride;
+        const uint8_t *vRow = iImg.v + static_cast<size_t>(r) * iImg.uvRowStride;
+        for (int c = 0; c < chromaWidth; c++) {
+            uPlane[static_cast<size_t>(r) * chromaStride + c] = uRow[c * iImg.uvPixelStride];
+            vPlane[static_cast<size_t>(r) * chromaStride + c] = vRow[c * iImg.uvPixelStride];
+        }
+    }
+
+    CAPTURE_RECORD_HEADER header;
+    header.format = CAPTURE_I420;
+    header.width = iImg.width;
+    header.height = iImg.height;
+    header.stride = stride;
+    header.orientation = meta.orientation;
+    header.timestampNs = meta.timestampNs;
+    header.payloadBytes = scratch.size();
+    return WriteRecord(header, detections, settings, scratch.data());
+}
+
+
+// Whether the header describes pixels that fit its own payload, so the Mat and YUV views built
+// from it never read past the record.
+static bool ValidRecord(const CAPTURE_RECORD_HEADER &header) {
+    if (header.format > CAPTURE_I420 || header.width <= 0 || header.height <= 0 || header.stride <= 0) {
+        return false;
+    }
+    uint64_t width = static_cast<uint64_t>(header.width);
+    uint64_t height = static_cast<uint64_t>(header.height);
+    uint64_t stride = static_cast<uint64_t>(header.stride);
+    uint64_t requiredBytes = 0;
+    if (header.format == CAPTURE_I420) {
+        // WrapI420 reads (width + 1) / 2 chroma bytes per stride / 2 row.
+        if (stride / 2 < (width + 1) / 2) {
+            return false;
+        }
+        requiredBytes = stride * height + 2 * (stride / 2) * ((height + 1) / 2);
+    } else {
+        uint64_t channels = header.format == CAPTURE_BGRA8 ? 4 : 3;
+        if (stride < width * channels) {
+            return false;
+        }
+        requiredBytes = stride * height;
+    }
+    return header.payloadBytes >= requiredBytes;
+}
+
+
+char *FrameCaptureReader::Open(const std::string &path) {
+    frames.clear();
+    settings = CAPTURE_SETTINGS();
+    char *Ret = file.Open(path, true);
+    if (Ret != RET_OK) {
+        return Ret;
+    }
+    const uint8_t *base = static_cast<const uint8_t *>(file.Data());
+    size_t size = file.Size();
+    CAPTURE_FILE_HEADER fileHeader = {};
+    if (size < CAPTURE_FILE_HEADER_V1_BYTES) {
+        return "[DCSP_ONNX]:Capture file is truncated.";
+    }
+    std::memcpy(&fileHeader, base, CAPTURE_FILE_HEADER_V1_BYTES);
+    if (std::memcmp(fileHeader.magic, CAPTURE_MAGIC, sizeof(fileHeader.magic)) != 0 ||
+        fileHeader.version < 1 || fileHeader.version > CAPTURE_VERSION) {
+        return "[DCSP_ONNX]:Not a capture file or unsupported capture version.";
+    }
+    size_t offset = fileHeader.version == 1 ? CAPTURE_FILE_HEADER_V1_BYTES : sizeof(fileHeader);
+    if (size < offset) {
+        return "[DCSP_ONNX]:Capture file is truncated.";
+    }
+    std::memcpy(&fileHeader, base, offset);
+    settings = fileHeader.settings;
+
+    while (offset + sizeof(CAPTURE_RECORD_HEADER) <= size) {
+        CAPTURE_RECORD_HEADER header;
+        std::memcpy(&header, base + offset, sizeof(header));
+        // 64-bit throughout: detectionCount * sizeof(CAPTURE_DETECTION) cannot overflow, and the
+        // payload is compared with what is left before it is rounded up.
+        uint64_t remaining = size - offset - sizeof(header);
+        uint64_t detectionBytes = static_cast<uint64_t>(header.detectionCount) * sizeof(CAPTURE_DETECTION);
+        if (detectionBytes > remaining || header.payloadBytes > remaining - detectionBytes ||
+            AlignRecord(header.payloadBytes) > remaining - detectionBytes) {
+            // A partially written tail record; everything before it is intact.
+            break;
+        }
+        if (!ValidRecord(header)) {
+            frames.clear();
+            return "[DCSP_ONNX]:Capture record has an invalid format, size or stride.";
+        }
+        size_t recordBytes = sizeof(header) + detectionBytes + AlignRecord(header.payloadBytes);
+        CAPTURE_FRAME frame;
+        frame.format = static_cast<CAPTURE_PIXEL_FORMAT>(header.format);
+        frame.width = header.width;
+        frame.height = header.height;
+        frame.stride = header.stride;
+        frame.orientation = header.orientation;
+        frame.timestampNs = header.timestampNs;
+        frame.detections = reinterpret_cast<const CAPTURE_DETECTION *>(base + offset + sizeof(header));
+        frame.detectionCount = static_cast<int>(header.detectionCount);
+        frame.data = base + offset + sizeof(header) + static_cast<size_t>(detectionBytes);
+        frame.dataBytes = header.payloadBytes;
+        frames.push_back(frame);
+        offset += recordBytes;
+    }
+    return RET_OK;
+}
+
+
+char *ReadCaptureSettings(const std::string &path, CAPTURE_SETTINGS &oSettings) {
+    oSettings = CAPTURE_SETTINGS();
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return "[DCSP_ONNX]:Cannot open capture file.";
+    }
+    CAPTURE_FILE_HEADER header = {};
+    size_t read = std::fread(&header, 1, sizeof(header), file);
+    std::fclose(file);
+    if (read < CAPTURE_FILE_HEADER_V1_BYTES || std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version < 1 || header.version > CAPTURE_VERSION) {
+        return "[DCSP_ONNX]:Not a capture file or unsupported capture version.";
+    }
+    if (header.version > 1 && read == sizeof(header)) {
+        oSettings = header.settings;
+    }
+    return RET_OK;
+}
+
+
+cv::Mat CaptureFrameMat(const CAPTURE_FRAME &frame) {
+    int type = frame.format == CAPTURE_BGRA8 ? CV_8UC4 : CV_8UC3;
+    // Read-only in practice: the mapping is private, and RunSession never writes its input.
+    return cv::Mat(frame.height, frame.width, type, const_cast<uint8_t *>(frame.data), frame.stride);
+}
+
+
+YUV_IMAGE CaptureFrameYuv(const CAPTURE_FRAME &frame) {
+    return WrapI420(frame.data, frame.width, frame.height, frame.stride);
+}
+
+
+static std::mutex gCaptureMutex;
+static FrameRecorder gRecorder;
+static size_t gCaptureLimit = 0;
+
+
+char *StartFrameCapture(const std::string &path, size_t maxFrames) {
+    std::lock_guard<std::mutex> lock(gCaptureMutex);
+    char *Ret = gRecorder.Open(path);
+    if (Ret != RET_OK) {
+        return Ret;
+    }
+    gCaptureLimit = maxFrames;
+    FrameCaptureFlag().store(true, std::memory_order_relaxed);
+    DCSP_LOGI("DCSP_ONNX", "Recording frames to %s", path.c_str());
+    return RET_OK;
+}
+
+
+size_t StopFrameCapture() {
+    std::lock_guard<std::mutex> lock(gCaptureMutex);
+    FrameCaptureFlag().store(false, std::memory_order_relaxed);
+    size_t written = gRecorder.FramesWritten();
+    gRecorder.Close();
+    return written;
+}
+
+
+template<typename Image>
+static void CaptureImage(const Image &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                         const CAPTURE_SETTINGS *settings) {
+    std::lock_guard<std::mutex> lock(gCaptureMutex);
+    if (!FrameCaptureActive()) {
+        return;
+    }
+    char *Ret = gRecorder.Write(iImg, meta, detections, settings);
+    bool full = gCaptureLimit > 0 && gRecorder.FramesWritten() >= gCaptureLimit;
+    if (Ret != RET_OK || full) {
+        if (Ret != RET_OK) {
+            DCSP_LOGE("DCSP_ONNX", "%s Recording stopped.", Ret);
+        }
+        FrameCaptureFlag().store(false, std::memory_order_relaxed);
+        gRecorder.Close();
+    }
+}
+
+
+void CaptureFrame(const cv::Mat &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                  const CAPTURE_SETTINGS *settings) {
+    CaptureImage(iImg, meta, detections, settings);
+}
+
+
+void CaptureFrame(const YUV_IMAGE &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                  const CAPTURE_SETTINGS *settings) {
+    CaptureImage(iImg, meta, detections, settings);
+}
+
+
+CAPTURE_META CaptureMetaNow() {
+    CAPTURE_META meta;
+    meta.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    return meta;
+}
+
+
+CAPTURE_SETTINGS MakeCaptureSettings(float confidenceThreshold, float nmsThreshold, int inputWidth, int inputHeight,
+                                     bool classAware) {
+    CAPTURE_SETTINGS settings = {};
+    settings.confidenceThreshold = confidenceThreshold;
+    settings.nmsThreshold = nmsThreshold;
+    settings.inputWidth = inputWidth;
+    settings.inputHeight = inputHeight;
+    settings.classAware = classAware ? 1 : 0;
+    return settings;
+}
+
+
+static float RectIou(const cv::Rect &a, const CAPTURE_DETECTION &b) {
+    cv::Rect other(b.x, b.y, b.width, b.height);
+    float inter = static_cast<float>((a & other).area());
+    float unionArea = static_cast<float>(a.area() + other.area()) - inter;
+    return unionArea > 0.f ? inter / unionArea : 0.f;
+}
+
+
+char *ReplayCapture(const FrameCaptureReader &reader, const REPLAY_PARAM &param, const REPLAY_RUN_FN &run,
+                    REPLAY_STATS &oStats) {
+    oStats = REPLAY_STATS();
+    std::vector<double> latencies;
+    latencies.reserve(reader.Count());
+    std::vector<DCSP_RESULT> results;
+    std::vector<bool> used;
+    double iouSum = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    int64_t firstTimestamp = reader.Count() > 0 ? reader.Frame(0).timestampNs : 0;
+    for (size_t i = 0; i < reader.Count(); i++) {
+        const CAPTURE_FRAME &frame = reader.Frame(i);
+        if (param.realTime) {
+            std::this_thread::sleep_until(start + std::chrono::nanoseconds(frame.timestampNs - firstTimestamp));
+        }
+        results.clear();
+        auto frameStart = std::chrono::steady_clock::now();
+        char *Ret = run(frame, results);
+        latencies.push_back(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - frameStart).count());
+        if (Ret != RET_OK) {
+            return Ret;
+        }
+
+        oStats.replayDetections += results.size();
+        if (frame.detectionCount == 0) {
+            continue;
+        }
+        // Greedy parity: each reference box takes the best unused replayed box of its class.
+        oStats.referenceDetections += frame.detectionCount;
+        oStats.comparedDetections += results.size();
+        used.assign(results.size(), false);
+        for (int d = 0; d < frame.detectionCount; d++) {
+            const CAPTURE_DETECTION &reference = frame.detections[d];
+            int best = -1;
+            float bestIou = param.parityIou;
+            for (size_t r = 0; r < results.size(); r++) {
+                if (used[r] || results[r].classId != reference.classId) {
+                    continue;
+                }
+                float iou = RectIou(results[r].box, reference);
+                if (iou >= bestIou) {
+                    bestIou = iou;
+                    best = static_cast<int>(r);
+                }
+            }
+            if (best >= 0) {
+                used[best] = true;
+                oStats.matchedDetections++;
+                iouSum += bestIou;
+            }
+        }
+    }
+    oStats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    oStats.frames = reader.Count();
+    if (oStats.frames > 0 && oStats.elapsedMs > 0.0) {
+        oStats.fps = oStats.frames * 1000.0 / oStats.elapsedMs;
+    }
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        oStats.latencyP50Ms = latencies[latencies.size() / 2];
+        oStats.latencyP95Ms = latencies[std::min(latencies.size() - 1, latencies.size() * 95 / 100)];
+        oStats.latencyMaxMs = latencies.back();
+    }
+    if (oStats.matchedDetections > 0) {
+        oStats.meanMatchedIou = iouSum / oStats.matchedDetections;
+    }
+    if (oStats.referenceDetections > 0) {
+        oStats.parity = static_cast<double>(oStats.matchedDetections) / oStats.referenceDetections;
+    }
+    if (oStats.comparedDetections > 0) {
+        oStats.precision = static_cast<double>(oStats.matchedDetections) / oStats.comparedDetections;
+    }
+    if (oStats.parity < param.minParity) {
+        return "[DCSP_ONNX]:Replayed detections do not match the recorded ones.";
+    }
+    return RET_OK;
+}
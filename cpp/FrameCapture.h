@@ -0,0 +1,246 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Inference.h"
+#include "MappedFile.h"
+
+
+// Capture file layout (native byte order, every record 8-byte aligned):
+//
+//   CAPTURE_FILE_HEADER
+//   repeated: CAPTURE_RECORD_HEADER, detectionCount x CAPTURE_DETECTION, payloadBytes of pixels
+//
+// Records are appended as frames arrive, so a capture cut short by a crash is still readable up to
+// its last complete record. Version 1 headers end before the settings, which then read as unknown.
+constexpr char CAPTURE_MAGIC[8] = {'D', 'C', 'S', 'P', 'C', 'A', 'P', '1'};
+constexpr uint32_t CAPTURE_VERSION = 2;
+
+
+enum CAPTURE_PIXEL_FORMAT {
+    // Interleaved 8-bit pixels in the channel order the letterbox kernel reads (TypedArray input).
+    CAPTURE_BGR8 = 0,
+    CAPTURE_BGRA8 = 1,
+    // Planar 4:2:0; camera YUV_420_888 frames are repacked to this whatever their plane layout.
+    CAPTURE_I420 = 2
+};
+
+
+// How the reference detections were produced, so a replay can decode the same way. Written with
+// the first record that carries reference output; all zero (unknown) before that and in version 1
+// files.
+typedef struct _CAPTURE_SETTINGS {
+    float confidenceThreshold;
+    float nmsThreshold;
+    int32_t inputWidth;
+    int32_t inputHeight;
+    uint32_t classAware;
+    uint32_t reserved;
+} CAPTURE_SETTINGS;
+
+
+typedef struct _CAPTURE_FILE_HEADER {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    CAPTURE_SETTINGS settings;
+} CAPTURE_FILE_HEADER;
+
+constexpr size_t CAPTURE_FILE_HEADER_V1_BYTES = 16;
+
+
+typedef struct _CAPTURE_RECORD_HEADER {
+    uint32_t format;
+    int32_t width;
+    int32_t height;
+    // Bytes per row of the first plane (I420 chroma planes use stride / 2).
+    int32_t stride;
+    // Clockwise rotation of the sensor image relative to the UI, in degrees.
+    int32_t orientation;
+    uint32_t detectionCount;
+    int64_t timestampNs;
+    uint64_t payloadBytes;
+} CAPTURE_RECORD_HEADER;
+
+
+typedef struct _CAPTURE_DETECTION {
+    int32_t classId;
+    float confidence;
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+} CAPTURE_DETECTION;
+
+
+// Per-frame metadata known only to the binding layer (VisionCamera's timestamp and orientation).
+typedef struct _CAPTURE_META {
+    int64_t timestampNs = 0;
+    int orientation = 0;
+} CAPTURE_META;
+
+
+// One record of an open capture; pointers reference the reader's mapping.
+typedef struct _CAPTURE_FRAME {
+    CAPTURE_PIXEL_FORMAT format;
+    int width;
+    int height;
+    int stride;
+    int orientation;
+    int64_t timestampNs;
+    const uint8_t *data;
+    size_t dataBytes;
+    const CAPTURE_DETECTION *detections;
+    int detectionCount;
+} CAPTURE_FRAME;
+
+
+class FrameRecorder {
+public:
+    FrameRecorder() = default;
+
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder &) = delete;
+
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    char *Open(const std::string &path);
+
+    // 3- or 4-channel 8-bit images; detections may be nullptr when there is no reference output.
+    // settings describe how detections were produced and go into the file header once.
+    char *Write(const cv::Mat &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                const CAPTURE_SETTINGS *settings = nullptr);
+
+    char *Write(const YUV_IMAGE &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                const CAPTURE_SETTINGS *settings = nullptr);
+
+    void Close();
+
+    size_t FramesWritten() const { return framesWritten; }
+
+private:
+    char *WriteRecord(CAPTURE_RECORD_HEADER &header, const std::vector<DCSP_RESULT> *detections,
+                      const CAPTURE_SETTINGS *settings, const uint8_t *payload);
+
+    char *WriteSettings(const CAPTURE_SETTINGS &settings);
+
+    FILE *file = nullptr;
+    bool settingsWritten = false;
+    bool settingsMixed = false;
+    CAPTURE_SETTINGS headerSettings = {};
+    std::vector<uint8_t> scratch;
+    std::vector<CAPTURE_DETECTION> detectionScratch;
+    size_t framesWritten = 0;
+};
+
+
+// Memory-maps a capture and indexes its records; frames are views into the mapping.
+class FrameCaptureReader {
+public:
+    char *Open(const std::string &path);
+
+    size_t Count() const { return frames.size(); }
+
+    const CAPTURE_FRAME &Frame(size_t index) const { return frames[index]; }
+
+    // Zero fields are unknown (version 1 captures, or no reference detections).
+    const CAPTURE_SETTINGS &Settings() const { return settings; }
+
+private:
+    MappedFile file;
+    std::vector<CAPTURE_FRAME> frames;
+    CAPTURE_SETTINGS settings = {};
+};
+
+
+// Reads only the header of the capture at path, for callers that configure a model before replaying.
+char *ReadCaptureSettings(const std::string &path, CAPTURE_SETTINGS &oSettings);
+
+
+// Views over a record's pixels, for the RunSession overload matching its format.
+cv::Mat CaptureFrameMat(const CAPTURE_FRAME &frame);
+
+YUV_IMAGE CaptureFrameYuv(const CAPTURE_FRAME &frame);
+
+
+// Process-wide recorder behind the binding layer's hooks. While no capture is running
+// FrameCaptureActive() is a single relaxed load.
+char *StartFrameCapture(const std::string &path, size_t maxFrames);
+
+// Returns the number of frames written.
+size_t StopFrameCapture();
+
+inline std::atomic<bool> &FrameCaptureFlag() {
+    static std::atomic<bool> active{false};
+    return active;
+}
+
+inline bool FrameCaptureActive() {
+    return FrameCaptureFlag().load(std::memory_order_relaxed);
+}
+
+// Appends a frame to the running capture (no-op when none is). Writes happen on the calling
+// thread, so recording a camera stream costs a frame copy and a buffered write per frame.
+void CaptureFrame(const cv::Mat &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                  const CAPTURE_SETTINGS *settings = nullptr);
+
+void CaptureFrame(const YUV_IMAGE &iImg, const CAPTURE_META &meta, const std::vector<DCSP_RESULT> *detections,
+                  const CAPTURE_SETTINGS *settings = nullptr);
+
+// Metadata for frames without a camera timestamp (TypedArray input): steady clock, no rotation.
+CAPTURE_META CaptureMetaNow();
+
+// What a binding layer hands to CaptureFrame alongside its detections.
+CAPTURE_SETTINGS MakeCaptureSettings(float confidenceThreshold, float nmsThreshold, int inputWidth, int inputHeight,
+                                     bool classAware);
+
+
+typedef struct _REPLAY_PARAM {
+    // Sleep between frames to reproduce the recorded timestamps instead of running flat out.
+    bool realTime = false;
+    // Replay and reference boxes of the same class match at or above this IoU.
+    float parityIou = 0.5f;
+    // Share of reference detections that must be matched (recall; see REPLAY_STATS::precision for
+    // extra detections); below it ReplayCapture fails after filling in the stats. 0 only reports parity.
+    float minParity = 0.f;
+} REPLAY_PARAM;
+
+
+typedef struct _REPLAY_STATS {
+    size_t frames = 0;
+    double elapsedMs = 0.0;
+    double fps = 0.0;
+    double latencyP50Ms = 0.0;
+    double latencyP95Ms = 0.0;
+    double latencyMaxMs = 0.0;
+    // Detection parity over frames that carry reference detections. A frame recorded with no
+    // detections cannot be told from one recorded without reference output, so replayed
+    // detections on such frames are counted in replayDetections only.
+    size_t referenceDetections = 0;
+    size_t replayDetections = 0;
+    size_t comparedDetections = 0;
+    size_t matchedDetections = 0;
+    double meanMatchedIou = 0.0;
+    // Recall: matchedDetections / referenceDetections, 1 when the capture has no reference detections.
+    double parity = 1.0;
+    // matchedDetections / comparedDetections, the replayed detections on frames with references.
+    double precision = 1.0;
+} REPLAY_STATS;
+
+
+// Runs one recorded frame through a model; oResult receives its detections.
+typedef std::function<char *(const CAPTURE_FRAME &frame, std::vector<DCSP_RESULT> &oResult)> REPLAY_RUN_FN;
+
+// Feeds every frame of reader to run in order and compares the output with the recorded detections.
+// Returns the first error of run, or an error when the parity is below param.minParity.
+char *ReplayCapture(const FrameCaptureReader &reader, const REPLAY_PARAM &param, const REPLAY_RUN_FN &run,
+                    REPLAY_STATS &oStats);
@@ -1,7 +1,15 @@
 #include "Inference.h"
+#include "AllocationCounter.h"
 #include <regex>
-
-#define benchmark
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <atomic>
+#ifndef _WIN32
+#include <unistd.h>
+#endif // _WIN32
 
 DCSP_CORE::DCSP_CORE() {
 
@@ -9,6 +17,11 @@ DCSP_CORE::DCSP_CORE() {
 
 
 DCSP_CORE::~DCSP_CORE() {
+    // Bound values reference session state, release them before the session itself.
+    ioBinding = Ort::IoBinding{nullptr};
+    inputValues.clear();
+    transientInput = Ort::Value{nullptr};
+    outputValue = Ort::Value{nullptr};
     delete session;
 }
 
@@ -21,33 +34,104 @@ namespace Ort
 #endif
 
 
-template<typename T>
-char *BlobFromImage(cv::Mat &iImg, T &iBlob) {
-    int channels = iImg.channels();
-    int imgHeight = iImg.rows;
-    int imgWidth = iImg.cols;
+static void ConfigureSessionOptions(Ort::SessionOptions &sessionOption, const DCSP_INIT_PARAM &iParams,
+                                    EXECUTION_PROVIDER provider) {
+    sessionOption.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    sessionOption.SetLogSeverityLevel(iParams.LogSeverityLevel);
+    if (provider == EP_XNNPACK) {
+        // XNNPACK gets the thread budget for its own pool (AppendExecutionProvider). The nodes it
+        // leaves to ORT run on the calling thread, so the two pools never compete for the cores.
+        sessionOption.SetIntraOpNumThreads(1);
+        sessionOption.AddConfigEntry("session.intra_op.allow_spinning", "0");
+    } else if (iParams.UseGlobalThreadPools) {
+        sessionOption.DisablePerSessionThreads();
+    } else {
+        sessionOption.SetIntraOpNumThreads(iParams.IntraOpNumThreads);
+        sessionOption.AddConfigEntry("session.intra_op.allow_spinning", iParams.AllowSpinning ? "1" : "0");
+        sessionOption.AddConfigEntry("session.inter_op.allow_spinning", iParams.AllowSpinning ? "1" : "0");
+        if (!iParams.IntraOpAffinity.empty()) {
+            sessionOption.AddConfigEntry("session.intra_op_thread_affinities", iParams.IntraOpAffinity.c_str());
+        }
+    }
+    if (iParams.UseTensorPool && OrtEnvironment::Instance().TensorPoolRegistered()) {
+        sessionOption.AddConfigEntry("session.use_env_allocators", "1");
+    }
+}
 
-    for (int c = 0; c < channels; c++) {
-        for (int h = 0; h < imgHeight; h++) {
-            for (int w = 0; w < imgWidth; w++) {
-                iBlob[c * imgWidth * imgHeight + h * imgWidth + w] = typename std::remove_pointer<T>::type(
-                        (iImg.at<cv::Vec3b>(h, w)[c]) / 255.0f);
-            }
+
+// Median latency of PROVIDER_TRIAL_RUNS runs on a constant FP32 input, after two warm-up runs
+// that absorb kernel compilation and first-touch allocations.
+static double TimeTrialSession(Ort::Session &trial, const std::vector<int> &imgSize) {
+    Ort::AllocatorWithDefaultOptions allocator;
+    Ort::AllocatedStringPtr inputName = trial.GetInputNameAllocated(0, allocator);
+    std::vector<Ort::AllocatedStringPtr> outputNames;
+    std::vector<const char *> outputNamePtrs;
+    for (size_t i = 0; i < trial.GetOutputCount(); i++) {
+        outputNames.push_back(trial.GetOutputNameAllocated(i, allocator));
+        outputNamePtrs.push_back(outputNames.back().get());
+    }
+    const char *inputNamePtr = inputName.get();
+    std::vector<int64_t> dims = {1, 3, imgSize.at(0), imgSize.at(1)};
+    std::vector<float> input(3 * static_cast<size_t>(imgSize.at(0)) * imgSize.at(1), 114.f / 255.f);
+    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+            Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU), input.data(), input.size(),
+            dims.data(), dims.size());
+
+    std::vector<double> timings;
+    for (int run = 0; run < PROVIDER_TRIAL_RUNS + 2; run++) {
+        auto start = std::chrono::steady_clock::now();
+        trial.Run(Ort::RunOptions{nullptr}, &inputNamePtr, &inputTensor, 1, outputNamePtrs.data(),
+                  outputNamePtrs.size());
+        if (run >= 2) {
+            timings.push_back(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count());
         }
     }
-    return RET_OK;
+    std::nth_element(timings.begin(), timings.begin() + timings.size() / 2, timings.end());
+    return timings[timings.size() / 2];
 }
 
 
-char *PostProcess(cv::Mat &iImg, std::vector<int> iImgSize, cv::Mat &oImg) {
-    cv::Mat img = iImg.clone();
-    cv::resize(iImg, oImg, cv::Size(iImgSize.at(0), iImgSize.at(1)));
-    if (img.channels() == 1) {
-        cv::cvtColor(oImg, oImg, cv::COLOR_GRAY2BGR);
+EXECUTION_PROVIDER DCSP_CORE::SelectProvider(const DCSP_INIT_PARAM &iParams) {
+    EXECUTION_PROVIDER best = EP_CPU;
+    double bestMs = std::numeric_limits<double>::infinity();
+    for (EXECUTION_PROVIDER candidate: {EP_CPU, EP_XNNPACK, EP_NNAPI}) {
+        if (!IsProviderAvailable(candidate)) {
+            continue;
+        }
+        try {
+            Ort::SessionOptions trialOption;
+            ConfigureSessionOptions(trialOption, iParams, candidate);
+            if (AppendExecutionProvider(trialOption, candidate, iParams.IntraOpNumThreads) != RET_OK) {
+                continue;
+            }
+            // Not in the shared container: the losers' prepacked weights would otherwise stay for the
+            // life of the process.
+            std::unique_ptr<Ort::Session> trial(OpenSession(iParams.ModelPath, trialOption, false, false));
+            double medianMs = TimeTrialSession(*trial, iParams.imgSize);
+            DCSP_LOGI("DCSP_ONNX", "Provider %s runs in %.2f ms", ExecutionProviderName(candidate), medianMs);
+            if (medianMs < bestMs) {
+                bestMs = medianMs;
+                best = candidate;
+            }
+        } catch (const Ort::Exception &e) {
+            // A provider that rejects the model or device simply drops out of the race.
+            DCSP_LOGW("DCSP_ONNX", "Provider %s skipped: %s", ExecutionProviderName(candidate), e.what());
+        }
     }
-    cv::cvtColor(oImg, oImg, cv::COLOR_BGR2RGB);
-    return RET_OK;
+    return best;
+}
+
+
+#ifndef _WIN32
+// Temporary name the optimized graph is written under before it is renamed over cachedPath. It is
+// unique per process and per load so concurrent loads of the same model never share a file.
+static std::string PendingCachePath(const std::string &cachedPath) {
+    static std::atomic<unsigned> loadCounter{0};
+    return cachedPath + "." + std::to_string(static_cast<long>(getpid())) + "." +
+           std::to_string(loadCounter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
 }
+#endif // _WIN32
 
 
 char *DCSP_CORE::CreateSession(DCSP_INIT_PARAM &iParams) {
@@ -56,7 +140,7 @@ char *DCSP_CORE::CreateSession(DCSP_INIT_PARAM &iParams) {
     bool result = std::regex_search(iParams.ModelPath, pattern);
     if (result) {
         Ret = "[DCSP_ONNX]:Model path error.Change your model path without chinese characters.";
-        std::cout << Ret << std::endl;
+        DCSP_LOGE("DCSP_ONNX", "%s", Ret);
         return Ret;
     }
     try {
@@ -64,29 +148,81 @@ char *DCSP_CORE::CreateSession(DCSP_INIT_PARAM &iParams) {
         iouThreshold = iParams.iouThreshold;
         imgSize = iParams.imgSize;
         modelType = iParams.ModelType;
-        env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "Yolo");
+        nmsParam.topK = iParams.NmsTopK;
+        nmsParam.maxDetections = iParams.MaxDetections;
+        nmsParam.classAware = iParams.ClassAwareNms;
+        globalThreadPools = iParams.UseGlobalThreadPools;
+        mapModelFile = iParams.MapModelFile;
+        provider = iParams.CudaEnable ? EP_CUDA : iParams.Provider;
+        if (provider == EP_AUTO) {
+            provider = modelType < 4 ? SelectProvider(iParams) : EP_CPU;
+        }
+        cudaEnable = provider == EP_CUDA;
         Ort::SessionOptions sessionOption;
-        if (iParams.CudaEnable) {
-            cudaEnable = iParams.CudaEnable;
-            OrtCUDAProviderOptions cudaOption;
-            cudaOption.device_id = 0;
-            sessionOption.AppendExecutionProvider_CUDA(cudaOption);
+        ConfigureSessionOptions(sessionOption, iParams, provider);
+        char *providerError = AppendExecutionProvider(sessionOption, provider, iParams.IntraOpNumThreads);
+        if (providerError != RET_OK) {
+            DCSP_LOGE("DCSP_ONNX", "%s", providerError);
+            return providerError;
         }
-        sessionOption.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        sessionOption.SetIntraOpNumThreads(iParams.IntraOpNumThreads);
-        sessionOption.SetLogSeverityLevel(iParams.LogSeverityLevel);
 
-#ifdef _WIN32
-        int ModelPathSize = MultiByteToWideChar(CP_UTF8, 0, iParams.ModelPath.c_str(), static_cast<int>(iParams.ModelPath.length()), nullptr, 0);
-        wchar_t* wide_cstr = new wchar_t[ModelPathSize + 1];
-        MultiByteToWideChar(CP_UTF8, 0, iParams.ModelPath.c_str(), static_cast<int>(iParams.ModelPath.length()), wide_cstr, ModelPathSize);
-        wide_cstr[ModelPathSize] = L'\0';
-        const wchar_t* modelPath = wide_cstr;
-#else
-        const char *modelPath = iParams.ModelPath.c_str();
+        // The optimized graph is serialized once per (model bytes, ORT version, options) and later
+        // loads skip graph optimization. Execution providers that compile nodes cannot be
+        // serialized, so the cache is plain CPU only.
+        std::string cachedModelPath;
+        sessionFromCache = false;
+#ifndef _WIN32
+        uint64_t modelHash = 0;
+        if (!iParams.CacheDir.empty() && provider == EP_CPU &&
+            HashFile(iParams.ModelPath, modelHash) == RET_OK && EnsureDirectory(iParams.CacheDir)) {
+            cachedModelPath = ModelCachePath(iParams.CacheDir, modelHash, "opt=all;ep=cpu");
+            sessionFromCache = FileExists(cachedModelPath);
+        }
 #endif // _WIN32
 
-        session = new Ort::Session(env, modelPath, sessionOption);
+        auto createStart = std::chrono::steady_clock::now();
+        if (sessionFromCache) {
+            Ort::SessionOptions cachedOption = sessionOption.Clone();
+            cachedOption.AddConfigEntry("session.load_model_format", "ORT");
+            cachedOption.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+            try {
+                session = OpenSession(cachedModelPath, cachedOption, true);
+            } catch (const Ort::Exception &e) {
+                // Corrupt or incompatible artifact: rebuild it from the original model.
+                DCSP_LOGW("DCSP_ONNX", "Discarding model cache %s: %s", cachedModelPath.c_str(), e.what());
+                std::remove(cachedModelPath.c_str());
+                sessionFromCache = false;
+            }
+        }
+        if (!sessionFromCache) {
+            std::string pendingPath;
+#ifndef _WIN32
+            if (!cachedModelPath.empty()) {
+                pendingPath = PendingCachePath(cachedModelPath);
+                sessionOption.AddConfigEntry("session.save_model_format", "ORT");
+                sessionOption.SetOptimizedModelFilePath(pendingPath.c_str());
+            }
+#endif // _WIN32
+            try {
+                session = OpenSession(iParams.ModelPath, sessionOption, false);
+            } catch (...) {
+                if (!pendingPath.empty()) {
+                    std::remove(pendingPath.c_str());
+                }
+                throw;
+            }
+#ifndef _WIN32
+            // Written under a temporary name so a crash mid-write never leaves a truncated artifact.
+            if (!pendingPath.empty() && std::rename(pendingPath.c_str(), cachedModelPath.c_str()) != 0) {
+                std::remove(pendingPath.c_str());
+            }
+#endif // _WIN32
+        }
+        sessionCreateMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - createStart).count();
+        DCSP_LOGI("DCSP_ONNX", "Session created in %.1f ms (%s, %s)", sessionCreateMs,
+                  cachedModelPath.empty() ? "cache off" : sessionFromCache ? "cache hit" : "cache miss",
+                  ExecutionProviderName(provider));
         Ort::AllocatorWithDefaultOptions allocator;
         size_t inputNodesNum = session->GetInputCount();
         for (size_t i = 0; i < inputNodesNum; i++) {
@@ -103,6 +239,12 @@ char *DCSP_CORE::CreateSession(DCSP_INIT_PARAM &iParams) {
             outputNodeNames.push_back(temp_buf);
         }
         options = Ort::RunOptions{nullptr};
+        std::vector<int64_t> inputShape = session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        inputBatch = inputShape.empty() ? 1 : inputShape[0];
+        inputNodeDims = {1, 3, imgSize.at(0), imgSize.at(1)};
+        if (iParams.UseIoBinding && modelType < 4) {
+            BindIo();
+        }
         WarmUpSession();
         return RET_OK;
     }
@@ -112,7 +254,7 @@ char *DCSP_CORE::CreateSession(DCSP_INIT_PARAM &iParams) {
         std::string result = std::string(str1) + std::string(str2);
         char *merged = new char[result.length() + 1];
         std::strcpy(merged, result.c_str());
-        std::cout << merged << std::endl;
+        DCSP_LOGE("DCSP_ONNX", "%s", merged);
         delete[] merged;
         return "[DCSP_ONNX]:Create session failed.";
     }
@@ -120,25 +262,169 @@ char *DCSP_CORE::CreateSession(DCSP_INIT_PARAM &iParams) {
 }
 
 
-char *DCSP_CORE::RunSession(cv::Mat &iImg, std::vector<DCSP_RESULT> &oResult) {
-#ifdef benchmark
-    clock_t starttime_1 = clock();
-#endif // benchmark
+Ort::Session *DCSP_CORE::OpenSession(const std::string &path, Ort::SessionOptions &sessionOption, bool ortFormat,
+                                     bool sharePrepacked) {
+    OrtEnvironment &environment = OrtEnvironment::Instance();
+    Ort::Env &env = environment.Env();
+    // Sessions with their own pools are the opt-out path, keep them fully independent.
+    OrtPrepackedWeightsContainer *prepacked = nullptr;
+    if (globalThreadPools && sharePrepacked) {
+        prepacked = environment.PrepackedWeights();
+    }
+#ifdef _WIN32
+    int ModelPathSize = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), static_cast<int>(path.length()), nullptr, 0);
+    std::wstring modelPath(ModelPathSize, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), static_cast<int>(path.length()), &modelPath[0], ModelPathSize);
+    return prepacked ? new Ort::Session(env, modelPath.c_str(), sessionOption, prepacked)
+                    : new Ort::Session(env, modelPath.c_str(), sessionOption);
+#else
+    if (!mapModelFile || modelFile.Open(path, true) != RET_OK) {
+        return prepacked ? new Ort::Session(env, path.c_str(), sessionOption, prepacked)
+                        : new Ort::Session(env, path.c_str(), sessionOption);
+    }
+    if (ortFormat) {
+        // The session keeps pointing into the mapping (open until ~DCSP_CORE), so the flatbuffer
+        // and its initializers stay file-backed instead of being copied to the heap.
+        sessionOption.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+        sessionOption.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+    }
+    Ort::Session *created = nullptr;
+    try {
+        created = prepacked ? new Ort::Session(env, modelFile.Data(), modelFile.Size(), sessionOption, prepacked)
+                            : new Ort::Session(env, modelFile.Data(), modelFile.Size(), sessionOption);
+    } catch (...) {
+        modelFile.Close();
+        throw;
+    }
+    if (!ortFormat) {
+        // ONNX protobufs are parsed into ORT-owned tensors, the bytes are dead once the session exists.
+        modelFile.Close();
+    }
+    return created;
+#endif // _WIN32
+}
+
+
+char *DCSP_CORE::BindIo() {
+    memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    ioBinding = Ort::IoBinding(*session);
+
+    inputBuffer.assign(3 * imgSize.at(0) * imgSize.at(1), 0.f);
+    inputBlobs.assign(1, inputBuffer.data());
+    inputValues.clear();
+    inputValues.push_back(Ort::Value::CreateTensor<float>(memoryInfo, inputBuffer.data(), inputBuffer.size(),
+                                                          inputNodeDims.data(), inputNodeDims.size()));
+    ioBinding.BindInput(inputNodeNames[0], inputValues.front());
+    boundInput = inputBuffer.data();
+
+    // Preallocate the first output when its shape is static (batch may be symbolic), otherwise
+    // let ORT allocate it from its arena on every run.
+    auto outputInfo = session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo();
+    boundOutputDims = outputInfo.GetShape();
+    if (!boundOutputDims.empty() && boundOutputDims[0] < 0) {
+        boundOutputDims[0] = 1;
+    }
+    bool staticShape = outputInfo.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+    size_t outputSize = 1;
+    for (int64_t dim: boundOutputDims) {
+        staticShape = staticShape && dim > 0;
+        outputSize *= static_cast<size_t>(std::max<int64_t>(dim, 1));
+    }
+    if (staticShape) {
+        outputBuffer.assign(outputSize, 0.f);
+        outputValue = Ort::Value::CreateTensor<float>(memoryInfo, outputBuffer.data(), outputBuffer.size(),
+                                                      boundOutputDims.data(), boundOutputDims.size());
+        ioBinding.BindOutput(outputNodeNames[0], outputValue);
+    } else {
+        outputBuffer.clear();
+        ioBinding.BindOutput(outputNodeNames[0], memoryInfo);
+    }
+    for (size_t i = 1; i < outputNodeNames.size(); i++) {
+        ioBinding.BindOutput(outputNodeNames[i], memoryInfo);
+    }
+    ioBindingEnable = true;
+    return RET_OK;
+}
+
+
+void DCSP_CORE::BindInputBlob(float *blob) {
+    if (blob == boundInput) {
+        return;
+    }
+    auto registered = std::find(inputBlobs.begin(), inputBlobs.end(), blob);
+    if (registered != inputBlobs.end()) {
+        ioBinding.BindInput(inputNodeNames[0], inputValues[registered - inputBlobs.begin()]);
+    } else {
+        transientInput = Ort::Value::CreateTensor<float>(memoryInfo, blob, inputBuffer.size(),
+                                                         inputNodeDims.data(), inputNodeDims.size());
+        ioBinding.BindInput(inputNodeNames[0], transientInput);
+    }
+    boundInput = blob;
+}
+
+
+char *DCSP_CORE::RegisterInputBlobs(const std::vector<float *> &blobs) {
+    if (!ioBindingEnable) {
+        return RET_OK;
+    }
+    for (float *blob: blobs) {
+        if (std::find(inputBlobs.begin(), inputBlobs.end(), blob) != inputBlobs.end()) {
+            continue;
+        }
+        inputBlobs.push_back(blob);
+        inputValues.push_back(Ort::Value::CreateTensor<float>(memoryInfo, blob, inputBuffer.size(),
+                                                              inputNodeDims.data(), inputNodeDims.size()));
+    }
+    return RET_OK;
+}
+
+
+void DCSP_CORE::UnregisterInputBlobs(const std::vector<float *> &blobs) {
+    // Entry 0 is inputBuffer, which is never unregistered.
+    for (size_t i = inputBlobs.size(); i-- > 1;) {
+        if (std::find(blobs.begin(), blobs.end(), inputBlobs[i]) == blobs.end()) {
+            continue;
+        }
+        if (boundInput == inputBlobs[i]) {
+            // Forces a rebind before the next run.
+            boundInput = nullptr;
+        }
+        inputBlobs.erase(inputBlobs.begin() + static_cast<std::ptrdiff_t>(i));
+        inputValues.erase(inputValues.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+
+float *DCSP_CORE::AcquireInputBlob() {
+    if (ioBindingEnable) {
+        BindInputBlob(inputBuffer.data());
+        return inputBuffer.data();
+    }
+    return frameArena.AllocateArray<float>(3 * static_cast<size_t>(imgSize.at(0)) * imgSize.at(1));
+}
 
+
+char *DCSP_CORE::RunSession(const cv::Mat &iImg, std::vector<DCSP_RESULT> &oResult) {
+    PerfTimer preprocessTimer(PERF_PREPROCESS);
     char *Ret = RET_OK;
-    cv::Mat processedImg;
-    PostProcess(iImg, imgSize, processedImg);
+    frameArena.Reset();
     if (modelType < 4) {
-        float *blob = new float[processedImg.total() * 3];
-        BlobFromImage(processedImg, blob);
-        std::vector<int64_t> inputNodeDims = {1, 3, imgSize.at(0), imgSize.at(1)};
-        TensorProcess(starttime_1, iImg, blob, inputNodeDims, oResult);
+        float *blob = AcquireInputBlob();
+        Ret = PreprocessLetterbox(iImg, imgSize.at(1), imgSize.at(0), blob, preprocessWorkspace, letterbox);
+        if (Ret != RET_OK) {
+            return Ret;
+        }
+        TensorProcess(preprocessTimer, blob, inputNodeDims, oResult);
     } else {
 #ifdef USE_CUDA
-        half* blob = new half[processedImg.total() * 3];
+        cv::Mat processedImg;
+        PostProcess(iImg, imgSize, processedImg);
+        letterbox = LETTERBOX_INFO();
+        letterbox.scaleX = static_cast<float>(imgSize.at(0)) / iImg.cols;
+        letterbox.scaleY = static_cast<float>(imgSize.at(1)) / iImg.rows;
+        half* blob = frameArena.AllocateArray<half>(processedImg.total() * 3);
         BlobFromImage(processedImg, blob);
-        std::vector<int64_t> inputNodeDims = { 1,3,imgSize.at(0),imgSize.at(1) };
-        TensorProcess(starttime_1, iImg, blob, inputNodeDims, oResult);
+        TensorProcess(preprocessTimer, blob, inputNodeDims, oResult);
 #endif
     }
 
@@ -146,103 +432,112 @@ char *DCSP_CORE::RunSession(cv::Mat &iImg, std::vector<DCSP_RESULT> &oResult) {
 }
 
 
+char *DCSP_CORE::RunSession(const YUV_IMAGE &iImg, std::vector<DCSP_RESULT> &oResult) {
+    PerfTimer preprocessTimer(PERF_PREPROCESS);
+    if (modelType >= 4) {
+        return "[DCSP_ONNX]:YUV input is only supported for FP32 models.";
+    }
+    frameArena.Reset();
+    float *blob = AcquireInputBlob();
+    char *Ret = PreprocessYuvLetterbox(iImg, imgSize.at(1), imgSize.at(0), blob, preprocessWorkspace, letterbox);
+    if (Ret != RET_OK) {
+        return Ret;
+    }
+    TensorProcess(preprocessTimer, blob, inputNodeDims, oResult);
+    return RET_OK;
+}
+
+
+char *DCSP_CORE::RunSession(const DCSP_BLOB &iBlob, std::vector<DCSP_RESULT> &oResult) {
+    // Whoever letterboxed the blob has already recorded the preprocess stage.
+    PerfTimer preprocessTimer(PERF_PREPROCESS);
+    preprocessTimer.Cancel();
+    if (modelType >= 4) {
+        return "[DCSP_ONNX]:Preprocessed blobs are only supported for FP32 models.";
+    }
+    frameArena.Reset();
+    letterbox = iBlob.letterbox;
+    float *blob = iBlob.data;
+    if (ioBindingEnable) {
+        BindInputBlob(blob);
+    }
+    return TensorProcess(preprocessTimer, blob, inputNodeDims, oResult);
+}
+
+
 template<typename N>
-char *DCSP_CORE::TensorProcess(clock_t &starttime_1, cv::Mat &iImg, N &blob, std::vector<int64_t> &inputNodeDims,
+char *DCSP_CORE::TensorProcess(PerfTimer &preprocessTimer, N &blob, std::vector<int64_t> &inputNodeDims,
                                std::vector<DCSP_RESULT> &oResult) {
-    Ort::Value inputTensor = Ort::Value::CreateTensor<typename std::remove_pointer<N>::type>(
-            Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU), blob, 3 * imgSize.at(0) * imgSize.at(1),
-            inputNodeDims.data(), inputNodeDims.size());
-#ifdef benchmark
-    clock_t starttime_2 = clock();
-#endif // benchmark
-    auto outputTensor = session->Run(options, inputNodeNames.data(), &inputTensor, 1, outputNodeNames.data(),
-                                     outputNodeNames.size());
-#ifdef benchmark
-    clock_t starttime_3 = clock();
-#endif // benchmark
-
-    Ort::TypeInfo typeInfo = outputTensor.front().GetTypeInfo();
-    auto tensor_info = typeInfo.GetTensorTypeAndShapeInfo();
-    std::vector<int64_t> outputNodeDims = tensor_info.GetShape();
-    auto output = outputTensor.front().GetTensorMutableData<typename std::remove_pointer<N>::type>();
-    delete blob;
+    typedef typename std::remove_pointer<N>::type T;
+    preprocessTimer.Stop();
+    PerfTimer inferenceTimer(PERF_INFERENCE);
+    std::vector<Ort::Value> outputTensor;
+    T *output = nullptr;
+    bool bound = false;
+    if constexpr (std::is_same<T, float>::value) {
+        bound = ioBindingEnable;
+    }
+    {
+        // ORT's internal allocations are outside our control and excluded from the allocation count.
+        AllocationPause ortAllocations;
+        if (bound) {
+            // The blob is inputBuffer (or the caller's DCSP_BLOB), already bound as the session input.
+            session->Run(options, ioBinding);
+            if (!outputBuffer.empty()) {
+                output = reinterpret_cast<T *>(outputBuffer.data());
+                outputDims.assign(boundOutputDims.begin(), boundOutputDims.end());
+            } else {
+                outputTensor = ioBinding.GetOutputValues();
+            }
+        } else {
+            // blob lives in frameArena or belongs to the caller, nothing to free here.
+            Ort::Value inputTensor = Ort::Value::CreateTensor<T>(
+                    Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU), blob,
+                    3 * imgSize.at(0) * imgSize.at(1), inputNodeDims.data(), inputNodeDims.size());
+            outputTensor = session->Run(options, inputNodeNames.data(), &inputTensor, 1, outputNodeNames.data(),
+                                        outputNodeNames.size());
+        }
+        if (output == nullptr) {
+            Ort::TensorTypeAndShapeInfo tensorInfo = outputTensor.front().GetTensorTypeAndShapeInfo();
+            outputDims.resize(tensorInfo.GetDimensionsCount());
+            tensorInfo.GetDimensions(outputDims.data(), outputDims.size());
+            output = outputTensor.front().GetTensorMutableData<T>();
+        }
+    }
+    inferenceTimer.Stop();
+
     switch (modelType) {
         case 1://V8_ORIGIN_FP32
         case 4://V8_ORIGIN_FP16
         {
-            int strideNum = outputNodeDims[2];
-            int signalResultNum = outputNodeDims[1];
-            std::vector<int> class_ids;
-            std::vector<float> confidences;
-            std::vector<cv::Rect> boxes;
-
-            cv::Mat rawData;
-            if (modelType == 1) {
-                // FP32
-                rawData = cv::Mat(signalResultNum, strideNum, CV_32F, output);
-            } else {
-                // FP16
-                rawData = cv::Mat(signalResultNum, strideNum, CV_16F, output);
-                rawData.convertTo(rawData, CV_32F);
-            }
-            rawData = rawData.t();
-            float *data = (float *) rawData.data;
-
-            float x_factor = iImg.cols / 320.;
-            float y_factor = iImg.rows / 320.;
-            for (int i = 0; i < strideNum; ++i) {
-                float *classesScores = data + 4;
-                cv::Mat scores(1, this->classes.size(), CV_32FC1, classesScores);
-                cv::Point class_id;
-                double maxClassScore;
-                cv::minMaxLoc(scores, 0, &maxClassScore, 0, &class_id);
-                if (maxClassScore > rectConfidenceThreshold) {
-                    confidences.push_back(maxClassScore);
-                    class_ids.push_back(class_id.x);
-
-                    float x = data[0];
-                    float y = data[1];
-                    float w = data[2];
-                    float h = data[3];
-
-                    int left = int((x - 0.5 * w) * x_factor);
-                    int top = int((y - 0.5 * h) * y_factor);
-
-                    int width = int(w * x_factor);
-                    int height = int(h * y_factor);
-
-                    boxes.emplace_back(left, top, width, height);
-                }
-                data += signalResultNum;
+            int strideNum = outputDims[2];
+            int signalResultNum = outputDims[1];
+            const float *data = reinterpret_cast<const float *>(output);
+            if (modelType != 1) {
+                // FP16, widened into the frame arena
+                float *widened = frameArena.AllocateArray<float>(static_cast<size_t>(signalResultNum) * strideNum);
+                cv::Mat rawData(signalResultNum, strideNum, CV_32F, widened);
+                cv::Mat(signalResultNum, strideNum, CV_16F, output).convertTo(rawData, CV_32F);
+                data = widened;
             }
+            PerfTimer decodeTimer(PERF_DECODE);
+            DecodeYoloV8(data, signalResultNum, strideNum, rectConfidenceThreshold, letterbox, candidates);
+            decodeTimer.Stop();
 
-            std::vector<int> nmsResult;
-            cv::dnn::NMSBoxes(boxes, confidences, rectConfidenceThreshold, iouThreshold, nmsResult);
+            PerfTimer nmsTimer(PERF_NMS);
+            nmsParam.iouThreshold = iouThreshold;
+            nmsEngine.Run(candidates, nmsParam, nmsResult);
 
-            for (int i = 0; i < nmsResult.size(); ++i) {
-                int idx = nmsResult[i];
+            for (int idx: nmsResult) {
+                const DCSP_CANDIDATE &candidate = candidates[idx];
                 DCSP_RESULT result;
-                result.classId = class_ids[idx];
-                result.confidence = confidences[idx];
-                result.box = boxes[idx];
+                result.classId = candidate.classId;
+                result.confidence = candidate.confidence;
+                result.box = cv::Rect(int(candidate.x), int(candidate.y), int(candidate.width), int(candidate.height));
                 oResult.push_back(result);
             }
 
 
-#ifdef benchmark
-            clock_t starttime_4 = clock();
-            double pre_process_time = (double) (starttime_2 - starttime_1) / CLOCKS_PER_SEC * 1000;
-            double process_time = (double) (starttime_3 - starttime_2) / CLOCKS_PER_SEC * 1000;
-            double post_process_time = (double) (starttime_4 - starttime_3) / CLOCKS_PER_SEC * 1000;
-            if (cudaEnable) {
-                std::cout << "[DCSP_ONNX(CUDA)]: " << pre_process_time << "ms pre-process, " << process_time
-                          << "ms inference, " << post_process_time << "ms post-process." << std::endl;
-            } else {
-                std::cout << "[DCSP_ONNX(CPU)]: " << pre_process_time << "ms pre-process, " << process_time
-                          << "ms inference, " << post_process_time << "ms post-process." << std::endl;
-            }
-#endif // benchmark
-
             break;
         }
     }
@@ -250,14 +545,137 @@ char *DCSP_CORE::TensorProcess(clock_t &starttime_1, cv::Mat &iImg, N &blob, std
 }
 
 
+static cv::Size ImageSize(const cv::Mat &iImg) {
+    return iImg.size();
+}
+
+
+static cv::Size ImageSize(const YUV_IMAGE &iImg) {
+    return cv::Size(iImg.width, iImg.height);
+}
+
+
+static char *PreprocessTile(const cv::Mat &iImg, const cv::Rect &tile, int dstWidth, int dstHeight, float *oBlob,
+                            PreprocessWorkspace &workspace, LETTERBOX_INFO &oInfo) {
+    // An ROI header over the frame; the fused kernel honours its row stride, nothing is copied.
+    return PreprocessLetterbox(iImg(tile), dstWidth, dstHeight, oBlob, workspace, oInfo);
+}
+
+
+static char *PreprocessTile(const YUV_IMAGE &iImg, const cv::Rect &tile, int dstWidth, int dstHeight, float *oBlob,
+                            PreprocessWorkspace &workspace, LETTERBOX_INFO &oInfo) {
+    return PreprocessYuvLetterbox(CropYuv(iImg, tile), dstWidth, dstHeight, oBlob, workspace, oInfo);
+}
+
+
+char *DCSP_CORE::RunTiledSession(const cv::Mat &iImg, const TILE_PARAM &iTiles, std::vector<DCSP_RESULT> &oResult) {
+    return TiledTensorProcess(iImg, iTiles, oResult);
+}
+
+
+char *DCSP_CORE::RunTiledSession(const YUV_IMAGE &iImg, const TILE_PARAM &iTiles, std::vector<DCSP_RESULT> &oResult) {
+    return TiledTensorProcess(iImg, iTiles, oResult);
+}
+
+
+template<typename Image>
+char *DCSP_CORE::TiledTensorProcess(const Image &iImg, const TILE_PARAM &iTiles, std::vector<DCSP_RESULT> &oResult) {
+    PerfTimer preprocessTimer(PERF_PREPROCESS);
+    if (modelType != YOLO_ORIGIN_V8) {
+        return "[DCSP_ONNX]:Tiled inference is only supported for FP32 YOLOv8 models.";
+    }
+    cv::Size frameSize = ImageSize(iImg);
+    char *Ret = ComputeTiles(frameSize.width, frameSize.height, iTiles, tiles);
+    if (Ret != RET_OK) {
+        return Ret;
+    }
+    int batch = static_cast<int>(tiles.size());
+    bool batched = inputBatch < 0 || inputBatch == batch;
+    if (!batched && inputBatch != 1) {
+        return "[DCSP_ONNX]:The model's static batch size does not match the tile count.";
+    }
+
+    frameArena.Reset();
+    size_t planeSize = 3 * static_cast<size_t>(imgSize.at(0)) * imgSize.at(1);
+    float *blob = frameArena.AllocateArray<float>(planeSize * batch);
+    tileLetterboxes.resize(batch);
+    for (int b = 0; b < batch; b++) {
+        bool whole = tiles[b].width == frameSize.width && tiles[b].height == frameSize.height;
+        Ret = PreprocessTile(iImg, tiles[b], imgSize.at(1), imgSize.at(0), blob + b * planeSize,
+                             whole ? preprocessWorkspace : tileWorkspace, tileLetterboxes[b]);
+        if (Ret != RET_OK) {
+            return Ret;
+        }
+    }
+    preprocessTimer.Stop();
+
+    PerfTimer inferenceTimer(PERF_INFERENCE);
+    int perRun = batched ? batch : 1;
+    tileInputDims.assign({perRun, 3, imgSize.at(0), imgSize.at(1)});
+    tileOutputs.clear();
+    {
+        AllocationPause ortAllocations;
+        Ort::MemoryInfo cpuMemory = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+        for (int first = 0; first < batch; first += perRun) {
+            Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+                    cpuMemory, blob + first * planeSize, perRun * planeSize, tileInputDims.data(), tileInputDims.size());
+            std::vector<Ort::Value> outputTensor = session->Run(options, inputNodeNames.data(), &inputTensor, 1,
+                                                                outputNodeNames.data(), outputNodeNames.size());
+            tileOutputs.push_back(std::move(outputTensor.front()));
+        }
+    }
+    inferenceTimer.Stop();
+
+    PerfTimer decodeTimer(PERF_DECODE);
+    candidates.clear();
+    candidateTiles.clear();
+    for (size_t run = 0; run < tileOutputs.size(); run++) {
+        Ort::TensorTypeAndShapeInfo tensorInfo = tileOutputs[run].GetTensorTypeAndShapeInfo();
+        outputDims.resize(tensorInfo.GetDimensionsCount());
+        tensorInfo.GetDimensions(outputDims.data(), outputDims.size());
+        int signalResultNum = static_cast<int>(outputDims[1]);
+        int strideNum = static_cast<int>(outputDims[2]);
+        const float *output = tileOutputs[run].GetTensorData<float>();
+        for (int k = 0; k < perRun; k++) {
+            int b = static_cast<int>(run) * perRun + k;
+            DecodeYoloV8(output + static_cast<size_t>(k) * signalResultNum * strideNum, signalResultNum, strideNum,
+                         rectConfidenceThreshold, tileLetterboxes[b], tileCandidates);
+            // Tile pixels to frame pixels.
+            for (DCSP_CANDIDATE candidate: tileCandidates) {
+                candidate.x += static_cast<float>(tiles[b].x);
+                candidate.y += static_cast<float>(tiles[b].y);
+                candidates.push_back(candidate);
+                candidateTiles.push_back(b);
+            }
+        }
+    }
+    decodeTimer.Stop();
+
+    PerfTimer nmsTimer(PERF_NMS);
+    nmsParam.iouThreshold = iouThreshold;
+    nmsEngine.Run(candidates, nmsParam, nmsResult);
+    MergeTileDetections(candidates, candidateTiles, iTiles.mergeThreshold, nmsResult);
+    for (int idx: nmsResult) {
+        const DCSP_CANDIDATE &candidate = candidates[idx];
+        DCSP_RESULT result;
+        result.classId = candidate.classId;
+        result.confidence = candidate.confidence;
+        result.box = cv::Rect(int(candidate.x), int(candidate.y), int(candidate.width), int(candidate.height));
+        oResult.push_back(result);
+    }
+    return RET_OK;
+}
+
+
 char *DCSP_CORE::WarmUpSession() {
-    clock_t starttime_1 = clock();
-    cv::Mat iImg = cv::Mat(cv::Size(imgSize.at(0), imgSize.at(1)), CV_8UC3);
-    cv::Mat processedImg;
-    PostProcess(iImg, imgSize, processedImg);
-    if (modelType < 4) {
+    auto warmUpStart = std::chrono::steady_clock::now();
+    cv::Mat iImg = cv::Mat(cv::Size(imgSize.at(1), imgSize.at(0)), CV_8UC3, cv::Scalar::all(114));
+    if (modelType < 4 && ioBindingEnable) {
+        PreprocessLetterbox(iImg, imgSize.at(1), imgSize.at(0), inputBuffer.data(), preprocessWorkspace, letterbox);
+        session->Run(options, ioBinding);
+    } else if (modelType < 4) {
         float *blob = new float[iImg.total() * 3];
-        BlobFromImage(processedImg, blob);
+        PreprocessLetterbox(iImg, imgSize.at(1), imgSize.at(0), blob, preprocessWorkspace, letterbox);
         std::vector<int64_t> YOLO_input_node_dims = {1, 3, imgSize.at(0), imgSize.at(1)};
         Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
                 Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU), blob, 3 * imgSize.at(0) * imgSize.at(1),
@@ -265,24 +683,26 @@ char *DCSP_CORE::WarmUpSession() {
         auto output_tensors = session->Run(options, inputNodeNames.data(), &input_tensor, 1, outputNodeNames.data(),
                                            outputNodeNames.size());
         delete[] blob;
-        clock_t starttime_4 = clock();
-        double post_process_time = (double) (starttime_4 - starttime_1) / CLOCKS_PER_SEC * 1000;
+        double post_process_time = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - warmUpStart).count();
         if (cudaEnable) {
-            std::cout << "[DCSP_ONNX(CUDA)]: " << "Cuda warm-up cost " << post_process_time << " ms. " << std::endl;
+            DCSP_LOGI("DCSP_ONNX(CUDA)", "Cuda warm-up cost %.2f ms.", post_process_time);
         }
     } else {
 #ifdef USE_CUDA
+        cv::Mat processedImg;
+        PostProcess(iImg, imgSize, processedImg);
         half* blob = new half[iImg.total() * 3];
         BlobFromImage(processedImg, blob);
         std::vector<int64_t> YOLO_input_node_dims = { 1,3,imgSize.at(0),imgSize.at(1) };
         Ort::Value input_tensor = Ort::Value::CreateTensor<half>(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU), blob, 3 * imgSize.at(0) * imgSize.at(1), YOLO_input_node_dims.data(), YOLO_input_node_dims.size());
         auto output_tensors = session->Run(options, inputNodeNames.data(), &input_tensor, 1, outputNodeNames.data(), outputNodeNames.size());
         delete[] blob;
-        clock_t starttime_4 = clock();
-        double post_process_time = (double)(starttime_4 - starttime_1) / CLOCKS_PER_SEC * 1000;
+        double post_process_time = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - warmUpStart).count();
         if (cudaEnable)
         {
-            std::cout << "[DCSP_ONNX(CUDA)]: " << "Cuda warm-up cost " << post_process_time << " ms. " << std::endl;
+            DCSP_LOGI("DCSP_ONNX(CUDA)", "Cuda warm-up cost %.2f ms.", post_process_time);
         }
 #endif
     }
@@ -13,6 +13,18 @@
 #include <cstdio>
 #include <opencv2/opencv.hpp>
 #include "onnxruntime_cxx_api.h"
+#include "Preprocess.h"
+#include "YoloDecode.h"
+#include "Nms.h"
+#include "Tiling.h"
+#include "ModelCache.h"
+#include "MappedFile.h"
+#include "OrtEnvironment.h"
+#include "ExecutionProvider.h"
+#include "PerfStats.h"
+#include "FrameArena.h"
+#include "TensorPool.h"
+#include "Log.h"
 
 #ifdef USE_CUDA
 #include <cuda_fp16.h>
@@ -37,9 +49,30 @@ typedef struct _DCSP_INIT_PARAM {
     std::vector<int> imgSize = {640, 640};
     float RectConfidenceThreshold = 0.6;
     float iouThreshold = 0.5;
+    int NmsTopK = 1000;
+    int MaxDetections = 300;
+    bool ClassAwareNms = true;
+    // Kept for existing callers, equivalent to Provider = EP_CUDA.
     bool CudaEnable = false;
+    // EP_AUTO times every available provider on this model at load and keeps the fastest.
+    EXECUTION_PROVIDER Provider = EP_CPU;
     int LogSeverityLevel = 3;
+    // Only used with UseGlobalThreadPools = false; otherwise ORT_ENV_PARAM sizes the shared pools.
     int IntraOpNumThreads = 1;
+    // Run on OrtEnvironment's global pools and share prepacked weights with other sessions.
+    bool UseGlobalThreadPools = true;
+    // Per-session pool policy, ignored with global pools (see THREAD_BUDGET).
+    bool AllowSpinning = false;
+    std::string IntraOpAffinity;
+    // Bind preallocated input/output buffers once instead of allocating tensors per frame (FP32 only).
+    bool UseIoBinding = true;
+    // Take ORT's CPU intermediates and outputs from the shared TensorPool instead of a per-session
+    // arena, so they share its free lists and memory budget.
+    bool UseTensorPool = true;
+    // mmap the model instead of reading it into the heap, see DCSP_CORE::OpenSession.
+    bool MapModelFile = true;
+    // Directory for optimized ORT-format models (see ModelCache.h), empty disables the cache.
+    std::string CacheDir;
 } DCSP_INIT_PARAM;
 
 
@@ -47,9 +80,18 @@ typedef struct _DCSP_RESULT {
     int classId;
     float confidence;
     cv::Rect box;
+    // Stable across frames when a Tracker is attached, -1 otherwise.
+    int trackId = -1;
 } DCSP_RESULT;
 
 
+// A CHW float blob letterboxed outside DCSP_CORE, e.g. on the camera thread by InferencePipeline.
+typedef struct _DCSP_BLOB {
+    float *data;
+    LETTERBOX_INFO letterbox;
+} DCSP_BLOB;
+
+
 class DCSP_CORE {
 public:
     DCSP_CORE();
@@ -59,20 +101,68 @@ public:
 public:
     char *CreateSession(DCSP_INIT_PARAM &iParams);
 
-    char *RunSession(cv::Mat &iImg, std::vector<DCSP_RESULT> &oResult);
+    char *RunSession(const cv::Mat &iImg, std::vector<DCSP_RESULT> &oResult);
+
+    char *RunSession(const YUV_IMAGE &iImg, std::vector<DCSP_RESULT> &oResult);
+
+    // FP32 models only. With IoBinding the blob is bound in place instead of being copied.
+    char *RunSession(const DCSP_BLOB &iBlob, std::vector<DCSP_RESULT> &oResult);
+
+    // Sliced inference for small objects, FP32 YOLOv8 only: every tile of ComputeTiles is
+    // letterboxed straight into one batched NCHW blob and the model runs once with batch = tile
+    // count. Models exported with a static batch of 1 fall back to one run per tile. Boxes are
+    // mapped back to frame pixels, then NMS and MergeTileDetections remove cross-tile duplicates.
+    char *RunTiledSession(const cv::Mat &iImg, const TILE_PARAM &iTiles, std::vector<DCSP_RESULT> &oResult);
+
+    char *RunTiledSession(const YUV_IMAGE &iImg, const TILE_PARAM &iTiles, std::vector<DCSP_RESULT> &oResult);
+
+    const std::vector<int> &InputSize() const { return imgSize; }
 
     char *WarmUpSession();
 
+    char *BindIo();
+
+    // sharePrepacked = false keeps the session's prepacked weights out of the process-wide container,
+    // so they are freed with it (EP_AUTO trial sessions).
+    Ort::Session *OpenSession(const std::string &path, Ort::SessionOptions &sessionOption, bool ortFormat,
+                              bool sharePrepacked = true);
+
+    EXECUTION_PROVIDER SelectProvider(const DCSP_INIT_PARAM &iParams);
+
+    void BindInputBlob(float *blob);
+
+    // Creates the input tensors for caller-owned blobs of 3 * height * width floats up front, e.g.
+    // InferencePipeline's slots, so RunSession(DCSP_BLOB) on one of them only swaps the binding.
+    // The blobs must stay valid until unregistered. No-op without IoBinding.
+    char *RegisterInputBlobs(const std::vector<float *> &blobs);
+
+    void UnregisterInputBlobs(const std::vector<float *> &blobs);
+
+    // Input blob for this frame: the bound inputBuffer, or a slice of frameArena.
+    float *AcquireInputBlob();
+
     template<typename N>
-    char *TensorProcess(clock_t &starttime_1, cv::Mat &iImg, N &blob, std::vector<int64_t> &inputNodeDims,
+    char *TensorProcess(PerfTimer &preprocessTimer, N &blob, std::vector<int64_t> &inputNodeDims,
                         std::vector<DCSP_RESULT> &oResult);
 
+    template<typename Image>
+    char *TiledTensorProcess(const Image &iImg, const TILE_PARAM &iTiles, std::vector<DCSP_RESULT> &oResult);
+
     std::vector<std::string> classes{};
     float rectConfidenceThreshold;
     float iouThreshold;
+
+    // Cold-start report of the last CreateSession.
+    double sessionCreateMs = 0.0;
+    bool sessionFromCache = false;
+    // Provider the session runs on; never EP_AUTO once CreateSession has resolved it.
+    EXECUTION_PROVIDER provider = EP_CPU;
 private:
-    Ort::Env env;
-    Ort::Session *session;
+    // Must outlive session: ORT-format sessions reference the mapped bytes directly.
+    MappedFile modelFile;
+    bool mapModelFile = true;
+    bool globalThreadPools = true;
+    Ort::Session *session = nullptr;
     bool cudaEnable;
     Ort::RunOptions options;
     std::vector<const char *> inputNodeNames;
@@ -81,4 +171,43 @@ private:
     MODEL_TYPE modelType;
     std::vector<int> imgSize;
 
+    bool ioBindingEnable = false;
+    Ort::MemoryInfo memoryInfo{nullptr};
+    Ort::IoBinding ioBinding{nullptr};
+    // Input tensors created once, over inputBuffer (first entry) and every registered blob.
+    std::vector<float *> inputBlobs;
+    std::vector<Ort::Value> inputValues;
+    // Wraps an unregistered blob for a single run.
+    Ort::Value transientInput{nullptr};
+    float *boundInput = nullptr;
+    Ort::Value outputValue{nullptr};
+    std::vector<int64_t> inputNodeDims;
+    // Batch axis of the model input: -1 when symbolic, otherwise the exported batch size.
+    int64_t inputBatch = 1;
+    std::vector<int64_t> boundOutputDims;
+    // 64-byte aligned and counted against the TensorPool budget.
+    std::vector<float, TensorPoolAllocator<float>> inputBuffer;
+    std::vector<float, TensorPoolAllocator<float>> outputBuffer;
+
+    PreprocessWorkspace preprocessWorkspace;
+    LETTERBOX_INFO letterbox;
+    std::vector<DCSP_CANDIDATE> candidates;
+    NMS_PARAM nmsParam;
+    NmsEngine nmsEngine;
+    std::vector<int> nmsResult;
+    std::vector<int64_t> outputDims;
+    // Per-frame scratch (unbound input blobs, FP16 widening), reset at the start of every RunSession.
+    FrameArena frameArena;
+
+    // Tiled runs. Tiles share one size, so their workspace keeps its tables; the full-frame entry
+    // uses preprocessWorkspace.
+    PreprocessWorkspace tileWorkspace;
+    std::vector<cv::Rect> tiles;
+    std::vector<LETTERBOX_INFO> tileLetterboxes;
+    std::vector<int64_t> tileInputDims;
+    std::vector<Ort::Value> tileOutputs;
+    std::vector<DCSP_CANDIDATE> tileCandidates;
+    // Tile each entry of candidates was decoded from.
+    std::vector<int> candidateTiles;
+
 };
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "InferencePipeline.h"
+#include <utility>
+#include "ThreadBudget.h"
+
+
+InferencePipeline::InferencePipeline(const std::vector<int> &inputSize, RunFn run, ResultFn onResult)
+        : inputWidth(inputSize.at(1)), inputHeight(inputSize.at(0)), run(std::move(run)),
+          onResult(std::move(onResult)) {
+    for (PIPELINE_SLOT &slot: slots) {
+        slot.blob.assign(3 * static_cast<size_t>(inputWidth) * inputHeight, 0.f);
+    }
+    worker = std::thread(&InferencePipeline::Loop, this);
+}
+
+
+InferencePipeline::~InferencePipeline() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    readyCondition.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+
+char *InferencePipeline::Submit(const cv::Mat &iImg, uint64_t &oFrameId) {
+    return SubmitImage(iImg, oFrameId);
+}
+
+
+char *InferencePipeline::Submit(const YUV_IMAGE &iImg, uint64_t &oFrameId) {
+    return SubmitImage(iImg, oFrameId);
+}
+
+
+static char *Letterbox(const cv::Mat &iImg, int width, int height, float *blob, PreprocessWorkspace &workspace,
+                       LETTERBOX_INFO &oLetterbox) {
+    return PreprocessLetterbox(iImg, width, height, blob, workspace, oLetterbox);
+}
+
+
+static char *Letterbox(const YUV_IMAGE &iImg, int width, int height, float *blob, PreprocessWorkspace &workspace,
+                       LETTERBOX_INFO &oLetterbox) {
+    return PreprocessYuvLetterbox(iImg, width, height, blob, workspace, oLetterbox);
+}
+
+
+template<typename Image>
+char *InferencePipeline::SubmitImage(const Image &iImg, uint64_t &oFrameId) {
+    std::lock_guard<std::mutex> producerLock(producerMutex);
+    PIPELINE_SLOT &slot = slots[writeSlot];
+    PerfTimer preprocessTimer(PERF_PREPROCESS);
+    char *Ret = Letterbox(iImg, inputWidth, inputHeight, slot.blob.data(), workspace, slot.letterbox);
+    preprocessTimer.Stop();
+    if (Ret != RET_OK) {
+        return Ret;
+    }
+    slot.submitted = std::chrono::steady_clock::now();
+    oFrameId = Publish();
+    return RET_OK;
+}
+
+
+uint64_t InferencePipeline::Publish() {
+    uint64_t frameId;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        frameId = nextFrameId++;
+        slots[writeSlot].frameId = frameId;
+        std::swap(writeSlot, readySlot);
+        stats.submitted++;
+        if (readyFresh) {
+            stats.dropped++;
+        }
+        readyFresh = true;
+    }
+    readyCondition.notify_one();
+    return frameId;
+}
+
+
+PIPELINE_STATS InferencePipeline::Stats() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return stats;
+}
+
+
+std::vector<float *> InferencePipeline::SlotBlobs() {
+    std::vector<float *> blobs;
+    for (PIPELINE_SLOT &slot: slots) {
+        blobs.push_back(slot.blob.data());
+    }
+    return blobs;
+}
+
+
+void InferencePipeline::Loop() {
+    // This thread is the caller of session->Run, i.e. one of the intra-op workers.
+    PinWorkerThread();
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            readyCondition.wait(lock, [this] { return readyFresh || stopping; });
+            if (stopping) {
+                return;
+            }
+            std::swap(readSlot, readySlot);
+            readyFresh = false;
+        }
+
+        PIPELINE_SLOT &slot = slots[readSlot];
+        DCSP_BLOB blob;
+        blob.data = slot.blob.data();
+        blob.letterbox = slot.letterbox;
+        std::vector<DCSP_RESULT> results;
+        char *Ret = RET_OK;
+        try {
+            Ret = run(blob, results);
+        } catch (const std::exception &) {
+            results.clear();
+            Ret = "[DCSP_ONNX]:Inference failed on the pipeline thread.";
+        }
+        double latencyMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - slot.submitted).count();
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stats.completed++;
+        }
+        onResult(slot.frameId, latencyMs, Ret, std::move(results));
+    }
+}
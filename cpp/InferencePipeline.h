@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Inference.h"
+
+
+// Write, ready and in-flight slot: the producer never waits for inference and the consumer
+// always picks up the newest frame.
+constexpr int PIPELINE_SLOT_COUNT = 3;
+
+
+typedef struct _PIPELINE_SLOT {
+    std::vector<float> blob;
+    LETTERBOX_INFO letterbox;
+    uint64_t frameId = 0;
+    std::chrono::steady_clock::time_point submitted;
+} PIPELINE_SLOT;
+
+
+typedef struct _PIPELINE_STATS {
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    // Frames overwritten in the ready slot before the inference thread got to them.
+    uint64_t dropped = 0;
+} PIPELINE_STATS;
+
+
+// Decouples the camera from model latency. Submit() letterboxes the frame on the calling thread
+// (the camera buffer is only valid for that call) into the write slot and publishes it as the
+// ready slot, replacing any frame still waiting there (latest wins). A dedicated thread takes
+// the ready slot, runs the model on it and hands the detections to the result callback.
+class InferencePipeline {
+public:
+    typedef std::function<char *(const DCSP_BLOB &blob, std::vector<DCSP_RESULT> &oResult)> RunFn;
+    typedef std::function<void(uint64_t frameId, double latencyMs, char *error,
+                               std::vector<DCSP_RESULT> &&results)> ResultFn;
+
+    // inputSize is the model's {height, width}. run is called on the inference thread only.
+    InferencePipeline(const std::vector<int> &inputSize, RunFn run, ResultFn onResult);
+
+    ~InferencePipeline();
+
+    InferencePipeline(const InferencePipeline &) = delete;
+
+    InferencePipeline &operator=(const InferencePipeline &) = delete;
+
+    char *Submit(const cv::Mat &iImg, uint64_t &oFrameId);
+
+    char *Submit(const YUV_IMAGE &iImg, uint64_t &oFrameId);
+
+    PIPELINE_STATS Stats();
+
+    // The slot blobs, fixed for the pipeline's lifetime, e.g. for DCSP_CORE::RegisterInputBlobs.
+    std::vector<float *> SlotBlobs();
+
+private:
+    template<typename Image>
+    char *SubmitImage(const Image &iImg, uint64_t &oFrameId);
+
+    uint64_t Publish();
+
+    void Loop();
+
+    int inputWidth;
+    int inputHeight;
+    RunFn run;
+    ResultFn onResult;
+
+    PIPELINE_SLOT slots[PIPELINE_SLOT_COUNT];
+
+    // Guards writeSlot, the workspace and the write slot's contents against concurrent producers.
+    std::mutex producerMutex;
+    PreprocessWorkspace workspace;
+    int writeSlot = 0;
+
+    // Guards readySlot, readyFresh, stopping and stats.
+    std::mutex stateMutex;
+    std::condition_variable readyCondition;
+    int readySlot = 1;
+    bool readyFresh = false;
+    bool stopping = false;
+    PIPELINE_STATS stats;
+    uint64_t nextFrameId = 1;
+
+    // Owned by the inference thread.
+    int readSlot = 2;
+
+    std::thread worker;
+};
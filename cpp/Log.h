@@ -0,0 +1,28 @@
+#pragma once
+
+// Logging for code that must also build off-device: logcat on Android, stderr everywhere else.
+// Debug messages are dropped on the host unless DCSP_LOG_DEBUG is defined.
+
+#ifdef __ANDROID__
+#include <android/log.h>
+
+#define DCSP_LOG(level, tag, ...) __android_log_print(ANDROID_LOG_##level, tag, __VA_ARGS__)
+#else
+#include <cstdio>
+
+#define DCSP_LOG(level, tag, ...)                          \
+    do {                                                   \
+        std::fprintf(stderr, "%c/%s: ", #level[0], tag);   \
+        std::fprintf(stderr, __VA_ARGS__);                 \
+        std::fputc('\n', stderr);                          \
+    } while (0)
+#endif // __ANDROID__
+
+#if defined(__ANDROID__) || defined(DCSP_LOG_DEBUG)
+#define DCSP_LOGD(tag, ...) DCSP_LOG(DEBUG, tag, __VA_ARGS__)
+#else
+#define DCSP_LOGD(tag, ...) ((void) 0)
+#endif
+#define DCSP_LOGI(tag, ...) DCSP_LOG(INFO, tag, __VA_ARGS__)
+#define DCSP_LOGW(tag, ...) DCSP_LOG(WARN, tag, __VA_ARGS__)
+#define DCSP_LOGE(tag, ...) DCSP_LOG(ERROR, tag, __VA_ARGS__)
@@ -0,0 +1,60 @@
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+
+char *MappedFile::Open(const std::string &path, bool prefetch) {
+    Close();
+#ifdef _WIN32
+    return "[DCSP_ONNX]:Memory-mapped model loading is not supported on Windows.";
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return "[DCSP_ONNX]:Cannot open model file for mapping.";
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return "[DCSP_ONNX]:Cannot map an empty model file.";
+    }
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (prefetch) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    void *mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, flags, fd, 0);
+    // The mapping holds its own reference to the file.
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return "[DCSP_ONNX]:mmap of model file failed.";
+    }
+    if (prefetch) {
+        madvise(mapped, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+    }
+    data = mapped;
+    size = static_cast<size_t>(info.st_size);
+    return RET_OK;
+#endif
+}
+
+
+void MappedFile::Close() {
+#ifndef _WIN32
+    if (data != nullptr) {
+        munmap(data, size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
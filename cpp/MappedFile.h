@@ -0,0 +1,38 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <cstddef>
+#include <string>
+
+
+// Read-only, private mapping of a whole file. Pages are backed by the page cache instead of
+// anonymous heap, so they are shared with the kernel's copy and can be dropped under pressure.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // prefetch asks the kernel to read the file ahead (MAP_POPULATE / MADV_WILLNEED) so the
+    // consumer does not fault page by page.
+    char *Open(const std::string &path, bool prefetch);
+
+    void Close();
+
+    const void *Data() const { return data; }
+
+    size_t Size() const { return size; }
+
+    bool IsOpen() const { return data != nullptr; }
+
+private:
+    void *data = nullptr;
+    size_t size = 0;
+};
@@ -0,0 +1,74 @@
+#include "ModelCache.h"
+#include <cerrno>
+#include <cstdio>
+#include <sys/stat.h>
+#include "onnxruntime_cxx_api.h"
+
+
+uint64_t HashBytes(const void *data, size_t size, uint64_t seed) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+
+char *HashFile(const std::string &path, uint64_t &oHash) {
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return "[DCSP_ONNX]:Cannot open model file for hashing.";
+    }
+    unsigned char chunk[64 * 1024];
+    uint64_t hash = FNV1A_OFFSET_BASIS;
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        hash = HashBytes(chunk, read, hash);
+    }
+    bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (failed) {
+        return "[DCSP_ONNX]:Error while reading model file for hashing.";
+    }
+    oHash = hash;
+    return RET_OK;
+}
+
+
+bool FileExists(const std::string &path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+}
+
+
+bool EnsureDirectory(const std::string &path) {
+    if (path.empty()) {
+        return false;
+    }
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0) {
+        return S_ISDIR(info.st_mode);
+    }
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos && slash > 0 && !EnsureDirectory(path.substr(0, slash))) {
+        return false;
+    }
+    return mkdir(path.c_str(), 0700) == 0 || errno == EEXIST;
+}
+
+
+std::string ModelCachePath(const std::string &cacheDir, uint64_t modelHash, const std::string &sessionDescriptor) {
+    std::string ortVersion = OrtGetApiBase()->GetVersionString();
+    uint64_t key = HashBytes(ortVersion.data(), ortVersion.size(), modelHash);
+    key = HashBytes(sessionDescriptor.data(), sessionDescriptor.size(), key);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.ort", static_cast<unsigned long long>(key));
+    std::string path = cacheDir;
+    if (!path.empty() && path.back() != '/') {
+        path += '/';
+    }
+    return path + name;
+}
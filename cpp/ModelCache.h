@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+constexpr uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ull;
+constexpr uint64_t FNV1A_PRIME = 0x100000001b3ull;
+
+
+// 64-bit FNV-1a, seed chains several inputs into one hash.
+uint64_t HashBytes(const void *data, size_t size, uint64_t seed = FNV1A_OFFSET_BASIS);
+
+// Hashes the file contents in fixed-size chunks.
+char *HashFile(const std::string &path, uint64_t &oHash);
+
+bool FileExists(const std::string &path);
+
+// Creates path and any missing parents.
+bool EnsureDirectory(const std::string &path);
+
+// Location of the optimized ORT-format model for these model bytes and session settings. The
+// ORT version is folded into the key, so an ORT upgrade never loads a stale artifact.
+// sessionDescriptor must cover every option that changes the optimized graph.
+std::string ModelCachePath(const std::string &cacheDir, uint64_t modelHash, const std::string &sessionDescriptor);
@@ -0,0 +1,193 @@
+#include "ModelRegistry.h"
+#include "Log.h"
+#include <sys/stat.h>
+
+ModelRegistry &ModelRegistry::instance() {
+  static ModelRegistry registry;
+  return registry;
+}
+
+ModelRegistry::~ModelRegistry() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stopping = true;
+    tasks.clear();
+  }
+  queueReady.notify_one();
+  if (loader.joinable()) {
+    loader.join();
+  }
+}
+
+void ModelRegistry::post(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (stopping) {
+      return;
+    }
+    tasks.push_back(std::move(task));
+    if (!loader.joinable()) {
+      loader = std::thread(&ModelRegistry::loaderLoop, this);
+    }
+  }
+  queueReady.notify_one();
+}
+
+bool ModelRegistry::onLoaderThread() {
+  std::lock_guard<std::mutex> lock(queueMutex);
+  return loaderId == std::this_thread::get_id();
+}
+
+void ModelRegistry::loaderLoop() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    loaderId = std::this_thread::get_id();
+  }
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(queueMutex);
+      queueReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+      if (stopping) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+  }
+}
+
+std::string ModelRegistry::makeId(const MODEL_KEY &key) {
+  return key.modelPath + '\n' + key.modelType + '\n' + std::to_string(key.inputWidth) + 'x' +
+         std::to_string(key.inputHeight) + '\n' + ExecutionProviderName(key.provider);
+}
+
+size_t ModelRegistry::estimateFootprint(const MODEL_KEY &key) {
+  // Weights dominate: the file size plus the bound input blob is a usable lower bound without
+  // asking ORT, which has no API for a session's memory use.
+  struct stat info;
+  size_t weights = stat(key.modelPath.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+  return weights + 3 * sizeof(float) * static_cast<size_t>(key.inputWidth) * key.inputHeight;
+}
+
+MODEL_FUTURE ModelRegistry::load(const MODEL_KEY &key, bool retryFailed) {
+  std::string id = makeId(key);
+  std::unique_lock<std::mutex> lock(mutex);
+
+  auto found = index.find(id);
+  if (found != index.end()) {
+    if (!retryFailed || !found->second->failed) {
+      entries.splice(entries.begin(), entries, found->second);
+      return found->second->future;
+    }
+    DCSP_LOGI("ModelRegistry", "Retrying failed load of %s", key.modelPath.c_str());
+    entries.erase(found->second);
+    index.erase(found);
+  }
+
+  auto promise = std::make_shared<std::promise<std::shared_ptr<OnnxFrameProcessor>>>();
+  ENTRY entry;
+  entry.id = id;
+  entry.key = key;
+  entry.future = promise->get_future().share();
+  entry.generation = nextGeneration++;
+  entry.bytes = estimateFootprint(key);
+  entry.failed = false;
+  entries.push_front(entry);
+  index[id] = entries.begin();
+  inUse += entry.bytes;
+  DCSP_LOGI("ModelRegistry", "Loading %s (%dx%d) in the background, ~%zu KB, %zu cached",
+            key.modelPath.c_str(), key.inputWidth, key.inputHeight, entry.bytes >> 10, entries.size());
+  enforceBudget();
+
+  // Session creation and warm-up take hundreds of milliseconds; keep them off the camera and JS threads.
+  MODEL_FUTURE future = entry.future;
+  uint64_t generation = entry.generation;
+  lock.unlock();
+  auto task = [this, key, id, generation, promise]() {
+    try {
+      auto processor = std::make_shared<OnnxFrameProcessor>();
+      processor->loadModel(key.modelPath, key.modelType, key.inputWidth, key.inputHeight, key.provider);
+      promise->set_value(processor);
+    } catch (...) {
+      // Marked first, so a retry that sees the error also sees the entry as failed.
+      markFailed(id, generation);
+      promise->set_exception(std::current_exception());
+    }
+  };
+  // A posted task that reloads an evicted model would otherwise wait on a load queued behind itself.
+  if (onLoaderThread()) {
+    task();
+  } else {
+    post(task);
+  }
+  return future;
+}
+
+std::shared_ptr<OnnxFrameProcessor> ModelRegistry::acquire(const MODEL_KEY &key) {
+  return load(key).get();
+}
+
+std::shared_ptr<OnnxFrameProcessor> ModelRegistry::acquireIfReady(const MODEL_KEY &key) {
+  MODEL_FUTURE future = load(key);
+  if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return nullptr;
+  }
+  return future.get();
+}
+
+void ModelRegistry::markFailed(const std::string &id, uint64_t generation) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = index.find(id);
+  if (found != index.end() && found->second->generation == generation) {
+    found->second->failed = true;
+    inUse -= found->second->bytes;
+    found->second->bytes = 0;
+  }
+}
+
+void ModelRegistry::enforceBudget() {
+  while (inUse > budget && entries.size() > 1) {
+    ENTRY &victim = entries.back();
+    DCSP_LOGI("ModelRegistry", "Evicting %s (%dx%d) to stay within %zu KB",
+              victim.key.modelPath.c_str(), victim.key.inputWidth, victim.key.inputHeight, budget >> 10);
+    inUse -= victim.bytes;
+    index.erase(victim.id);
+    entries.pop_back();
+  }
+}
+
+void ModelRegistry::setMemoryBudget(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex);
+  budget = bytes;
+  enforceBudget();
+}
+
+size_t ModelRegistry::memoryBudget() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return budget;
+}
+
+size_t ModelRegistry::memoryInUse() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return inUse;
+}
+
+size_t ModelRegistry::size() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+void ModelRegistry::evict(const std::string &modelPath) {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (modelPath.empty() || it->key.modelPath == modelPath) {
+      inUse -= it->bytes;
+      index.erase(it->id);
+      it = entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
@@ -0,0 +1,107 @@
+#ifndef MODEL_REGISTRY_H
+#define MODEL_REGISTRY_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "onnxFrameProcessor.h"
+
+// Loaded sessions are keyed by everything that forces a rebuild.
+typedef struct _MODEL_KEY {
+  std::string modelPath;
+  std::string modelType = "onnx";
+  int inputWidth = 640;
+  int inputHeight = 640;
+  // EP_AUTO entries are keyed as requested, not by the provider the race picked.
+  EXECUTION_PROVIDER provider = EP_CPU;
+} MODEL_KEY;
+
+// Resolves once CreateSession and WarmUpSession have run; holds the exception if loading failed.
+typedef std::shared_future<std::shared_ptr<OnnxFrameProcessor>> MODEL_FUTURE;
+
+// 256 MB; comfortably holds a few YOLOv8 n/s sessions.
+constexpr size_t MODEL_REGISTRY_DEFAULT_BUDGET = 256u << 20;
+
+// Process-wide cache of OnnxFrameProcessors. A miss queues loading the model (session creation
+// and warm-up) on the registry's loader thread and evicts least recently used entries until the estimated
+// footprint fits the budget (the entry just added is never evicted). Evicted processors stay
+// alive for callers still holding them and are freed when the last reference goes.
+class ModelRegistry {
+public:
+  static ModelRegistry &instance();
+
+  // Drops queued work and joins the loader thread; a load in progress finishes first.
+  ~ModelRegistry();
+
+  // Starts loading key if it is not cached yet and never blocks. A failed load stays cached, so
+  // frames rethrow its error without reloading; retryFailed (preloadModel, createDetector)
+  // replaces it with a fresh load.
+  MODEL_FUTURE load(const MODEL_KEY &key, bool retryFailed = false);
+
+  // Blocks until key is loaded.
+  std::shared_ptr<OnnxFrameProcessor> acquire(const MODEL_KEY &key);
+
+  // Returns nullptr while key is still loading; rethrows the cached error if loading failed.
+  std::shared_ptr<OnnxFrameProcessor> acquireIfReady(const MODEL_KEY &key);
+
+  void setMemoryBudget(size_t bytes);
+  size_t memoryBudget();
+  size_t memoryInUse();
+  size_t size();
+
+  // Drops every cached entry for modelPath, or all entries when modelPath is empty.
+  void evict(const std::string &modelPath);
+
+  // Runs task on the loader thread after everything queued before it, so a task posted after
+  // load(key) finds key loaded. Tasks run one at a time and must not wait on later tasks.
+  void post(std::function<void()> task);
+
+private:
+  typedef struct _ENTRY {
+    std::string id;
+    MODEL_KEY key;
+    MODEL_FUTURE future;
+    // Distinguishes a reloaded entry from the failed one it replaced.
+    uint64_t generation;
+    size_t bytes;
+    // Set by the loader when loading threw; the entry then holds no budget.
+    bool failed;
+  } ENTRY;
+
+  static std::string makeId(const MODEL_KEY &key);
+  static size_t estimateFootprint(const MODEL_KEY &key);
+
+  void markFailed(const std::string &id, uint64_t generation);
+  void enforceBudget();
+  bool onLoaderThread();
+  void loaderLoop();
+
+  std::mutex mutex;
+  // Most recently used first.
+  std::list<ENTRY> entries;
+  std::unordered_map<std::string, std::list<ENTRY>::iterator> index;
+  size_t budget = MODEL_REGISTRY_DEFAULT_BUDGET;
+  size_t inUse = 0;
+  uint64_t nextGeneration = 1;
+
+  // Guards tasks, stopping, loader and loaderId.
+  std::mutex queueMutex;
+  std::condition_variable queueReady;
+  std::deque<std::function<void()>> tasks;
+  bool stopping = false;
+  // Started by the first post.
+  std::thread loader;
+  std::thread::id loaderId;
+};
+
+#endif
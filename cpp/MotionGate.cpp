@@ -0,0 +1,199 @@
+#include "MotionGate.h"
+#include <atomic>
+#include <cstring>
+#include "PerfStats.h"
+#include "Simd.h"
+
+
+// Samples per thumbnail cell along each axis; 4x4 averaged samples keep sensor noise well below
+// any useful threshold while reading under 40k source pixels per frame.
+static constexpr int CELL_SAMPLES = 4;
+static constexpr int SAMPLE_COLUMNS = MOTION_THUMB_WIDTH * CELL_SAMPLES;
+static constexpr int SAMPLE_ROWS = MOTION_THUMB_HEIGHT * CELL_SAMPLES;
+
+
+static std::atomic<uint64_t> gChecked{0};
+static std::atomic<uint64_t> gSkipped{0};
+static std::atomic<float> gLastDifference{0.f};
+
+
+// Centres of count evenly spaced sub-cells across extent pixels.
+static void SamplePositions(int extent, int count, int *oPositions) {
+    for (int i = 0; i < count; i++) {
+        oPositions[i] = static_cast<int>((static_cast<int64_t>(2 * i + 1) * extent) / (2 * count));
+    }
+}
+
+
+char *LumaThumbnail(const cv::Mat &iImg, uint8_t oThumb[MOTION_THUMB_PIXELS]) {
+    if (iImg.empty() || iImg.depth() != CV_8U) {
+        return "[DCSP_ONNX]:Motion gate expects a non-empty 8-bit image.";
+    }
+    int channels = iImg.channels();
+    if (channels != 1 && channels != 3 && channels != 4) {
+        return "[DCSP_ONNX]:Motion gate expects 1, 3 or 4 channels.";
+    }
+    int xs[SAMPLE_COLUMNS];
+    int ys[SAMPLE_ROWS];
+    SamplePositions(iImg.cols, SAMPLE_COLUMNS, xs);
+    SamplePositions(iImg.rows, SAMPLE_ROWS, ys);
+    for (int ty = 0; ty < MOTION_THUMB_HEIGHT; ty++) {
+        uint32_t sums[MOTION_THUMB_WIDTH] = {};
+        for (int sy = 0; sy < CELL_SAMPLES; sy++) {
+            const uint8_t *row = iImg.ptr<uint8_t>(ys[ty * CELL_SAMPLES + sy]);
+            for (int s = 0; s < SAMPLE_COLUMNS; s++) {
+                const uint8_t *pixel = row + xs[s] * channels;
+                // BT.601 weights in 8-bit fixed point, BGR order.
+                uint32_t luma = channels == 1 ? pixel[0] : (29 * pixel[0] + 150 * pixel[1] + 77 * pixel[2] + 128) >> 8;
+                sums[s / CELL_SAMPLES] += luma;
+            }
+        }
+        for (int tx = 0; tx < MOTION_THUMB_WIDTH; tx++) {
+            oThumb[ty * MOTION_THUMB_WIDTH + tx] = static_cast<uint8_t>((sums[tx] + 8) >> 4);
+        }
+    }
+    return RET_OK;
+}
+
+
+char *LumaThumbnail(const YUV_IMAGE &iImg, uint8_t oThumb[MOTION_THUMB_PIXELS]) {
+    if (iImg.y == nullptr || iImg.width <= 0 || iImg.height <= 0) {
+        return "[DCSP_ONNX]:Motion gate expects a non-empty YUV 4:2:0 image.";
+    }
+    int xs[SAMPLE_COLUMNS];
+    int ys[SAMPLE_ROWS];
+    SamplePositions(iImg.width, SAMPLE_COLUMNS, xs);
+    SamplePositions(iImg.height, SAMPLE_ROWS, ys);
+    for (int ty = 0; ty < MOTION_THUMB_HEIGHT; ty++) {
+        uint32_t sums[MOTION_THUMB_WIDTH] = {};
+        for (int sy = 0; sy < CELL_SAMPLES; sy++) {
+            const uint8_t *row = iImg.y + static_cast<size_t>(ys[ty * CELL_SAMPLES + sy]) * iImg.yRowStride;
+            for (int s = 0; s < SAMPLE_COLUMNS; s++) {
+                sums[s / CELL_SAMPLES] += row[xs[s]];
+            }
+        }
+        for (int tx = 0; tx < MOTION_THUMB_WIDTH; tx++) {
+            oThumb[ty * MOTION_THUMB_WIDTH + tx] = static_cast<uint8_t>((sums[tx] + 8) >> 4);
+        }
+    }
+    return RET_OK;
+}
+
+
+uint32_t SumAbsDiff(const uint8_t *a, const uint8_t *b, int n) {
+    uint32_t total = 0;
+    int i = 0;
+#if defined(DCSP_SIMD_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        // psadbw: two 64-bit partial sums of 8 absolute differences each.
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+    total = static_cast<uint32_t>(_mm_cvtsi128_si32(acc)) +
+            static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(acc, acc)));
+#elif defined(DCSP_SIMD_NEON)
+    uint32x4_t acc32 = vdupq_n_u32(0);
+    while (i + 16 <= n) {
+        // Each 16-bit lane gains at most 2 * 255 per block, so widen before 128 blocks.
+        uint16x8_t acc16 = vdupq_n_u16(0);
+        for (int block = 0; block < 64 && i + 16 <= n; block++, i += 16) {
+            acc16 = vpadalq_u8(acc16, vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+        }
+        acc32 = vpadalq_u16(acc32, acc16);
+    }
+#if defined(__aarch64__)
+    total = vaddvq_u32(acc32);
+#else
+    uint64x2_t acc64 = vpaddlq_u32(acc32);
+    total = static_cast<uint32_t>(vgetq_lane_u64(acc64, 0) + vgetq_lane_u64(acc64, 1));
+#endif
+#endif
+    for (; i < n; i++) {
+        total += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+    }
+    return total;
+}
+
+
+void GetMotionGateStats(MOTION_GATE_STATS &oStats, bool reset) {
+    oStats.checked = reset ? gChecked.exchange(0, std::memory_order_relaxed) : gChecked.load(std::memory_order_relaxed);
+    oStats.skipped = reset ? gSkipped.exchange(0, std::memory_order_relaxed) : gSkipped.load(std::memory_order_relaxed);
+    oStats.lastDifference = gLastDifference.load(std::memory_order_relaxed);
+}
+
+
+MotionGate::MotionGate(const MOTION_GATE_PARAM &iParam) : param(iParam) {}
+
+
+void MotionGate::SetParam(const MOTION_GATE_PARAM &iParam) {
+    if (iParam.threshold != param.threshold) {
+        Reset();
+    }
+    param = iParam;
+}
+
+
+void MotionGate::Reset() {
+    hasReference = false;
+    hasCurrent = false;
+    skippedInRow = 0;
+    lastDifference = 0.f;
+    cached.clear();
+}
+
+
+bool MotionGate::NeedsInference(const cv::Mat &iImg) {
+    if (!Enabled()) {
+        return true;
+    }
+    PerfTimer timer(PERF_MOTION);
+    return Decide(iImg.cols, iImg.rows, LumaThumbnail(iImg, current) == RET_OK);
+}
+
+
+bool MotionGate::NeedsInference(const YUV_IMAGE &iImg) {
+    if (!Enabled()) {
+        return true;
+    }
+    PerfTimer timer(PERF_MOTION);
+    return Decide(iImg.width, iImg.height, LumaThumbnail(iImg, current) == RET_OK);
+}
+
+
+bool MotionGate::Decide(int width, int height, bool thumbnailOk) {
+    hasCurrent = thumbnailOk;
+    currentWidth = width;
+    currentHeight = height;
+    gChecked.fetch_add(1, std::memory_order_relaxed);
+    if (!thumbnailOk || !hasReference || width != referenceWidth || height != referenceHeight) {
+        skippedInRow = 0;
+        return true;
+    }
+    lastDifference = static_cast<float>(SumAbsDiff(reference, current, MOTION_THUMB_PIXELS)) / MOTION_THUMB_PIXELS;
+    gLastDifference.store(lastDifference, std::memory_order_relaxed);
+    bool skip = lastDifference < param.threshold &&
+                (param.maxSkipFrames <= 0 || skippedInRow < param.maxSkipFrames);
+    if (!skip) {
+        skippedInRow = 0;
+        return true;
+    }
+    skippedInRow++;
+    gSkipped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+
+void MotionGate::Commit(const std::vector<DCSP_RESULT> &iResults) {
+    if (!hasCurrent) {
+        return;
+    }
+    std::memcpy(reference, current, MOTION_THUMB_PIXELS);
+    referenceWidth = currentWidth;
+    referenceHeight = currentHeight;
+    hasReference = true;
+    hasCurrent = false;
+    // Same capacity frame after frame, so this stops allocating once warm.
+    cached.assign(iResults.begin(), iResults.end());
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <cstdint>
+#include <vector>
+#include "Inference.h"
+#include "Preprocess.h"
+
+
+// 16:9 luma thumbnail the gate compares; 2304 bytes, i.e. 144 SIMD registers.
+constexpr int MOTION_THUMB_WIDTH = 64;
+constexpr int MOTION_THUMB_HEIGHT = 36;
+constexpr int MOTION_THUMB_PIXELS = MOTION_THUMB_WIDTH * MOTION_THUMB_HEIGHT;
+
+
+typedef struct _MOTION_GATE_PARAM {
+    // Mean absolute luma difference (0-255 per thumbnail pixel) against the last inferred frame
+    // below which inference is skipped and the cached detections are returned. 0 disables the gate.
+    // Sensor noise mostly averages out in the thumbnail; 2-4 suits a static indoor camera.
+    float threshold = 0.f;
+    // Run the model anyway after this many consecutive skipped frames, so lighting drift or a
+    // slow object that stays under the threshold cannot freeze the output. 0 = never force.
+    int maxSkipFrames = 30;
+} MOTION_GATE_PARAM;
+
+
+typedef struct _MOTION_GATE_STATS {
+    // Frames the gate was asked about, and how many of them skipped inference.
+    uint64_t checked = 0;
+    uint64_t skipped = 0;
+    // Difference of the most recent check, in the units of MOTION_GATE_PARAM::threshold.
+    float lastDifference = 0.f;
+} MOTION_GATE_STATS;
+
+
+// Skips inference on frames that look like the last inferred one. Each frame is reduced to a
+// MOTION_THUMB_WIDTH x MOTION_THUMB_HEIGHT luma thumbnail (4x4 samples averaged per cell) and
+// compared with a SIMD sum of absolute differences; the check costs a few microseconds against a
+// full model run. The reference only moves on inferred frames, so slow changes accumulate until
+// they cross the threshold. Not thread-safe; one gate per stream.
+class MotionGate {
+public:
+    explicit MotionGate(const MOTION_GATE_PARAM &iParam = MOTION_GATE_PARAM());
+
+    // Drops the reference when the threshold changes.
+    void SetParam(const MOTION_GATE_PARAM &iParam);
+
+    const MOTION_GATE_PARAM &Param() const { return param; }
+
+    bool Enabled() const { return param.threshold > 0.f; }
+
+    // True when the frame has to go through the model; false means Cached() is still valid for it.
+    // The thumbnail is kept for Commit. Always true while disabled, before the first Commit, after
+    // the frame size changed and for pixel formats the gate cannot read.
+    bool NeedsInference(const cv::Mat &iImg);
+
+    bool NeedsInference(const YUV_IMAGE &iImg);
+
+    // Makes the frame last passed to NeedsInference the new reference, with its detections.
+    void Commit(const std::vector<DCSP_RESULT> &iResults);
+
+    const std::vector<DCSP_RESULT> &Cached() const { return cached; }
+
+    float LastDifference() const { return lastDifference; }
+
+    // Forgets the reference, e.g. when the model or thresholds the cached detections came from change.
+    void Reset();
+
+private:
+    bool Decide(int width, int height, bool thumbnailOk);
+
+    MOTION_GATE_PARAM param;
+    uint8_t reference[MOTION_THUMB_PIXELS];
+    uint8_t current[MOTION_THUMB_PIXELS];
+    int referenceWidth = 0;
+    int referenceHeight = 0;
+    int currentWidth = 0;
+    int currentHeight = 0;
+    bool hasReference = false;
+    bool hasCurrent = false;
+    int skippedInRow = 0;
+    float lastDifference = 0.f;
+    std::vector<DCSP_RESULT> cached;
+};
+
+
+// Box-filtered luma thumbnail of a CV_8UC1 / CV_8UC3 (BGR) / CV_8UC4 (BGRA) image.
+char *LumaThumbnail(const cv::Mat &iImg, uint8_t oThumb[MOTION_THUMB_PIXELS]);
+
+// Same from the Y plane of a 4:2:0 frame; chroma is not read.
+char *LumaThumbnail(const YUV_IMAGE &iImg, uint8_t oThumb[MOTION_THUMB_PIXELS]);
+
+// Sum of |a[i] - b[i]| (SIMD on SSE2 / NEON).
+uint32_t SumAbsDiff(const uint8_t *a, const uint8_t *b, int n);
+
+
+// Gate decisions of every MotionGate in the process; the cost of each check is recorded in the
+// PERF_MOTION stage. With reset the counters are cleared as they are read.
+void GetMotionGateStats(MOTION_GATE_STATS &oStats, bool reset);
@@ -0,0 +1,178 @@
+#include "Nms.h"
+#include <algorithm>
+#include <cmath>
+
+
+float BoxIou(const DCSP_CANDIDATE &a, const DCSP_CANDIDATE &b) {
+    float ix = std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x);
+    float iy = std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y);
+    if (ix <= 0.f || iy <= 0.f) {
+        return 0.f;
+    }
+    float inter = ix * iy;
+    float unionArea = a.width * a.height + b.width * b.height - inter;
+    return unionArea > 0.f ? inter / unionArea : 0.f;
+}
+
+
+void NmsEngine::SelectTopK(const std::vector<DCSP_CANDIDATE> &candidates, int topK) {
+    int n = static_cast<int>(candidates.size());
+    order.resize(n);
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    auto byScore = [&candidates](int a, int b) {
+        float sa = candidates[a].confidence;
+        float sb = candidates[b].confidence;
+        return sa > sb || (sa == sb && a < b);
+    };
+    int k = topK > 0 ? std::min(topK, n) : n;
+    std::partial_sort(order.begin(), order.begin() + k, order.end(), byScore);
+    order.resize(k);
+}
+
+
+bool NmsEngine::Suppressed(int keptIndex, float x1, float y1, float x2, float y2, float area, int classId,
+                           const NMS_PARAM &param) const {
+    if (param.classAware && keptClass[keptIndex] != classId) {
+        return false;
+    }
+    float ix = std::min(x2, keptX2[keptIndex]) - std::max(x1, keptX1[keptIndex]);
+    float iy = std::min(y2, keptY2[keptIndex]) - std::max(y1, keptY1[keptIndex]);
+    if (ix <= 0.f || iy <= 0.f) {
+        return false;
+    }
+    float inter = ix * iy;
+    float unionArea = area + keptArea[keptIndex] - inter;
+    return unionArea > 0.f && inter > param.iouThreshold * unionArea;
+}
+
+
+void NmsEngine::AddKept(const DCSP_CANDIDATE &candidate) {
+    keptX1.push_back(candidate.x);
+    keptY1.push_back(candidate.y);
+    keptX2.push_back(candidate.x + candidate.width);
+    keptY2.push_back(candidate.y + candidate.height);
+    keptArea.push_back(candidate.width * candidate.height);
+    keptClass.push_back(candidate.classId);
+}
+
+
+void NmsEngine::RunLinear(const std::vector<DCSP_CANDIDATE> &candidates, const NMS_PARAM &param,
+                          std::vector<int> &oKeep) {
+    for (int idx: order) {
+        const DCSP_CANDIDATE &c = candidates[idx];
+        float x2 = c.x + c.width;
+        float y2 = c.y + c.height;
+        float area = c.width * c.height;
+        bool suppressed = false;
+        int kept = static_cast<int>(keptX1.size());
+        for (int j = 0; j < kept && !suppressed; j++) {
+            suppressed = Suppressed(j, c.x, c.y, x2, y2, area, c.classId, param);
+        }
+        if (suppressed) {
+            continue;
+        }
+        AddKept(c);
+        oKeep.push_back(idx);
+        if (param.maxDetections > 0 && static_cast<int>(oKeep.size()) >= param.maxDetections) {
+            break;
+        }
+    }
+}
+
+
+void NmsEngine::RunGrid(const std::vector<DCSP_CANDIDATE> &candidates, const NMS_PARAM &param,
+                        std::vector<int> &oKeep) {
+    float minX = candidates[order[0]].x;
+    float minY = candidates[order[0]].y;
+    float maxX = minX;
+    float maxY = minY;
+    double sizeSum = 0.0;
+    for (int idx: order) {
+        const DCSP_CANDIDATE &c = candidates[idx];
+        minX = std::min(minX, c.x);
+        minY = std::min(minY, c.y);
+        maxX = std::max(maxX, c.x + c.width);
+        maxY = std::max(maxY, c.y + c.height);
+        sizeSum += 0.5 * (c.width + c.height);
+    }
+    // Cells about one average box wide keep both the per-box cell count and the per-cell list
+    // length small; the 64x64 cap bounds the cost of resetting the grid each frame.
+    float extent = std::max(maxX - minX, maxY - minY);
+    cellSize = std::max({static_cast<float>(sizeSum / order.size()), extent / 64.f, 1.f});
+    gridOriginX = minX;
+    gridOriginY = minY;
+    gridCols = static_cast<int>((maxX - minX) / cellSize) + 1;
+    gridRows = static_cast<int>((maxY - minY) / cellSize) + 1;
+    cellHead.assign(static_cast<size_t>(gridCols) * gridRows, -1);
+    entryNext.clear();
+    entryBox.clear();
+
+    auto cellRange = [&](float x1, float y1, float x2, float y2, int &cx0, int &cy0, int &cx1, int &cy1) {
+        cx0 = std::clamp(static_cast<int>((x1 - gridOriginX) / cellSize), 0, gridCols - 1);
+        cy0 = std::clamp(static_cast<int>((y1 - gridOriginY) / cellSize), 0, gridRows - 1);
+        cx1 = std::clamp(static_cast<int>((x2 - gridOriginX) / cellSize), 0, gridCols - 1);
+        cy1 = std::clamp(static_cast<int>((y2 - gridOriginY) / cellSize), 0, gridRows - 1);
+    };
+
+    for (int idx: order) {
+        const DCSP_CANDIDATE &c = candidates[idx];
+        float x2 = c.x + c.width;
+        float y2 = c.y + c.height;
+        float area = c.width * c.height;
+        int cx0, cy0, cx1, cy1;
+        cellRange(c.x, c.y, x2, y2, cx0, cy0, cx1, cy1);
+
+        // Overlapping boxes always share a cell, so only the covered cells need checking.
+        bool suppressed = false;
+        for (int cy = cy0; cy <= cy1 && !suppressed; cy++) {
+            for (int cx = cx0; cx <= cx1 && !suppressed; cx++) {
+                for (int e = cellHead[cy * gridCols + cx]; e >= 0 && !suppressed; e = entryNext[e]) {
+                    suppressed = Suppressed(entryBox[e], c.x, c.y, x2, y2, area, c.classId, param);
+                }
+            }
+        }
+        if (suppressed) {
+            continue;
+        }
+
+        int kept = static_cast<int>(keptX1.size());
+        AddKept(c);
+        oKeep.push_back(idx);
+        if (param.maxDetections > 0 && static_cast<int>(oKeep.size()) >= param.maxDetections) {
+            break;
+        }
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                int cell = cy * gridCols + cx;
+                entryNext.push_back(cellHead[cell]);
+                entryBox.push_back(kept);
+                cellHead[cell] = static_cast<int>(entryBox.size()) - 1;
+            }
+        }
+    }
+}
+
+
+char *NmsEngine::Run(const std::vector<DCSP_CANDIDATE> &candidates, const NMS_PARAM &param,
+                     std::vector<int> &oKeep) {
+    oKeep.clear();
+    keptX1.clear();
+    keptY1.clear();
+    keptX2.clear();
+    keptY2.clear();
+    keptArea.clear();
+    keptClass.clear();
+    if (candidates.empty()) {
+        return RET_OK;
+    }
+
+    SelectTopK(candidates, param.topK);
+    if (static_cast<int>(order.size()) >= NMS_GRID_MIN_CANDIDATES) {
+        RunGrid(candidates, param, oKeep);
+    } else {
+        RunLinear(candidates, param, oKeep);
+    }
+    return RET_OK;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <vector>
+#include "YoloDecode.h"
+
+
+typedef struct _NMS_PARAM {
+    float iouThreshold = 0.5f;
+    // Highest-scoring candidates considered for suppression, <= 0 keeps all of them.
+    int topK = 1000;
+    // Upper bound on returned detections, <= 0 means unlimited.
+    int maxDetections = 300;
+    // Only boxes of the same class suppress each other.
+    bool classAware = true;
+} NMS_PARAM;
+
+
+// Above this many candidates kept boxes are indexed in a uniform grid, so each candidate is
+// only tested against kept boxes in the cells it overlaps instead of all of them.
+constexpr int NMS_GRID_MIN_CANDIDATES = 256;
+
+
+// Greedy non-maximum suppression on float boxes. Scratch buffers live in the engine and are
+// reused across frames, so steady-state calls do not allocate.
+class NmsEngine {
+public:
+    // Writes the indices of the surviving candidates into oKeep, highest confidence first.
+    char *Run(const std::vector<DCSP_CANDIDATE> &candidates, const NMS_PARAM &param, std::vector<int> &oKeep);
+
+private:
+    void SelectTopK(const std::vector<DCSP_CANDIDATE> &candidates, int topK);
+
+    void RunLinear(const std::vector<DCSP_CANDIDATE> &candidates, const NMS_PARAM &param, std::vector<int> &oKeep);
+
+    void RunGrid(const std::vector<DCSP_CANDIDATE> &candidates, const NMS_PARAM &param, std::vector<int> &oKeep);
+
+    bool Suppressed(int keptIndex, float x1, float y1, float x2, float y2, float area, int classId,
+                    const NMS_PARAM &param) const;
+
+    void AddKept(const DCSP_CANDIDATE &candidate);
+
+    std::vector<int> order;
+
+    // Kept boxes, structure-of-arrays.
+    std::vector<float> keptX1;
+    std::vector<float> keptY1;
+    std::vector<float> keptX2;
+    std::vector<float> keptY2;
+    std::vector<float> keptArea;
+    std::vector<int> keptClass;
+
+    // Grid index: per-cell singly linked lists of kept box indices.
+    std::vector<int> cellHead;
+    std::vector<int> entryNext;
+    std::vector<int> entryBox;
+    float gridOriginX = 0.f;
+    float gridOriginY = 0.f;
+    float cellSize = 1.f;
+    int gridCols = 0;
+    int gridRows = 0;
+};
+
+
+// Intersection over union of two float boxes given as (x, y, width, height).
+float BoxIou(const DCSP_CANDIDATE &a, const DCSP_CANDIDATE &b);
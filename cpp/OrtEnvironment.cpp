@@ -0,0 +1,54 @@
+#include "OrtEnvironment.h"
+#include "TensorPool.h"
+#include "Log.h"
+
+
+static std::mutex gEnvironmentMutex;
+static ORT_ENV_PARAM gPendingParam;
+static bool gEnvironmentCreated = false;
+
+
+OrtEnvironment &OrtEnvironment::Instance() {
+    static OrtEnvironment *instance = [] {
+        std::lock_guard<std::mutex> lock(gEnvironmentMutex);
+        gEnvironmentCreated = true;
+        // Leaked on purpose: sessions may still be torn down from static destructors.
+        return new OrtEnvironment(gPendingParam);
+    }();
+    return *instance;
+}
+
+
+char *OrtEnvironment::Configure(const ORT_ENV_PARAM &iParams) {
+    std::lock_guard<std::mutex> lock(gEnvironmentMutex);
+    if (gEnvironmentCreated) {
+        return "[DCSP_ONNX]:ORT environment already created, thread pools can no longer be changed.";
+    }
+    gPendingParam = iParams;
+    return RET_OK;
+}
+
+
+Ort::Env OrtEnvironment::CreateEnv(const ORT_ENV_PARAM &iParams) {
+    Ort::ThreadingOptions threading;
+    threading.SetGlobalIntraOpNumThreads(iParams.IntraOpNumThreads);
+    threading.SetGlobalInterOpNumThreads(iParams.InterOpNumThreads);
+    threading.SetGlobalSpinControl(iParams.AllowSpinning ? 1 : 0);
+    if (!iParams.IntraOpAffinity.empty()) {
+        threading.SetGlobalIntraOpThreadAffinity(iParams.IntraOpAffinity.c_str());
+    }
+    return Ort::Env(threading, iParams.LogLevel, "Yolo");
+}
+
+
+OrtEnvironment::OrtEnvironment(const ORT_ENV_PARAM &iParams)
+        : param(iParams), env(CreateEnv(iParams)) {
+    if (param.UseTensorPool) {
+        try {
+            env.RegisterAllocator(TensorPool::Shared().OrtHandle());
+            tensorPoolRegistered = true;
+        } catch (const Ort::Exception &e) {
+            DCSP_LOGW("DCSP_ONNX", "Tensor pool not registered, sessions keep ORT's own arena: %s", e.what());
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <mutex>
+#include <string>
+#include "onnxruntime_cxx_api.h"
+
+
+typedef struct _ORT_ENV_PARAM {
+    // Sizes of the process-wide pools every session with UseGlobalThreadPools runs on.
+    int IntraOpNumThreads = 2;
+    int InterOpNumThreads = 1;
+    bool AllowSpinning = false;
+    // See IntraOpAffinityString, empty leaves placement to the scheduler.
+    std::string IntraOpAffinity;
+    OrtLoggingLevel LogLevel = ORT_LOGGING_LEVEL_WARNING;
+    // Register TensorPool as the environment's CPU allocator.
+    bool UseTensorPool = true;
+} ORT_ENV_PARAM;
+
+
+// The one Ort::Env of the process. It owns the global intra/inter-op thread pools, so N sessions
+// share one set of worker threads instead of spawning N, and a PrepackedWeightsContainer, so
+// sessions over the same weights (several streams, several input sizes of one model) prepack
+// them once.
+class OrtEnvironment {
+public:
+    static OrtEnvironment &Instance();
+
+    // Only effective before the first Instance() call; the pools cannot be resized afterwards.
+    static char *Configure(const ORT_ENV_PARAM &iParams);
+
+    Ort::Env &Env() { return env; }
+
+    Ort::PrepackedWeightsContainer &PrepackedWeights() { return prepackedWeights; }
+
+    const ORT_ENV_PARAM &Param() const { return param; }
+
+    // Sessions opt in with "session.use_env_allocators" (see DCSP_INIT_PARAM::UseTensorPool).
+    bool TensorPoolRegistered() const { return tensorPoolRegistered; }
+
+private:
+    explicit OrtEnvironment(const ORT_ENV_PARAM &iParams);
+
+    static Ort::Env CreateEnv(const ORT_ENV_PARAM &iParams);
+
+    ORT_ENV_PARAM param;
+    Ort::Env env;
+    Ort::PrepackedWeightsContainer prepackedWeights;
+    bool tensorPoolRegistered = false;
+};
@@ -0,0 +1,120 @@
+#include "PerfStats.h"
+#include <algorithm>
+#include <bit>
+
+
+typedef struct _PERF_HISTOGRAM {
+    std::atomic<uint64_t> buckets[PERF_BUCKET_COUNT];
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+} PERF_HISTOGRAM;
+
+
+// Zero-initialized static storage, no constructor runs before the first sample.
+static PERF_HISTOGRAM gHistograms[PERF_STAGE_COUNT];
+
+
+const char *PerfStageName(PERF_STAGE stage) {
+    switch (stage) {
+        case PERF_PREPROCESS:
+            return "preprocess";
+        case PERF_INFERENCE:
+            return "inference";
+        case PERF_DECODE:
+            return "decode";
+        case PERF_NMS:
+            return "nms";
+        case PERF_MARSHAL:
+            return "marshal";
+        case PERF_MOTION:
+            return "motion";
+        case PERF_STAGE_COUNT:
+            break;
+    }
+    return "unknown";
+}
+
+
+void SetPerfStatsEnabled(bool enabled) {
+    PerfEnabledFlag().store(enabled, std::memory_order_relaxed);
+}
+
+
+static int BucketIndex(uint64_t value) {
+    if (value < PERF_SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+    int exponent = static_cast<int>(std::bit_width(value)) - 1;
+    if (exponent > PERF_MAX_EXPONENT) {
+        return PERF_BUCKET_COUNT - 1;
+    }
+    int subBucket = static_cast<int>((value >> (exponent - 4)) & (PERF_SUB_BUCKETS - 1));
+    return (exponent - 3) * PERF_SUB_BUCKETS + subBucket;
+}
+
+
+// Midpoint of the bucket's value range.
+static double BucketValue(int index) {
+    if (index < PERF_SUB_BUCKETS) {
+        return index;
+    }
+    int exponent = index / PERF_SUB_BUCKETS + 3;
+    uint64_t width = uint64_t(1) << (exponent - 4);
+    uint64_t lower = static_cast<uint64_t>(PERF_SUB_BUCKETS + index % PERF_SUB_BUCKETS) * width;
+    return static_cast<double>(lower) + 0.5 * static_cast<double>(width);
+}
+
+
+void PerfRecord(PERF_STAGE stage, uint64_t nanoseconds) {
+    PERF_HISTOGRAM &histogram = gHistograms[stage];
+    histogram.buckets[BucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    histogram.sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    uint64_t previous = histogram.max.load(std::memory_order_relaxed);
+    while (nanoseconds > previous &&
+           !histogram.max.compare_exchange_weak(previous, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+
+static double Percentile(const uint64_t *counts, uint64_t total, double fraction) {
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5));
+    uint64_t seen = 0;
+    for (int i = 0; i < PERF_BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return BucketValue(i);
+        }
+    }
+    return BucketValue(PERF_BUCKET_COUNT - 1);
+}
+
+
+void GetPerfStats(PERF_STAGE_STATS oStats[PERF_STAGE_COUNT], bool reset) {
+    uint64_t counts[PERF_BUCKET_COUNT];
+    for (int stage = 0; stage < PERF_STAGE_COUNT; stage++) {
+        PERF_HISTOGRAM &histogram = gHistograms[stage];
+        uint64_t total = 0;
+        for (int i = 0; i < PERF_BUCKET_COUNT; i++) {
+            counts[i] = reset ? histogram.buckets[i].exchange(0, std::memory_order_relaxed)
+                              : histogram.buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        uint64_t sum = reset ? histogram.sum.exchange(0, std::memory_order_relaxed)
+                             : histogram.sum.load(std::memory_order_relaxed);
+        uint64_t max = reset ? histogram.max.exchange(0, std::memory_order_relaxed)
+                             : histogram.max.load(std::memory_order_relaxed);
+
+        PERF_STAGE_STATS stats;
+        stats.count = total;
+        if (total > 0) {
+            // Percentiles come from bucket midpoints, so clamp them to the exact maximum.
+            double maxMs = max / 1e6;
+            stats.meanMs = static_cast<double>(sum) / total / 1e6;
+            stats.p50Ms = std::min(Percentile(counts, total, 0.50) / 1e6, maxMs);
+            stats.p95Ms = std::min(Percentile(counts, total, 0.95) / 1e6, maxMs);
+            stats.p99Ms = std::min(Percentile(counts, total, 0.99) / 1e6, maxMs);
+            stats.maxMs = maxMs;
+        }
+        oStats[stage] = stats;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+
+enum PERF_STAGE {
+    PERF_PREPROCESS = 0,
+    PERF_INFERENCE = 1,
+    PERF_DECODE = 2,
+    PERF_NMS = 3,
+    // Converting results to JS values.
+    PERF_MARSHAL = 4,
+    // MotionGate check: luma thumbnail plus SAD against the reference.
+    PERF_MOTION = 5,
+    PERF_STAGE_COUNT = 6
+};
+
+
+// Log-linear buckets: values below 16 ns are exact, above that every power of two is split into
+// 16 sub-buckets (~6% relative error) up to 2^36 ns (~68 s); longer samples land in the last bucket.
+constexpr int PERF_SUB_BUCKETS = 16;
+constexpr int PERF_MAX_EXPONENT = 35;
+constexpr int PERF_BUCKET_COUNT = (PERF_MAX_EXPONENT - 2) * PERF_SUB_BUCKETS;
+
+
+typedef struct _PERF_STAGE_STATS {
+    uint64_t count = 0;
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+} PERF_STAGE_STATS;
+
+
+const char *PerfStageName(PERF_STAGE stage);
+
+// Off by default; while off PerfTimer does not read the clock.
+void SetPerfStatsEnabled(bool enabled);
+
+inline std::atomic<bool> &PerfEnabledFlag() {
+    static std::atomic<bool> enabled{false};
+    return enabled;
+}
+
+inline bool PerfStatsEnabled() {
+    return PerfEnabledFlag().load(std::memory_order_relaxed);
+}
+
+inline uint64_t PerfNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Wait-free: one relaxed fetch_add per counter, callable from any thread.
+void PerfRecord(PERF_STAGE stage, uint64_t nanoseconds);
+
+// Percentiles of every stage since the last reset. With reset the buckets are drained atomically
+// as they are read, so samples recorded concurrently go to exactly one snapshot.
+void GetPerfStats(PERF_STAGE_STATS oStats[PERF_STAGE_COUNT], bool reset);
+
+
+// Records the time from construction to Stop() (or destruction) into stage.
+class PerfTimer {
+public:
+    explicit PerfTimer(PERF_STAGE stage) : stage(stage), start(PerfStatsEnabled() ? PerfNow() : 0) {}
+
+    ~PerfTimer() { Stop(); }
+
+    PerfTimer(const PerfTimer &) = delete;
+
+    PerfTimer &operator=(const PerfTimer &) = delete;
+
+    void Stop() {
+        if (start != 0) {
+            PerfRecord(stage, PerfNow() - start);
+            start = 0;
+        }
+    }
+
+    void Cancel() { start = 0; }
+
+private:
+    PERF_STAGE stage;
+    uint64_t start;
+};
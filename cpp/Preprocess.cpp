@@ -0,0 +1,353 @@
+#include "Preprocess.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+
+LETTERBOX_INFO ComputeLetterbox(int srcWidth, int srcHeight, int dstWidth, int dstHeight) {
+    LETTERBOX_INFO info;
+    float scale = std::min(static_cast<float>(dstWidth) / srcWidth, static_cast<float>(dstHeight) / srcHeight);
+    int resizedWidth = std::clamp(static_cast<int>(std::lround(srcWidth * scale)), 1, dstWidth);
+    int resizedHeight = std::clamp(static_cast<int>(std::lround(srcHeight * scale)), 1, dstHeight);
+    info.scaleX = static_cast<float>(resizedWidth) / srcWidth;
+    info.scaleY = static_cast<float>(resizedHeight) / srcHeight;
+    info.padX = static_cast<float>((dstWidth - resizedWidth) / 2);
+    info.padY = static_cast<float>((dstHeight - resizedHeight) / 2);
+    return info;
+}
+
+
+bool PreprocessWorkspace::matches(int srcWidth, int srcHeight, int srcChannels, int dstWidth, int dstHeight) const {
+    return srcWidth == srcWidth_ && srcHeight == srcHeight_ && srcChannels == srcChannels_ &&
+           dstWidth == dstWidth_ && dstHeight == dstHeight_;
+}
+
+
+// Bilinear source taps with half-pixel centers, the same convention as cv::resize(INTER_LINEAR).
+static void BuildTaps(int srcLength, int dstLength, int stride, std::vector<int> &ofs0, std::vector<int> &ofs1,
+                      std::vector<float> &alpha) {
+    ofs0.resize(dstLength);
+    ofs1.resize(dstLength);
+    alpha.resize(dstLength);
+    float ratio = static_cast<float>(srcLength) / dstLength;
+    for (int d = 0; d < dstLength; d++) {
+        float s = std::clamp((d + 0.5f) * ratio - 0.5f, 0.f, static_cast<float>(srcLength - 1));
+        int s0 = static_cast<int>(s);
+        int s1 = std::min(s0 + 1, srcLength - 1);
+        ofs0[d] = s0 * stride;
+        ofs1[d] = s1 * stride;
+        alpha[d] = s - s0;
+    }
+}
+
+
+void PreprocessWorkspace::prepare(int srcWidth, int srcHeight, int srcChannels, int dstWidth, int dstHeight) {
+    letterbox = ComputeLetterbox(srcWidth, srcHeight, dstWidth, dstHeight);
+    resizedWidth = static_cast<int>(std::lround(srcWidth * letterbox.scaleX));
+    resizedHeight = static_cast<int>(std::lround(srcHeight * letterbox.scaleY));
+    offsetX = static_cast<int>(letterbox.padX);
+    offsetY = static_cast<int>(letterbox.padY);
+
+    BuildTaps(srcWidth, resizedWidth, srcChannels, xOfs0, xOfs1, xAlpha);
+    BuildTaps(srcHeight, resizedHeight, 1, yOfs0, yOfs1, yAlpha);
+
+    rows.assign(static_cast<size_t>(2) * 3 * resizedWidth, 0.f);
+    cachedRow[0] = cachedRow[1] = -1;
+    yuvRow.assign(static_cast<size_t>(3) * resizedWidth, 0.f);
+
+    srcWidth_ = srcWidth;
+    srcHeight_ = srcHeight;
+    srcChannels_ = srcChannels;
+    dstWidth_ = dstWidth;
+    dstHeight_ = dstHeight;
+}
+
+
+void BlendRows(const float *a, const float *b, float wa, float wb, float *dst, int n) {
+    int i = 0;
+#if defined(DCSP_SIMD_AVX2)
+    __m256 va8 = _mm256_set1_ps(wa);
+    __m256 vb8 = _mm256_set1_ps(wb);
+    for (; i + 8 <= n; i += 8) {
+        __m256 r = _mm256_mul_ps(_mm256_loadu_ps(a + i), va8);
+        _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(b + i), vb8, r));
+    }
+#endif
+#if defined(DCSP_SIMD_SSE2)
+    __m128 va4 = _mm_set1_ps(wa);
+    __m128 vb4 = _mm_set1_ps(wb);
+    for (; i + 4 <= n; i += 4) {
+        __m128 r = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + i), va4), _mm_mul_ps(_mm_loadu_ps(b + i), vb4));
+        _mm_storeu_ps(dst + i, r);
+    }
+#elif defined(DCSP_SIMD_NEON)
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t r = vmulq_n_f32(vld1q_f32(a + i), wa);
+        vst1q_f32(dst + i, vmlaq_n_f32(r, vld1q_f32(b + i), wb));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = a[i] * wa + b[i] * wb;
+    }
+}
+
+
+// Horizontal pass for one source row: interleaved BGR(A)/gray bytes -> planar R, G, B floats in [0,255].
+static void ResampleRow(const uint8_t *src, int channels, const PreprocessWorkspace &ws, float *r, float *g,
+                        float *b) {
+    const int *ofs0 = ws.xOfs0.data();
+    const int *ofs1 = ws.xOfs1.data();
+    const float *alpha = ws.xAlpha.data();
+    int n = ws.resizedWidth;
+    if (channels == 1) {
+        for (int x = 0; x < n; x++) {
+            float p0 = src[ofs0[x]];
+            float v = p0 + (src[ofs1[x]] - p0) * alpha[x];
+            r[x] = v;
+            g[x] = v;
+            b[x] = v;
+        }
+        return;
+    }
+    for (int x = 0; x < n; x++) {
+        const uint8_t *p0 = src + ofs0[x];
+        const uint8_t *p1 = src + ofs1[x];
+        float a = alpha[x];
+        b[x] = p0[0] + (p1[0] - p0[0]) * a;
+        g[x] = p0[1] + (p1[1] - p0[1]) * a;
+        r[x] = p0[2] + (p1[2] - p0[2]) * a;
+    }
+}
+
+
+static void FillBorder(float *plane, int dstWidth, int dstHeight, const PreprocessWorkspace &ws) {
+    float *end = plane + static_cast<size_t>(dstWidth) * dstHeight;
+    std::fill(plane, plane + static_cast<size_t>(ws.offsetY) * dstWidth, LETTERBOX_PAD_VALUE);
+    std::fill(plane + static_cast<size_t>(ws.offsetY + ws.resizedHeight) * dstWidth, end, LETTERBOX_PAD_VALUE);
+    int right = dstWidth - ws.offsetX - ws.resizedWidth;
+    if (ws.offsetX == 0 && right == 0) {
+        return;
+    }
+    for (int y = ws.offsetY; y < ws.offsetY + ws.resizedHeight; y++) {
+        float *row = plane + static_cast<size_t>(y) * dstWidth;
+        std::fill(row, row + ws.offsetX, LETTERBOX_PAD_VALUE);
+        std::fill(row + ws.offsetX + ws.resizedWidth, row + dstWidth, LETTERBOX_PAD_VALUE);
+    }
+}
+
+
+char *PreprocessLetterbox(const cv::Mat &iImg, int dstWidth, int dstHeight, float *oBlob,
+                          PreprocessWorkspace &workspace, LETTERBOX_INFO &oInfo) {
+    if (iImg.empty() || iImg.depth() != CV_8U) {
+        return "[DCSP_ONNX]:Preprocess expects a non-empty 8-bit image.";
+    }
+    int channels = iImg.channels();
+    if (channels != 1 && channels != 3 && channels != 4) {
+        return "[DCSP_ONNX]:Preprocess expects 1, 3 or 4 channels.";
+    }
+    if (!workspace.matches(iImg.cols, iImg.rows, channels, dstWidth, dstHeight)) {
+        workspace.prepare(iImg.cols, iImg.rows, channels, dstWidth, dstHeight);
+    }
+    oInfo = workspace.letterbox;
+
+    size_t planeSize = static_cast<size_t>(dstWidth) * dstHeight;
+    float *planes[3] = {oBlob, oBlob + planeSize, oBlob + 2 * planeSize};
+    for (float *plane: planes) {
+        FillBorder(plane, dstWidth, dstHeight, workspace);
+    }
+
+    int rowWidth = workspace.resizedWidth;
+    float *slots[2] = {workspace.rows.data(), workspace.rows.data() + 3 * rowWidth};
+    workspace.cachedRow[0] = workspace.cachedRow[1] = -1;
+
+    // Source rows are visited in ascending order, so each one is resampled at most once.
+    auto acquire = [&](int y, int keep) -> int {
+        if (workspace.cachedRow[0] == y) return 0;
+        if (workspace.cachedRow[1] == y) return 1;
+        int slot = keep >= 0 ? 1 - keep : (workspace.cachedRow[0] <= workspace.cachedRow[1] ? 0 : 1);
+        float *row = slots[slot];
+        ResampleRow(iImg.ptr<uint8_t>(y), channels, workspace, row, row + rowWidth, row + 2 * rowWidth);
+        workspace.cachedRow[slot] = y;
+        return slot;
+    };
+
+    const float inv255 = 1.f / 255.f;
+    for (int dy = 0; dy < workspace.resizedHeight; dy++) {
+        int s0 = acquire(workspace.yOfs0[dy], -1);
+        int s1 = acquire(workspace.yOfs1[dy], s0);
+        float fy = workspace.yAlpha[dy];
+        size_t dstOffset = static_cast<size_t>(workspace.offsetY + dy) * dstWidth + workspace.offsetX;
+        for (int c = 0; c < 3; c++) {
+            BlendRows(slots[s0] + c * rowWidth, slots[s1] + c * rowWidth, (1.f - fy) * inv255, fy * inv255,
+                      planes[c] + dstOffset, rowWidth);
+        }
+    }
+    return RET_OK;
+}
+
+
+YUV_IMAGE WrapNV21(const uint8_t *data, int width, int height, int rowStride) {
+    YUV_IMAGE img;
+    img.width = width;
+    img.height = height;
+    img.y = data;
+    img.yRowStride = rowStride;
+    img.uvRowStride = rowStride;
+    img.uvPixelStride = 2;
+    img.v = data + static_cast<size_t>(rowStride) * height;
+    img.u = img.v + 1;
+    return img;
+}
+
+
+YUV_IMAGE WrapI420(const uint8_t *data, int width, int height, int rowStride) {
+    YUV_IMAGE img;
+    img.width = width;
+    img.height = height;
+    img.y = data;
+    img.yRowStride = rowStride;
+    img.uvRowStride = rowStride / 2;
+    img.uvPixelStride = 1;
+    img.u = data + static_cast<size_t>(rowStride) * height;
+    img.v = img.u + static_cast<size_t>(img.uvRowStride) * ((height + 1) / 2);
+    return img;
+}
+
+
+// Full-range BT.601: R = Y + 1.402 V', G = Y - 0.344 U' - 0.714 V', B = Y + 1.772 U'
+// with U' = U - 128, V' = V - 128; output clamped to [0, 255] and scaled to [0, 1].
+static constexpr float kVr = 1.402f;
+static constexpr float kUg = -0.344136f;
+static constexpr float kVg = -0.714136f;
+static constexpr float kUb = 1.772f;
+
+static void YuvRowToRgb(const float *y, const float *u, const float *v, float *r, float *g, float *b, int n) {
+    const float inv255 = 1.f / 255.f;
+    int i = 0;
+#if defined(DCSP_SIMD_AVX2)
+    __m256 zero8 = _mm256_setzero_ps();
+    __m256 max8 = _mm256_set1_ps(255.f);
+    __m256 scale8 = _mm256_set1_ps(inv255);
+    for (; i + 8 <= n; i += 8) {
+        __m256 vy = _mm256_loadu_ps(y + i);
+        __m256 vu = _mm256_loadu_ps(u + i);
+        __m256 vv = _mm256_loadu_ps(v + i);
+        __m256 vr = _mm256_fmadd_ps(vv, _mm256_set1_ps(kVr), vy);
+        __m256 vg = _mm256_fmadd_ps(vv, _mm256_set1_ps(kVg), _mm256_fmadd_ps(vu, _mm256_set1_ps(kUg), vy));
+        __m256 vb = _mm256_fmadd_ps(vu, _mm256_set1_ps(kUb), vy);
+        _mm256_storeu_ps(r + i, _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(vr, zero8), max8), scale8));
+        _mm256_storeu_ps(g + i, _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(vg, zero8), max8), scale8));
+        _mm256_storeu_ps(b + i, _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(vb, zero8), max8), scale8));
+    }
+#endif
+#if defined(DCSP_SIMD_SSE2)
+    __m128 zero4 = _mm_setzero_ps();
+    __m128 max4 = _mm_set1_ps(255.f);
+    __m128 scale4 = _mm_set1_ps(inv255);
+    for (; i + 4 <= n; i += 4) {
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 vu = _mm_loadu_ps(u + i);
+        __m128 vv = _mm_loadu_ps(v + i);
+        __m128 vr = _mm_add_ps(vy, _mm_mul_ps(vv, _mm_set1_ps(kVr)));
+        __m128 vg = _mm_add_ps(vy, _mm_add_ps(_mm_mul_ps(vu, _mm_set1_ps(kUg)), _mm_mul_ps(vv, _mm_set1_ps(kVg))));
+        __m128 vb = _mm_add_ps(vy, _mm_mul_ps(vu, _mm_set1_ps(kUb)));
+        _mm_storeu_ps(r + i, _mm_mul_ps(_mm_min_ps(_mm_max_ps(vr, zero4), max4), scale4));
+        _mm_storeu_ps(g + i, _mm_mul_ps(_mm_min_ps(_mm_max_ps(vg, zero4), max4), scale4));
+        _mm_storeu_ps(b + i, _mm_mul_ps(_mm_min_ps(_mm_max_ps(vb, zero4), max4), scale4));
+    }
+#elif defined(DCSP_SIMD_NEON)
+    float32x4_t zero4 = vdupq_n_f32(0.f);
+    float32x4_t max4 = vdupq_n_f32(255.f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t vy = vld1q_f32(y + i);
+        float32x4_t vu = vld1q_f32(u + i);
+        float32x4_t vv = vld1q_f32(v + i);
+        float32x4_t vr = vmlaq_n_f32(vy, vv, kVr);
+        float32x4_t vg = vmlaq_n_f32(vmlaq_n_f32(vy, vu, kUg), vv, kVg);
+        float32x4_t vb = vmlaq_n_f32(vy, vu, kUb);
+        vst1q_f32(r + i, vmulq_n_f32(vminq_f32(vmaxq_f32(vr, zero4), max4), inv255));
+        vst1q_f32(g + i, vmulq_n_f32(vminq_f32(vmaxq_f32(vg, zero4), max4), inv255));
+        vst1q_f32(b + i, vmulq_n_f32(vminq_f32(vmaxq_f32(vb, zero4), max4), inv255));
+    }
+#endif
+    for (; i < n; i++) {
+        r[i] = std::clamp(y[i] + kVr * v[i], 0.f, 255.f) * inv255;
+        g[i] = std::clamp(y[i] + kUg * u[i] + kVg * v[i], 0.f, 255.f) * inv255;
+        b[i] = std::clamp(y[i] + kUb * u[i], 0.f, 255.f) * inv255;
+    }
+}
+
+
+char *PreprocessYuvLetterbox(const YUV_IMAGE &iImg, int dstWidth, int dstHeight, float *oBlob,
+                             PreprocessWorkspace &workspace, LETTERBOX_INFO &oInfo) {
+    if (iImg.y == nullptr || iImg.u == nullptr || iImg.v == nullptr || iImg.width <= 0 || iImg.height <= 0) {
+        return "[DCSP_ONNX]:Preprocess expects a non-empty YUV 4:2:0 image.";
+    }
+    if (!workspace.matches(iImg.width, iImg.height, 1, dstWidth, dstHeight)) {
+        workspace.prepare(iImg.width, iImg.height, 1, dstWidth, dstHeight);
+    }
+    oInfo = workspace.letterbox;
+
+    size_t planeSize = static_cast<size_t>(dstWidth) * dstHeight;
+    float *planes[3] = {oBlob, oBlob + planeSize, oBlob + 2 * planeSize};
+    for (float *plane: planes) {
+        FillBorder(plane, dstWidth, dstHeight, workspace);
+    }
+
+    int rowWidth = workspace.resizedWidth;
+    const int *ofs0 = workspace.xOfs0.data();
+    const int *ofs1 = workspace.xOfs1.data();
+    const float *alpha = workspace.xAlpha.data();
+    float *lumaSlots[2] = {workspace.rows.data(), workspace.rows.data() + 3 * rowWidth};
+    float *luma = workspace.yuvRow.data();
+    float *uRow = luma + rowWidth;
+    float *vRow = uRow + rowWidth;
+    workspace.cachedRow[0] = workspace.cachedRow[1] = -1;
+
+    auto acquire = [&](int y, int keep) -> int {
+        if (workspace.cachedRow[0] == y) return 0;
+        if (workspace.cachedRow[1] == y) return 1;
+        int slot = keep >= 0 ? 1 - keep : (workspace.cachedRow[0] <= workspace.cachedRow[1] ? 0 : 1);
+        const uint8_t *src = iImg.y + static_cast<size_t>(y) * iImg.yRowStride;
+        float *row = lumaSlots[slot];
+        for (int x = 0; x < rowWidth; x++) {
+            float p0 = src[ofs0[x]];
+            row[x] = p0 + (src[ofs1[x]] - p0) * alpha[x];
+        }
+        workspace.cachedRow[slot] = y;
+        return slot;
+    };
+
+    for (int dy = 0; dy < workspace.resizedHeight; dy++) {
+        int y0 = workspace.yOfs0[dy];
+        int s0 = acquire(y0, -1);
+        int s1 = acquire(workspace.yOfs1[dy], s0);
+        float fy = workspace.yAlpha[dy];
+        BlendRows(lumaSlots[s0], lumaSlots[s1], 1.f - fy, fy, luma, rowWidth);
+
+        size_t chromaRow = static_cast<size_t>(y0 >> 1) * iImg.uvRowStride;
+        const uint8_t *uSrc = iImg.u + chromaRow;
+        const uint8_t *vSrc = iImg.v + chromaRow;
+        for (int x = 0; x < rowWidth; x++) {
+            int cx = (ofs0[x] >> 1) * iImg.uvPixelStride;
+            uRow[x] = uSrc[cx] - 128.f;
+            vRow[x] = vSrc[cx] - 128.f;
+        }
+
+        size_t dstOffset = static_cast<size_t>(workspace.offsetY + dy) * dstWidth + workspace.offsetX;
+        YuvRowToRgb(luma, uRow, vRow, planes[0] + dstOffset, planes[1] + dstOffset, planes[2] + dstOffset,
+                    rowWidth);
+    }
+    return RET_OK;
+}
+
+
+char *PostProcess(const cv::Mat &iImg, std::vector<int> iImgSize, cv::Mat &oImg) {
+    cv::resize(iImg, oImg, cv::Size(iImgSize.at(0), iImgSize.at(1)));
+    if (iImg.channels() == 1) {
+        cv::cvtColor(oImg, oImg, cv::COLOR_GRAY2BGR);
+    }
+    cv::cvtColor(oImg, oImg, cv::COLOR_BGR2RGB);
+    return RET_OK;
+}
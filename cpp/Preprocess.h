@@ -0,0 +1,123 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <cstdint>
+#include <vector>
+#include <type_traits>
+#include <opencv2/opencv.hpp>
+
+
+// Maps source image coordinates into model input coordinates:
+// tensorX = srcX * scaleX + padX, tensorY = srcY * scaleY + padY.
+typedef struct _LETTERBOX_INFO {
+    float scaleX = 1.f;
+    float scaleY = 1.f;
+    float padX = 0.f;
+    float padY = 0.f;
+} LETTERBOX_INFO;
+
+
+// Value written into the letterbox border, matching the Ultralytics exporter (114 / 255).
+constexpr float LETTERBOX_PAD_VALUE = 114.f / 255.f;
+
+
+LETTERBOX_INFO ComputeLetterbox(int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+
+// A 4:2:0 frame with arbitrary plane strides, e.g. the planes of a locked YUV_420_888
+// AHardwareBuffer. uvPixelStride is 1 for planar I420 and 2 for semi-planar NV12 / NV21.
+typedef struct _YUV_IMAGE {
+    const uint8_t *y = nullptr;
+    const uint8_t *u = nullptr;
+    const uint8_t *v = nullptr;
+    int width = 0;
+    int height = 0;
+    int yRowStride = 0;
+    int uvRowStride = 0;
+    int uvPixelStride = 1;
+} YUV_IMAGE;
+
+
+YUV_IMAGE WrapNV21(const uint8_t *data, int width, int height, int rowStride);
+
+YUV_IMAGE WrapI420(const uint8_t *data, int width, int height, int rowStride);
+
+
+// Lookup tables and row scratch reused across frames by the fused kernel.
+// Rebuilt only when the source or destination geometry changes.
+class PreprocessWorkspace {
+public:
+    bool matches(int srcWidth, int srcHeight, int srcChannels, int dstWidth, int dstHeight) const;
+
+    void prepare(int srcWidth, int srcHeight, int srcChannels, int dstWidth, int dstHeight);
+
+    LETTERBOX_INFO letterbox;
+    int resizedWidth = 0;
+    int resizedHeight = 0;
+    int offsetX = 0;
+    int offsetY = 0;
+
+    std::vector<int> xOfs0;
+    std::vector<int> xOfs1;
+    std::vector<float> xAlpha;
+    std::vector<int> yOfs0;
+    std::vector<int> yOfs1;
+    std::vector<float> yAlpha;
+
+    // Two cached source rows, horizontally resampled into planar R, G, B.
+    std::vector<float> rows;
+    int cachedRow[2] = {-1, -1};
+
+    // Luma row plus nearest-sampled U / V for the YUV path.
+    std::vector<float> yuvRow;
+
+private:
+    int srcWidth_ = 0;
+    int srcHeight_ = 0;
+    int srcChannels_ = 0;
+    int dstWidth_ = 0;
+    int dstHeight_ = 0;
+};
+
+
+// Fused letterbox resize + BGR->RGB + scale to [0,1] + HWC->CHW.
+// Accepts CV_8UC1 / CV_8UC3 (BGR) / CV_8UC4 (BGRA) input of any row stride and writes
+// 3 * dstWidth * dstHeight floats into oBlob in a single pass over the source.
+char *PreprocessLetterbox(const cv::Mat &iImg, int dstWidth, int dstHeight, float *oBlob,
+                          PreprocessWorkspace &workspace, LETTERBOX_INFO &oInfo);
+
+
+// YUV 4:2:0 variant of PreprocessLetterbox: bilinear luma, nearest chroma, full-range BT.601
+// conversion, written directly into the letterboxed RGB CHW tensor without an intermediate image.
+char *PreprocessYuvLetterbox(const YUV_IMAGE &iImg, int dstWidth, int dstHeight, float *oBlob,
+                             PreprocessWorkspace &workspace, LETTERBOX_INFO &oInfo);
+
+
+// Blends two planar rows: dst[i] = a[i] * wa + b[i] * wb (SIMD on AVX2 / SSE2 / NEON).
+void BlendRows(const float *a, const float *b, float wa, float wb, float *dst, int n);
+
+
+// Reference path: stretch resize + colour conversion into a new cv::Mat, followed by a
+// scalar HWC->CHW copy. Kept for the FP16 models and as the benchmark baseline.
+char *PostProcess(const cv::Mat &iImg, std::vector<int> iImgSize, cv::Mat &oImg);
+
+
+template<typename T>
+char *BlobFromImage(cv::Mat &iImg, T &iBlob) {
+    int channels = iImg.channels();
+    int imgHeight = iImg.rows;
+    int imgWidth = iImg.cols;
+
+    for (int c = 0; c < channels; c++) {
+        for (int h = 0; h < imgHeight; h++) {
+            for (int w = 0; w < imgWidth; w++) {
+                iBlob[c * imgWidth * imgHeight + h * imgWidth + w] = typename std::remove_pointer<T>::type(
+                        (iImg.at<cv::Vec3b>(h, w)[c]) / 255.0f);
+            }
+        }
+    }
+    return RET_OK;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Compile-time SIMD selection shared by the hand-vectorized kernels.
+// arm64-v8a always has NEON, x86_64 always has SSE2; AVX2 is only used when the
+// translation unit is built with -mavx2 -mfma (host builds), never on device ABIs.
+
+#if defined(__AVX2__) && defined(__FMA__)
+#define DCSP_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define DCSP_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DCSP_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
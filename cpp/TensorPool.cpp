@@ -0,0 +1,219 @@
+#include "TensorPool.h"
+#include <algorithm>
+#include <cstdlib>
+#include "Log.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+
+static constexpr size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+
+// Sits in the TENSOR_ALIGNMENT bytes in front of every block, so Free needs no lookup table.
+typedef struct _TENSOR_BLOCK_HEADER {
+    size_t bytes;
+    // -1 for oversized blocks, which go straight back to the system.
+    int sizeClass;
+} TENSOR_BLOCK_HEADER;
+
+static_assert(sizeof(TENSOR_BLOCK_HEADER) <= TENSOR_ALIGNMENT, "block header must fit in the alignment pad");
+
+
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+
+static TENSOR_BLOCK_HEADER *HeaderOf(void *data) {
+    return reinterpret_cast<TENSOR_BLOCK_HEADER *>(static_cast<uint8_t *>(data) - TENSOR_ALIGNMENT);
+}
+
+
+TensorPool &TensorPool::Shared() {
+    // Leaked on purpose: ORT may free tensors from static destructors after main returns.
+    static TensorPool *instance = new TensorPool();
+    return *instance;
+}
+
+
+TensorPool::TensorPool() {
+    int index = 0;
+    for (int shift = TENSOR_MIN_CLASS_SHIFT; shift < TENSOR_MAX_CLASS_SHIFT; shift++) {
+        size_t octave = static_cast<size_t>(1) << shift;
+        for (int step = 0; step < TENSOR_CLASSES_PER_OCTAVE; step++) {
+            classBytes[index++] = octave + step * (octave / TENSOR_CLASSES_PER_OCTAVE);
+        }
+    }
+    classBytes[index] = static_cast<size_t>(1) << TENSOR_MAX_CLASS_SHIFT;
+}
+
+
+void TensorPool::SetParam(const TENSOR_POOL_PARAM &iParam) {
+    std::lock_guard<std::mutex> lock(mutex);
+    param = iParam;
+    stats.budgetBytes = param.BudgetBytes;
+    if (param.BudgetBytes > 0 && stats.liveBytes + stats.cachedBytes > param.BudgetBytes) {
+        TrimLocked();
+    }
+}
+
+
+TENSOR_POOL_PARAM TensorPool::Param() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return param;
+}
+
+
+void *TensorPool::AllocateBlock(int sizeClass, size_t bytes) {
+    size_t total = bytes + TENSOR_ALIGNMENT;
+    bool hugePages = param.HugePages && bytes >= HUGE_PAGE_BYTES;
+    size_t alignment = TENSOR_ALIGNMENT;
+    if (hugePages) {
+        // Whole, aligned huge pages; a block that straddles a boundary would only get small pages.
+        alignment = HUGE_PAGE_BYTES;
+        total = AlignUp(total, HUGE_PAGE_BYTES);
+    }
+    void *raw = nullptr;
+#ifdef _WIN32
+    raw = _aligned_malloc(total, alignment);
+#else
+    if (posix_memalign(&raw, alignment, total) != 0) {
+        raw = nullptr;
+    }
+#endif
+    if (raw == nullptr) {
+        return nullptr;
+    }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (hugePages) {
+        // Advisory only: without THP support the block simply stays on normal pages.
+        madvise(raw, total, MADV_HUGEPAGE);
+    }
+#endif
+    auto *header = static_cast<TENSOR_BLOCK_HEADER *>(raw);
+    header->bytes = bytes;
+    header->sizeClass = sizeClass;
+    return static_cast<uint8_t *>(raw) + TENSOR_ALIGNMENT;
+}
+
+
+void TensorPool::ReleaseBlock(void *block) {
+#ifdef _WIN32
+    _aligned_free(HeaderOf(block));
+#else
+    free(HeaderOf(block));
+#endif
+}
+
+
+void *TensorPool::Allocate(size_t bytes) {
+    size_t *classEnd = classBytes + TENSOR_CLASS_COUNT;
+    int sizeClass = static_cast<int>(std::lower_bound(classBytes, classEnd, std::max<size_t>(bytes, 1)) - classBytes);
+    bool pooled = sizeClass < TENSOR_CLASS_COUNT;
+    size_t blockBytes = pooled ? classBytes[sizeClass] : AlignUp(bytes, TENSOR_ALIGNMENT);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.allocations++;
+    if (pooled && !freeBlocks[sizeClass].empty()) {
+        void *data = freeBlocks[sizeClass].back();
+        freeBlocks[sizeClass].pop_back();
+        stats.cachedBytes -= blockBytes;
+        stats.liveBytes += blockBytes;
+        stats.reused++;
+        return data;
+    }
+    if (param.BudgetBytes > 0 && stats.liveBytes + stats.cachedBytes + blockBytes > param.BudgetBytes) {
+        TrimLocked();
+        if (stats.liveBytes + blockBytes > param.BudgetBytes) {
+            stats.refused++;
+            DCSP_LOGW("DCSP_ONNX", "Tensor budget of %zu bytes exceeded (%zu live, %zu requested)",
+                      param.BudgetBytes, stats.liveBytes, blockBytes);
+            return nullptr;
+        }
+    }
+    void *data = AllocateBlock(pooled ? sizeClass : -1, blockBytes);
+    if (data == nullptr) {
+        return nullptr;
+    }
+    stats.liveBytes += blockBytes;
+    stats.peakBytes = std::max(stats.peakBytes, stats.liveBytes + stats.cachedBytes);
+    return data;
+}
+
+
+void TensorPool::Free(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    const TENSOR_BLOCK_HEADER *header = HeaderOf(ptr);
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.liveBytes -= header->bytes;
+    if (header->sizeClass < 0) {
+        ReleaseBlock(ptr);
+        return;
+    }
+    freeBlocks[header->sizeClass].push_back(ptr);
+    stats.cachedBytes += header->bytes;
+}
+
+
+void TensorPool::TrimLocked() {
+    for (std::vector<void *> &blocks: freeBlocks) {
+        for (void *block: blocks) {
+            ReleaseBlock(block);
+        }
+        blocks.clear();
+    }
+    stats.cachedBytes = 0;
+}
+
+
+void TensorPool::Trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    TrimLocked();
+}
+
+
+TENSOR_POOL_STATS TensorPool::Stats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+
+static const OrtMemoryInfo *gPoolMemoryInfo = nullptr;
+
+
+static void *ORT_API_CALL PoolAlloc(OrtAllocator *, size_t size) {
+    return TensorPool::Shared().Allocate(size);
+}
+
+
+static void ORT_API_CALL PoolFree(OrtAllocator *, void *ptr) {
+    TensorPool::Shared().Free(ptr);
+}
+
+
+static const OrtMemoryInfo *ORT_API_CALL PoolInfo(const OrtAllocator *) {
+    return gPoolMemoryInfo;
+}
+
+
+OrtAllocator *TensorPool::OrtHandle() {
+    static OrtAllocator *handle = [] {
+        static Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+        static OrtAllocator allocator{};
+        gPoolMemoryInfo = memoryInfo;
+        allocator.version = ORT_API_VERSION;
+        allocator.Alloc = PoolAlloc;
+        allocator.Free = PoolFree;
+        allocator.Info = PoolInfo;
+#if ORT_API_VERSION >= 18
+        // Reserve bypasses ORT's arena accounting; the pool treats it like any other block.
+        allocator.Reserve = PoolAlloc;
+#endif
+        return &allocator;
+    }();
+    return handle;
+}
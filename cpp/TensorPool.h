@@ -0,0 +1,120 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "onnxruntime_cxx_api.h"
+
+
+// Every tensor block is aligned to a cache line, which also satisfies AVX-512 / NEON loads.
+constexpr size_t TENSOR_ALIGNMENT = 64;
+// Log-linear size classes from 64 B to 1 GiB: each power of two is split into 4 classes, so a
+// block wastes at most ~25% of its size. Larger requests bypass the pool.
+constexpr int TENSOR_CLASSES_PER_OCTAVE = 4;
+constexpr int TENSOR_MIN_CLASS_SHIFT = 6;
+constexpr int TENSOR_MAX_CLASS_SHIFT = 30;
+constexpr int TENSOR_CLASS_COUNT = (TENSOR_MAX_CLASS_SHIFT - TENSOR_MIN_CLASS_SHIFT) * TENSOR_CLASSES_PER_OCTAVE + 1;
+
+
+typedef struct _TENSOR_POOL_PARAM {
+    // Cap on live plus cached tensor bytes, 0 = unlimited. When a request would exceed it the
+    // cache is dropped first; if live tensors alone are over budget the allocation fails and the
+    // ORT run reports an out-of-memory error instead of the process being killed.
+    size_t BudgetBytes = 0;
+    // Ask for transparent huge pages on blocks of at least 2 MiB (Linux / Android only). Fewer TLB
+    // misses on large activations, but a huge page is committed whole.
+    bool HugePages = false;
+} TENSOR_POOL_PARAM;
+
+
+typedef struct _TENSOR_POOL_STATS {
+    size_t budgetBytes = 0;
+    // Handed out and not yet freed.
+    size_t liveBytes = 0;
+    // Freed blocks kept for reuse.
+    size_t cachedBytes = 0;
+    size_t peakBytes = 0;
+    uint64_t allocations = 0;
+    // Allocations served from a cached block.
+    uint64_t reused = 0;
+    // Allocations refused because of the budget.
+    uint64_t refused = 0;
+} TENSOR_POOL_STATS;
+
+
+// Process-wide pool of 64-byte aligned blocks for tensor memory. Freed blocks go onto a per-class
+// free list instead of back to malloc, so the same activation shapes frame after frame are served
+// without touching the system allocator. Registered with OrtEnvironment as the CPU allocator, ORT's
+// intermediates and outputs come from here too (see DCSP_INIT_PARAM::UseTensorPool).
+class TensorPool {
+public:
+    static TensorPool &Shared();
+
+    // Can be changed at any time; a lower budget releases cached blocks right away.
+    void SetParam(const TENSOR_POOL_PARAM &iParam);
+
+    TENSOR_POOL_PARAM Param();
+
+    // nullptr when the budget does not allow it.
+    void *Allocate(size_t bytes);
+
+    void Free(void *ptr);
+
+    // Returns every cached block to the system.
+    void Trim();
+
+    TENSOR_POOL_STATS Stats();
+
+    // The pool as an OrtAllocator, for Ort::Env::RegisterAllocator.
+    OrtAllocator *OrtHandle();
+
+private:
+    TensorPool();
+
+    void *AllocateBlock(int sizeClass, size_t bytes);
+
+    void ReleaseBlock(void *block);
+
+    void TrimLocked();
+
+    std::mutex mutex;
+    TENSOR_POOL_PARAM param;
+    TENSOR_POOL_STATS stats;
+    size_t classBytes[TENSOR_CLASS_COUNT];
+    std::vector<void *> freeBlocks[TENSOR_CLASS_COUNT];
+};
+
+
+// Standard allocator over TensorPool::Shared(), for buffers handed to ORT (e.g. IoBinding inputs).
+template<typename T>
+class TensorPoolAllocator {
+public:
+    typedef T value_type;
+
+    TensorPoolAllocator() = default;
+
+    template<typename U>
+    TensorPoolAllocator(const TensorPoolAllocator<U> &) {}
+
+    T *allocate(size_t count) {
+        void *ptr = TensorPool::Shared().Allocate(count * sizeof(T));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(ptr);
+    }
+
+    void deallocate(T *ptr, size_t) { TensorPool::Shared().Free(ptr); }
+
+    template<typename U>
+    bool operator==(const TensorPoolAllocator<U> &) const { return true; }
+
+    template<typename U>
+    bool operator!=(const TensorPoolAllocator<U> &) const { return false; }
+};
@@ -0,0 +1,81 @@
+#include "ThreadBudget.h"
+#include <algorithm>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include "OrtEnvironment.h"
+#include "Log.h"
+
+
+static std::mutex gBudgetMutex;
+static bool gBudgetApplied = false;
+static THREAD_BUDGET gBudget;
+
+
+static THREAD_BUDGET Resolve(const THREAD_BUDGET &iBudget) {
+    const CPU_TOPOLOGY &topology = GetCpuTopology();
+    THREAD_BUDGET budget = iBudget;
+    if (budget.IntraOpNumThreads <= 0) {
+        budget.IntraOpNumThreads = std::clamp(static_cast<int>(topology.bigCores.size()), 1, 4);
+    }
+    // More threads than cores only adds contention.
+    int cores = std::max(topology.coreCount, 1);
+    budget.IntraOpNumThreads = std::min(budget.IntraOpNumThreads, cores);
+    budget.InterOpNumThreads = std::clamp(budget.InterOpNumThreads, 1, cores);
+    budget.OpenCvNumThreads = std::clamp(budget.OpenCvNumThreads, 1, cores);
+    // Pinning only helps when there is a slower cluster to avoid.
+    budget.PinToBigCores = budget.PinToBigCores && !topology.littleCores.empty();
+    return budget;
+}
+
+
+static char *ApplyLocked(const THREAD_BUDGET &iBudget) {
+    THREAD_BUDGET budget = Resolve(iBudget);
+    ORT_ENV_PARAM envParam;
+    envParam.IntraOpNumThreads = budget.IntraOpNumThreads;
+    envParam.InterOpNumThreads = budget.InterOpNumThreads;
+    envParam.AllowSpinning = budget.AllowSpinning;
+    if (budget.PinToBigCores) {
+        envParam.IntraOpAffinity = IntraOpAffinityString(budget.IntraOpNumThreads, GetCpuTopology().bigCores);
+    }
+    char *Ret = OrtEnvironment::Configure(envParam);
+    if (Ret != RET_OK) {
+        return Ret;
+    }
+    cv::setNumThreads(budget.OpenCvNumThreads);
+    gBudget = budget;
+    gBudgetApplied = true;
+    return RET_OK;
+}
+
+
+char *SetThreadBudget(const THREAD_BUDGET &iBudget) {
+    std::lock_guard<std::mutex> lock(gBudgetMutex);
+    return ApplyLocked(iBudget);
+}
+
+
+THREAD_BUDGET GetThreadBudget() {
+    std::lock_guard<std::mutex> lock(gBudgetMutex);
+    if (!gBudgetApplied && ApplyLocked(THREAD_BUDGET()) != RET_OK) {
+        // The ORT environment was created first; report the pools it actually runs with.
+        const ORT_ENV_PARAM &envParam = OrtEnvironment::Instance().Param();
+        gBudget.IntraOpNumThreads = envParam.IntraOpNumThreads;
+        gBudget.InterOpNumThreads = envParam.InterOpNumThreads;
+        gBudget.AllowSpinning = envParam.AllowSpinning;
+        gBudget.PinToBigCores = !envParam.IntraOpAffinity.empty();
+        gBudget.OpenCvNumThreads = cv::getNumThreads();
+        gBudgetApplied = true;
+    }
+    return gBudget;
+}
+
+
+void PinWorkerThread() {
+    THREAD_BUDGET budget = GetThreadBudget();
+    if (budget.PinToBigCores) {
+        char *Ret = PinCurrentThread(GetCpuTopology().bigCores);
+        if (Ret != RET_OK) {
+            DCSP_LOGW("DCSP_ONNX", "Worker thread left unpinned: %s", Ret);
+        }
+    }
+}
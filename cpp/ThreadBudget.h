@@ -0,0 +1,33 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include "CpuTopology.h"
+
+
+// One place that decides how many CPU threads the library uses, so ORT's pools, OpenCV's
+// parallel_for_ pool and our own workers do not each size themselves for the whole machine.
+typedef struct _THREAD_BUDGET {
+    // 0 picks one thread per big core, at most 4.
+    int IntraOpNumThreads = 0;
+    int InterOpNumThreads = 1;
+    // Our letterbox/decode kernels are single-threaded; only OpenCV fallbacks use this pool.
+    int OpenCvNumThreads = 1;
+    // Keep ORT's pool threads and our inference threads off the little cluster.
+    bool PinToBigCores = true;
+    // Spinning trades idle CPU (and battery) for lower wake-up latency between ops.
+    bool AllowSpinning = false;
+} THREAD_BUDGET;
+
+
+// Must run before the first session is created: ORT's global pools are fixed once the shared
+// environment exists. Zero fields are resolved against the CPU topology.
+char *SetThreadBudget(const THREAD_BUDGET &iBudget);
+
+// The resolved budget; applies the defaults on first use if SetThreadBudget was never called.
+THREAD_BUDGET GetThreadBudget();
+
+// Applies the budget's core affinity to the calling worker thread.
+void PinWorkerThread();
@@ -0,0 +1,113 @@
+#include "Tiling.h"
+#include <algorithm>
+#include <cmath>
+
+
+// Tile extent along one axis and the origins of count tiles spread evenly from 0 to
+// extent - size, so the first and last tile touch the frame edges. The size has the parity of
+// extent, which keeps the last origin even like the inner ones.
+static void TileAxis(int extent, int count, float overlap, int &oSize, std::vector<int> &oOrigins) {
+    oOrigins.clear();
+    if (count <= 1) {
+        oSize = extent;
+        oOrigins.push_back(0);
+        return;
+    }
+    // count tiles of size s with overlap o cover s * (count - (count - 1) * o) pixels. Two pixels of
+    // slack absorb rounding the inner origins down to even.
+    float span = static_cast<float>(count) - static_cast<float>(count - 1) * overlap;
+    int size = static_cast<int>(std::ceil(static_cast<float>(extent) / span)) + 2;
+    size += (extent - size) & 1;
+    oSize = std::min(extent, size);
+    float step = static_cast<float>(extent - oSize) / static_cast<float>(count - 1);
+    for (int i = 0; i < count - 1; i++) {
+        oOrigins.push_back(static_cast<int>(std::lround(step * static_cast<float>(i))) & ~1);
+    }
+    oOrigins.push_back(extent - oSize);
+}
+
+
+char *ComputeTiles(int width, int height, const TILE_PARAM &iParam, std::vector<cv::Rect> &oTiles) {
+    oTiles.clear();
+    if (width < 2 || height < 2) {
+        return "[DCSP_ONNX]:Frame is too small to tile.";
+    }
+    if (iParam.columns < 1 || iParam.rows < 1 || iParam.overlap < 0.f || iParam.overlap >= 1.f) {
+        return "[DCSP_ONNX]:Tiles need at least one column and row and an overlap in [0, 1).";
+    }
+    int tileWidth = 0;
+    int tileHeight = 0;
+    std::vector<int> xs;
+    std::vector<int> ys;
+    TileAxis(width, iParam.columns, iParam.overlap, tileWidth, xs);
+    TileAxis(height, iParam.rows, iParam.overlap, tileHeight, ys);
+    for (int y: ys) {
+        for (int x: xs) {
+            oTiles.emplace_back(x, y, tileWidth, tileHeight);
+        }
+    }
+    if (iParam.fullFrame && oTiles.size() > 1) {
+        oTiles.emplace_back(0, 0, width, height);
+    }
+    return RET_OK;
+}
+
+
+YUV_IMAGE CropYuv(const YUV_IMAGE &iImg, const cv::Rect &tile) {
+    YUV_IMAGE crop = iImg;
+    crop.width = tile.width;
+    crop.height = tile.height;
+    crop.y = iImg.y + static_cast<size_t>(tile.y) * iImg.yRowStride + tile.x;
+    size_t chromaOffset = static_cast<size_t>(tile.y / 2) * iImg.uvRowStride +
+                          static_cast<size_t>(tile.x / 2) * iImg.uvPixelStride;
+    crop.u = iImg.u + chromaOffset;
+    crop.v = iImg.v + chromaOffset;
+    return crop;
+}
+
+
+// Intersection over the smaller of the two areas.
+static float BoxIos(const DCSP_CANDIDATE &a, const DCSP_CANDIDATE &b) {
+    float ix = std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x);
+    float iy = std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y);
+    if (ix <= 0.f || iy <= 0.f) {
+        return 0.f;
+    }
+    float smaller = std::min(a.width * a.height, b.width * b.height);
+    return smaller > 0.f ? ix * iy / smaller : 0.f;
+}
+
+
+void MergeTileDetections(std::vector<DCSP_CANDIDATE> &ioCandidates, const std::vector<int> &candidateTiles,
+                         float mergeThreshold, std::vector<int> &ioKeep) {
+    if (mergeThreshold <= 0.f) {
+        return;
+    }
+    // Kept detections are few (bounded by NMS_PARAM::maxDetections), a quadratic pass is fine.
+    size_t count = ioKeep.size();
+    for (size_t i = 0; i < count; i++) {
+        int keeper = ioKeep[i];
+        if (keeper < 0) {
+            continue;
+        }
+        DCSP_CANDIDATE &merged = ioCandidates[keeper];
+        for (size_t j = i + 1; j < count; j++) {
+            int other = ioKeep[j];
+            if (other < 0 || candidateTiles[other] == candidateTiles[keeper]) {
+                continue;
+            }
+            const DCSP_CANDIDATE &candidate = ioCandidates[other];
+            if (candidate.classId != merged.classId || BoxIos(merged, candidate) < mergeThreshold) {
+                continue;
+            }
+            float x2 = std::max(merged.x + merged.width, candidate.x + candidate.width);
+            float y2 = std::max(merged.y + merged.height, candidate.y + candidate.height);
+            merged.x = std::min(merged.x, candidate.x);
+            merged.y = std::min(merged.y, candidate.y);
+            merged.width = x2 - merged.x;
+            merged.height = y2 - merged.y;
+            ioKeep[j] = -1;
+        }
+    }
+    ioKeep.erase(std::remove(ioKeep.begin(), ioKeep.end(), -1), ioKeep.end());
+}
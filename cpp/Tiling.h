@@ -0,0 +1,44 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "Preprocess.h"
+#include "YoloDecode.h"
+
+
+typedef struct _TILE_PARAM {
+    // Grid the frame is split into; each tile is letterboxed to the full model input, so small
+    // objects are downscaled columns (or rows) times less than in a whole-frame pass.
+    int columns = 2;
+    int rows = 2;
+    // Fraction of a tile shared with its neighbour, so an object on a seam is whole in at least
+    // one tile when it is smaller than the overlap.
+    float overlap = 0.2f;
+    // Also run the whole frame as the last batch entry, for objects larger than a tile.
+    bool fullFrame = true;
+    // Same-class boxes from different tiles whose intersection covers at least this fraction of
+    // the smaller box are merged into their union: the halves of an object cut by a seam overlap
+    // too little for IoU-based NMS to catch. <= 0 leaves only NMS.
+    float mergeThreshold = 0.6f;
+} TILE_PARAM;
+
+
+// Tile rectangles for a width x height frame: columns x rows tiles of identical size (so one
+// PreprocessWorkspace serves them all) on even coordinates (so 4:2:0 chroma can be cropped),
+// row-major, followed by the whole frame when iParam.fullFrame is set. Together the tiles cover
+// every pixel, the last column and row of tiles ending exactly on the frame edges.
+char *ComputeTiles(int width, int height, const TILE_PARAM &iParam, std::vector<cv::Rect> &oTiles);
+
+// View of the part of a 4:2:0 frame inside tile; tile.x and tile.y must be even. No pixels are copied.
+YUV_IMAGE CropYuv(const YUV_IMAGE &iImg, const cv::Rect &tile);
+
+// Cross-tile merge after NMS. ioKeep holds candidate indices, highest confidence first, and
+// candidateTiles the tile each candidate was decoded from. Kept boxes absorb lower-scored
+// same-class boxes from other tiles (see TILE_PARAM::mergeThreshold), which grows them to the
+// union in place and drops the absorbed indices from ioKeep.
+void MergeTileDetections(std::vector<DCSP_CANDIDATE> &ioCandidates, const std::vector<int> &candidateTiles,
+                         float mergeThreshold, std::vector<int> &ioKeep);
@@ -0,0 +1,303 @@
+#include "Tracker.h"
+#include <algorithm>
+#include <cmath>
+#include "Simd.h"
+
+
+static inline float ScalarIou(float x1, float y1, float x2, float y2, float area,
+                              float bx1, float by1, float bx2, float by2, float bArea) {
+    float ix = std::max(std::min(x2, bx2) - std::max(x1, bx1), 0.f);
+    float iy = std::max(std::min(y2, by2) - std::max(y1, by1), 0.f);
+    float inter = ix * iy;
+    float unionArea = area + bArea - inter;
+    return unionArea > 0.f ? inter / unionArea : 0.f;
+}
+
+
+void IouOneToMany(float x1, float y1, float x2, float y2, const float *boxX1, const float *boxY1,
+                  const float *boxX2, const float *boxY2, const float *boxArea, int n, float *oIou) {
+    float area = (x2 - x1) * (y2 - y1);
+    int i = 0;
+#if defined(DCSP_SIMD_AVX2)
+    __m256 ax1 = _mm256_set1_ps(x1);
+    __m256 ay1 = _mm256_set1_ps(y1);
+    __m256 ax2 = _mm256_set1_ps(x2);
+    __m256 ay2 = _mm256_set1_ps(y2);
+    __m256 aArea = _mm256_set1_ps(area);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 tiny = _mm256_set1_ps(1e-9f);
+    for (; i + 8 <= n; i += 8) {
+        __m256 ix = _mm256_sub_ps(_mm256_min_ps(ax2, _mm256_loadu_ps(boxX2 + i)),
+                                  _mm256_max_ps(ax1, _mm256_loadu_ps(boxX1 + i)));
+        __m256 iy = _mm256_sub_ps(_mm256_min_ps(ay2, _mm256_loadu_ps(boxY2 + i)),
+                                  _mm256_max_ps(ay1, _mm256_loadu_ps(boxY1 + i)));
+        __m256 inter = _mm256_mul_ps(_mm256_max_ps(ix, zero), _mm256_max_ps(iy, zero));
+        __m256 unionArea = _mm256_sub_ps(_mm256_add_ps(aArea, _mm256_loadu_ps(boxArea + i)), inter);
+        _mm256_storeu_ps(oIou + i, _mm256_div_ps(inter, _mm256_max_ps(unionArea, tiny)));
+    }
+#elif defined(DCSP_SIMD_SSE2)
+    __m128 ax1 = _mm_set1_ps(x1);
+    __m128 ay1 = _mm_set1_ps(y1);
+    __m128 ax2 = _mm_set1_ps(x2);
+    __m128 ay2 = _mm_set1_ps(y2);
+    __m128 aArea = _mm_set1_ps(area);
+    __m128 zero = _mm_setzero_ps();
+    __m128 tiny = _mm_set1_ps(1e-9f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 ix = _mm_sub_ps(_mm_min_ps(ax2, _mm_loadu_ps(boxX2 + i)), _mm_max_ps(ax1, _mm_loadu_ps(boxX1 + i)));
+        __m128 iy = _mm_sub_ps(_mm_min_ps(ay2, _mm_loadu_ps(boxY2 + i)), _mm_max_ps(ay1, _mm_loadu_ps(boxY1 + i)));
+        __m128 inter = _mm_mul_ps(_mm_max_ps(ix, zero), _mm_max_ps(iy, zero));
+        __m128 unionArea = _mm_sub_ps(_mm_add_ps(aArea, _mm_loadu_ps(boxArea + i)), inter);
+        _mm_storeu_ps(oIou + i, _mm_div_ps(inter, _mm_max_ps(unionArea, tiny)));
+    }
+#elif defined(DCSP_SIMD_NEON)
+    float32x4_t ax1 = vdupq_n_f32(x1);
+    float32x4_t ay1 = vdupq_n_f32(y1);
+    float32x4_t ax2 = vdupq_n_f32(x2);
+    float32x4_t ay2 = vdupq_n_f32(y2);
+    float32x4_t aArea = vdupq_n_f32(area);
+    float32x4_t zero = vdupq_n_f32(0.f);
+    float32x4_t tiny = vdupq_n_f32(1e-9f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t ix = vsubq_f32(vminq_f32(ax2, vld1q_f32(boxX2 + i)), vmaxq_f32(ax1, vld1q_f32(boxX1 + i)));
+        float32x4_t iy = vsubq_f32(vminq_f32(ay2, vld1q_f32(boxY2 + i)), vmaxq_f32(ay1, vld1q_f32(boxY1 + i)));
+        float32x4_t inter = vmulq_f32(vmaxq_f32(ix, zero), vmaxq_f32(iy, zero));
+        float32x4_t unionArea = vmaxq_f32(vsubq_f32(vaddq_f32(aArea, vld1q_f32(boxArea + i)), inter), tiny);
+#if defined(__aarch64__)
+        vst1q_f32(oIou + i, vdivq_f32(inter, unionArea));
+#else
+        // armv7 has no vector divide: reciprocal estimate refined by two Newton-Raphson steps.
+        float32x4_t reciprocal = vrecpeq_f32(unionArea);
+        reciprocal = vmulq_f32(vrecpsq_f32(unionArea, reciprocal), reciprocal);
+        reciprocal = vmulq_f32(vrecpsq_f32(unionArea, reciprocal), reciprocal);
+        vst1q_f32(oIou + i, vmulq_f32(inter, reciprocal));
+#endif
+    }
+#endif
+    for (; i < n; i++) {
+        oIou[i] = ScalarIou(x1, y1, x2, y2, area, boxX1[i], boxY1[i], boxX2[i], boxY2[i], boxArea[i]);
+    }
+}
+
+
+static void KalmanInit(KALMAN_AXIS &axis, float z, float positionStd, float velocityStd) {
+    axis.x = z;
+    axis.v = 0.f;
+    axis.p00 = 4.f * positionStd * positionStd;
+    axis.p01 = 0.f;
+    axis.p11 = 100.f * velocityStd * velocityStd;
+}
+
+
+static void KalmanPredict(KALMAN_AXIS &axis, float positionStd, float velocityStd) {
+    axis.x += axis.v;
+    axis.p00 += 2.f * axis.p01 + axis.p11 + positionStd * positionStd;
+    axis.p01 += axis.p11;
+    axis.p11 += velocityStd * velocityStd;
+}
+
+
+static void KalmanUpdate(KALMAN_AXIS &axis, float z, float measurementStd) {
+    float s = axis.p00 + measurementStd * measurementStd;
+    float k0 = axis.p00 / s;
+    float k1 = axis.p01 / s;
+    float residual = z - axis.x;
+    axis.x += k0 * residual;
+    axis.v += k1 * residual;
+    axis.p11 -= k1 * axis.p01;
+    axis.p00 *= 1.f - k0;
+    axis.p01 *= 1.f - k0;
+}
+
+
+static cv::Rect TrackBox(const TRACK &track) {
+    float w = std::max(track.axis[2].x, 1.f);
+    float h = std::max(track.axis[3].x, 1.f);
+    return cv::Rect(static_cast<int>(track.axis[0].x - 0.5f * w), static_cast<int>(track.axis[1].x - 0.5f * h),
+                    static_cast<int>(w), static_cast<int>(h));
+}
+
+
+Tracker::Tracker(const TRACKER_PARAM &iParam) : param(iParam) {
+    param.detectInterval = std::max(param.detectInterval, 1);
+}
+
+
+void Tracker::Reset() {
+    tracks.clear();
+    nextId = 1;
+    framesSinceDetection = 0;
+    detected = false;
+}
+
+
+bool Tracker::NeedsDetection() const {
+    if (!detected || framesSinceDetection + 1 >= param.detectInterval) {
+        return true;
+    }
+    for (const TRACK &track: tracks) {
+        if (track.visible && track.confidence < param.minTrackConfidence) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void Tracker::AdvanceTracks() {
+    for (TRACK &track: tracks) {
+        float height = std::max(track.axis[3].x, 1.f);
+        float positionStd = param.positionNoise * height;
+        float velocityStd = param.velocityNoise * height;
+        for (KALMAN_AXIS &axis: track.axis) {
+            KalmanPredict(axis, positionStd, velocityStd);
+        }
+        track.framesSinceUpdate++;
+    }
+}
+
+
+void Tracker::Associate(const std::vector<DCSP_RESULT> &detections, const std::vector<int> &detectionIndices,
+                        bool visibleTracksOnly) {
+    int trackCount = static_cast<int>(tracks.size());
+    matches.clear();
+    for (int d: detectionIndices) {
+        const cv::Rect &box = detections[d].box;
+        IouOneToMany(static_cast<float>(box.x), static_cast<float>(box.y), static_cast<float>(box.x + box.width),
+                     static_cast<float>(box.y + box.height), trackX1.data(), trackY1.data(), trackX2.data(),
+                     trackY2.data(), trackArea.data(), trackCount, ious.data());
+        for (int t = 0; t < trackCount; t++) {
+            const TRACK &track = tracks[t];
+            if (ious[t] < param.matchIou || trackMatched[t] || track.classId != detections[d].classId ||
+                (visibleTracksOnly && !track.visible)) {
+                continue;
+            }
+            matches.push_back({ious[t], t, d});
+        }
+    }
+    // Highest IoU first; ties broken by index so the assignment is deterministic.
+    std::sort(matches.begin(), matches.end(), [](const TRACK_MATCH &a, const TRACK_MATCH &b) {
+        if (a.iou != b.iou) {
+            return a.iou > b.iou;
+        }
+        return a.track != b.track ? a.track < b.track : a.detection < b.detection;
+    });
+    for (const TRACK_MATCH &match: matches) {
+        if (trackMatched[match.track] || detectionTrack[match.detection] >= 0) {
+            continue;
+        }
+        trackMatched[match.track] = 1;
+        detectionTrack[match.detection] = match.track;
+    }
+}
+
+
+void Tracker::StartTrack(DCSP_RESULT &detection) {
+    TRACK track;
+    track.id = nextId++;
+    track.classId = detection.classId;
+    track.confidence = detection.confidence;
+    const cv::Rect &box = detection.box;
+    float height = std::max(static_cast<float>(box.height), 1.f);
+    float positionStd = param.positionNoise * height;
+    float velocityStd = param.velocityNoise * height;
+    KalmanInit(track.axis[0], box.x + 0.5f * box.width, positionStd, velocityStd);
+    KalmanInit(track.axis[1], box.y + 0.5f * box.height, positionStd, velocityStd);
+    KalmanInit(track.axis[2], static_cast<float>(box.width), positionStd, velocityStd);
+    KalmanInit(track.axis[3], static_cast<float>(box.height), positionStd, velocityStd);
+    track.hits = 1;
+    track.framesSinceUpdate = 0;
+    track.visible = true;
+    detection.trackId = track.id;
+    tracks.push_back(track);
+}
+
+
+void Tracker::Update(std::vector<DCSP_RESULT> &ioDetections) {
+    AdvanceTracks();
+
+    int trackCount = static_cast<int>(tracks.size());
+    int detectionCount = static_cast<int>(ioDetections.size());
+    trackX1.resize(trackCount);
+    trackY1.resize(trackCount);
+    trackX2.resize(trackCount);
+    trackY2.resize(trackCount);
+    trackArea.resize(trackCount);
+    ious.resize(trackCount);
+    trackMatched.assign(trackCount, 0);
+    for (int t = 0; t < trackCount; t++) {
+        cv::Rect box = TrackBox(tracks[t]);
+        trackX1[t] = static_cast<float>(box.x);
+        trackY1[t] = static_cast<float>(box.y);
+        trackX2[t] = static_cast<float>(box.x + box.width);
+        trackY2[t] = static_cast<float>(box.y + box.height);
+        trackArea[t] = static_cast<float>(box.width) * box.height;
+    }
+
+    strongDetections.clear();
+    weakDetections.clear();
+    detectionTrack.assign(detectionCount, -1);
+    for (int d = 0; d < detectionCount; d++) {
+        ioDetections[d].trackId = -1;
+        (ioDetections[d].confidence >= param.highThreshold ? strongDetections : weakDetections).push_back(d);
+    }
+    Associate(ioDetections, strongDetections, false);
+    Associate(ioDetections, weakDetections, true);
+
+    for (int d = 0; d < detectionCount; d++) {
+        int t = detectionTrack[d];
+        if (t < 0) {
+            continue;
+        }
+        TRACK &track = tracks[t];
+        const cv::Rect &box = ioDetections[d].box;
+        float height = std::max(track.axis[3].x, 1.f);
+        float measurementStd = param.positionNoise * height;
+        KalmanUpdate(track.axis[0], box.x + 0.5f * box.width, measurementStd);
+        KalmanUpdate(track.axis[1], box.y + 0.5f * box.height, measurementStd);
+        KalmanUpdate(track.axis[2], static_cast<float>(box.width), measurementStd);
+        KalmanUpdate(track.axis[3], static_cast<float>(box.height), measurementStd);
+        track.confidence = ioDetections[d].confidence;
+        track.hits++;
+        track.framesSinceUpdate = 0;
+        ioDetections[d].trackId = track.id;
+    }
+
+    // Drop stale tracks before new ones are appended, so indices above stay valid until here.
+    size_t kept = 0;
+    for (int t = 0; t < trackCount; t++) {
+        TRACK &track = tracks[t];
+        track.visible = trackMatched[t] != 0;
+        if (track.framesSinceUpdate <= param.maxAge) {
+            tracks[kept++] = track;
+        }
+    }
+    tracks.resize(kept);
+    for (int d: strongDetections) {
+        if (detectionTrack[d] < 0) {
+            StartTrack(ioDetections[d]);
+        }
+    }
+
+    framesSinceDetection = 0;
+    detected = true;
+}
+
+
+void Tracker::Predict(std::vector<DCSP_RESULT> &oResults) {
+    AdvanceTracks();
+    oResults.clear();
+    for (TRACK &track: tracks) {
+        if (!track.visible) {
+            continue;
+        }
+        track.confidence *= param.confidenceDecay;
+        DCSP_RESULT result;
+        result.classId = track.classId;
+        result.confidence = track.confidence;
+        result.box = TrackBox(track);
+        result.trackId = track.id;
+        oResults.push_back(result);
+    }
+    framesSinceDetection++;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <vector>
+#include "Inference.h"
+
+
+typedef struct _TRACKER_PARAM {
+    // Run the detector on every Nth frame and predict the tracks in between; 1 detects every
+    // frame and only assigns track IDs.
+    int detectInterval = 1;
+    // Detections at or above this confidence are associated first and may start new tracks.
+    // Weaker ones only extend tracks that were visible on the previous detector frame.
+    float highThreshold = 0.5f;
+    // Minimum IoU between a predicted track box and a detection of the same class.
+    float matchIou = 0.3f;
+    // Frames a track is kept without a matching detection before it is dropped.
+    int maxAge = 30;
+    // Applied to a track's confidence on every predicted frame.
+    float confidenceDecay = 0.95f;
+    // The detector runs early once any visible track has decayed below this.
+    float minTrackConfidence = 0.25f;
+    // Kalman noise as a fraction of the box height, as in ByteTrack.
+    float positionNoise = 1.f / 20.f;
+    float velocityNoise = 1.f / 160.f;
+} TRACKER_PARAM;
+
+
+// Constant-velocity Kalman filter for one box coordinate. The cx / cy / w / h axes are
+// independent under a diagonal noise model, so four 2-state filters are exact and avoid 8x8
+// matrix algebra.
+typedef struct _KALMAN_AXIS {
+    float x;
+    float v;
+    float p00;
+    float p01;
+    float p11;
+} KALMAN_AXIS;
+
+
+typedef struct _TRACK {
+    int id;
+    int classId;
+    float confidence;
+    // cx, cy, w, h
+    KALMAN_AXIS axis[4];
+    int hits;
+    int framesSinceUpdate;
+    // Matched on the last detector frame, i.e. reported on predicted frames.
+    bool visible;
+} TRACK;
+
+
+// ByteTrack-style multi-object tracker: greedy IoU association in two passes (confident
+// detections first, then the weak ones against tracks that are already established), a Kalman
+// filter per track, and stable IDs across frames. Not thread-safe; one tracker per stream.
+class Tracker {
+public:
+    explicit Tracker(const TRACKER_PARAM &iParam = TRACKER_PARAM());
+
+    // True when the next frame should run the detector rather than Predict.
+    bool NeedsDetection() const;
+
+    // Advances the tracks to this frame and associates the detector output with them. Sets
+    // trackId on every detection that belongs to a track (new or existing); unmatched weak
+    // detections keep trackId = -1.
+    void Update(std::vector<DCSP_RESULT> &ioDetections);
+
+    // Advances the tracks to this frame without a detector run and writes the predicted boxes
+    // of the visible tracks.
+    void Predict(std::vector<DCSP_RESULT> &oResults);
+
+    void Reset();
+
+    size_t TrackCount() const { return tracks.size(); }
+
+    const TRACKER_PARAM &Param() const { return param; }
+
+private:
+    typedef struct _TRACK_MATCH {
+        float iou;
+        int track;
+        int detection;
+    } TRACK_MATCH;
+
+    void AdvanceTracks();
+
+    void Associate(const std::vector<DCSP_RESULT> &detections, const std::vector<int> &detectionIndices,
+                   bool visibleTracksOnly);
+
+    void StartTrack(DCSP_RESULT &detection);
+
+    TRACKER_PARAM param;
+    std::vector<TRACK> tracks;
+    int nextId = 1;
+    int framesSinceDetection = 0;
+    bool detected = false;
+
+    // Per-frame scratch, reused.
+    std::vector<float> trackX1;
+    std::vector<float> trackY1;
+    std::vector<float> trackX2;
+    std::vector<float> trackY2;
+    std::vector<float> trackArea;
+    std::vector<float> ious;
+    std::vector<int> strongDetections;
+    std::vector<int> weakDetections;
+    std::vector<int> detectionTrack;
+    std::vector<char> trackMatched;
+    std::vector<TRACK_MATCH> matches;
+};
+
+
+// IoU of the box (x1, y1, x2, y2) against n boxes given as structure-of-arrays corners and areas,
+// vectorized across the n boxes.
+void IouOneToMany(float x1, float y1, float x2, float y2, const float *boxX1, const float *boxY1,
+                  const float *boxX2, const float *boxY2, const float *boxArea, int n, float *oIou);
@@ -0,0 +1,142 @@
+#include "YoloDecode.h"
+#include "Simd.h"
+
+
+// Running max / argmax over numClasses rows for DECODE_ANCHOR_BLOCK consecutive anchors.
+// Class indices are tracked as floats so the select works the same on every ISA.
+static void BlockArgMax(const float *scores, int stride, int numClasses, float *best, float *bestClass) {
+#if defined(DCSP_SIMD_AVX2)
+    __m256 b0 = _mm256_loadu_ps(scores);
+    __m256 b1 = _mm256_loadu_ps(scores + 8);
+    __m256 i0 = _mm256_setzero_ps();
+    __m256 i1 = _mm256_setzero_ps();
+    for (int c = 1; c < numClasses; c++) {
+        const float *row = scores + static_cast<size_t>(c) * stride;
+        __m256 cls = _mm256_set1_ps(static_cast<float>(c));
+        __m256 v0 = _mm256_loadu_ps(row);
+        __m256 v1 = _mm256_loadu_ps(row + 8);
+        __m256 m0 = _mm256_cmp_ps(v0, b0, _CMP_GT_OQ);
+        __m256 m1 = _mm256_cmp_ps(v1, b1, _CMP_GT_OQ);
+        b0 = _mm256_max_ps(v0, b0);
+        b1 = _mm256_max_ps(v1, b1);
+        i0 = _mm256_blendv_ps(i0, cls, m0);
+        i1 = _mm256_blendv_ps(i1, cls, m1);
+    }
+    _mm256_storeu_ps(best, b0);
+    _mm256_storeu_ps(best + 8, b1);
+    _mm256_storeu_ps(bestClass, i0);
+    _mm256_storeu_ps(bestClass + 8, i1);
+#elif defined(DCSP_SIMD_SSE2)
+    __m128 b[4];
+    __m128 idx[4];
+    for (int k = 0; k < 4; k++) {
+        b[k] = _mm_loadu_ps(scores + 4 * k);
+        idx[k] = _mm_setzero_ps();
+    }
+    for (int c = 1; c < numClasses; c++) {
+        const float *row = scores + static_cast<size_t>(c) * stride;
+        __m128 cls = _mm_set1_ps(static_cast<float>(c));
+        for (int k = 0; k < 4; k++) {
+            __m128 v = _mm_loadu_ps(row + 4 * k);
+            __m128 m = _mm_cmpgt_ps(v, b[k]);
+            b[k] = _mm_max_ps(v, b[k]);
+            idx[k] = _mm_or_ps(_mm_and_ps(m, cls), _mm_andnot_ps(m, idx[k]));
+        }
+    }
+    for (int k = 0; k < 4; k++) {
+        _mm_storeu_ps(best + 4 * k, b[k]);
+        _mm_storeu_ps(bestClass + 4 * k, idx[k]);
+    }
+#elif defined(DCSP_SIMD_NEON)
+    float32x4_t b[4];
+    float32x4_t idx[4];
+    for (int k = 0; k < 4; k++) {
+        b[k] = vld1q_f32(scores + 4 * k);
+        idx[k] = vdupq_n_f32(0.f);
+    }
+    for (int c = 1; c < numClasses; c++) {
+        const float *row = scores + static_cast<size_t>(c) * stride;
+        float32x4_t cls = vdupq_n_f32(static_cast<float>(c));
+        for (int k = 0; k < 4; k++) {
+            float32x4_t v = vld1q_f32(row + 4 * k);
+            uint32x4_t m = vcgtq_f32(v, b[k]);
+            b[k] = vmaxq_f32(v, b[k]);
+            idx[k] = vbslq_f32(m, cls, idx[k]);
+        }
+    }
+    for (int k = 0; k < 4; k++) {
+        vst1q_f32(best + 4 * k, b[k]);
+        vst1q_f32(bestClass + 4 * k, idx[k]);
+    }
+#else
+    for (int k = 0; k < DECODE_ANCHOR_BLOCK; k++) {
+        best[k] = scores[k];
+        bestClass[k] = 0.f;
+    }
+    for (int c = 1; c < numClasses; c++) {
+        const float *row = scores + static_cast<size_t>(c) * stride;
+        for (int k = 0; k < DECODE_ANCHOR_BLOCK; k++) {
+            if (row[k] > best[k]) {
+                best[k] = row[k];
+                bestClass[k] = static_cast<float>(c);
+            }
+        }
+    }
+#endif
+}
+
+
+static inline void EmitCandidate(const float *output, int numAnchors, int anchor, float score, int classId,
+                                 const LETTERBOX_INFO &letterbox, std::vector<DCSP_CANDIDATE> &oCandidates) {
+    float cx = output[anchor];
+    float cy = output[numAnchors + anchor];
+    float w = output[2 * static_cast<size_t>(numAnchors) + anchor];
+    float h = output[3 * static_cast<size_t>(numAnchors) + anchor];
+    DCSP_CANDIDATE candidate;
+    candidate.x = (cx - 0.5f * w - letterbox.padX) / letterbox.scaleX;
+    candidate.y = (cy - 0.5f * h - letterbox.padY) / letterbox.scaleY;
+    candidate.width = w / letterbox.scaleX;
+    candidate.height = h / letterbox.scaleY;
+    candidate.confidence = score;
+    candidate.classId = classId;
+    oCandidates.push_back(candidate);
+}
+
+
+char *DecodeYoloV8(const float *output, int numChannels, int numAnchors, float threshold,
+                   const LETTERBOX_INFO &letterbox, std::vector<DCSP_CANDIDATE> &oCandidates) {
+    oCandidates.clear();
+    int numClasses = numChannels - 4;
+    if (output == nullptr || numClasses <= 0 || numAnchors <= 0) {
+        return "[DCSP_ONNX]:Unexpected YOLOv8 output shape.";
+    }
+    const float *scores = output + 4 * static_cast<size_t>(numAnchors);
+
+    float best[DECODE_ANCHOR_BLOCK];
+    float bestClass[DECODE_ANCHOR_BLOCK];
+    int anchor = 0;
+    for (; anchor + DECODE_ANCHOR_BLOCK <= numAnchors; anchor += DECODE_ANCHOR_BLOCK) {
+        BlockArgMax(scores + anchor, numAnchors, numClasses, best, bestClass);
+        for (int k = 0; k < DECODE_ANCHOR_BLOCK; k++) {
+            if (best[k] > threshold) {
+                EmitCandidate(output, numAnchors, anchor + k, best[k], static_cast<int>(bestClass[k]), letterbox,
+                              oCandidates);
+            }
+        }
+    }
+    for (; anchor < numAnchors; anchor++) {
+        float bestScore = scores[anchor];
+        int bestId = 0;
+        for (int c = 1; c < numClasses; c++) {
+            float score = scores[static_cast<size_t>(c) * numAnchors + anchor];
+            if (score > bestScore) {
+                bestScore = score;
+                bestId = c;
+            }
+        }
+        if (bestScore > threshold) {
+            EmitCandidate(output, numAnchors, anchor, bestScore, bestId, letterbox, oCandidates);
+        }
+    }
+    return RET_OK;
+}
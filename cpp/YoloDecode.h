@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef RET_OK
+#define RET_OK nullptr
+#endif
+
+#include <vector>
+#include "Preprocess.h"
+
+
+// A detection before NMS, in source image pixels.
+typedef struct _DCSP_CANDIDATE {
+    float x;
+    float y;
+    float width;
+    float height;
+    float confidence;
+    int classId;
+} DCSP_CANDIDATE;
+
+
+// Anchors scored together per step; 16 floats fill one 64-byte cache line of every class row.
+constexpr int DECODE_ANCHOR_BLOCK = 16;
+
+
+// Decodes a channel-major YOLOv8 head of shape [4 + numClasses, numAnchors] (cx, cy, w, h rows
+// followed by one row per class) without transposing it. Keeps a running per-anchor max / argmax
+// over the class rows for a block of anchors at a time and only touches the box rows of anchors
+// whose best score is above the threshold. Boxes are mapped back through the letterbox.
+char *DecodeYoloV8(const float *output, int numChannels, int numAnchors, float threshold,
+                   const LETTERBOX_INFO &letterbox, std::vector<DCSP_CANDIDATE> &oCandidates);
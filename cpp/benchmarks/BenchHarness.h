@@ -0,0 +1,101 @@
+#pragma once
+
+// Minimal Google-Benchmark-style harness so the kernels can be measured on a desktop
+// without any extra dependency:
+//
+//   BENCH(MyKernel) {
+//       Setup();                          // not timed
+//       while (state.KeepRunning()) {     // each iteration is timed individually
+//           bench::DoNotOptimize(Run());
+//       }
+//   }
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+class State {
+public:
+    State(double minSeconds, size_t maxIterations) : minSeconds_(minSeconds), maxIterations_(maxIterations) {}
+
+    bool KeepRunning() {
+        Clock::time_point now = Clock::now();
+        if (running_) {
+            samples_.push_back(std::chrono::duration<double, std::nano>(now - last_).count());
+            total_ += now - last_;
+        }
+        if (samples_.size() >= maxIterations_ ||
+            std::chrono::duration<double>(total_).count() >= minSeconds_) {
+            running_ = false;
+            return false;
+        }
+        running_ = true;
+        last_ = Clock::now();
+        return true;
+    }
+
+    void SetLabel(std::string label) { label_ = std::move(label); }
+
+    void SetItemsProcessed(size_t itemsPerIteration) { itemsPerIteration_ = itemsPerIteration; }
+
+    const std::vector<double> &samples() const { return samples_; }
+
+    const std::string &label() const { return label_; }
+
+    size_t itemsPerIteration() const { return itemsPerIteration_; }
+
+private:
+    double minSeconds_;
+    size_t maxIterations_;
+    bool running_ = false;
+    Clock::time_point last_;
+    Clock::duration total_{0};
+    std::vector<double> samples_;
+    std::string label_;
+    size_t itemsPerIteration_ = 0;
+};
+
+struct Case {
+    std::string name;
+    std::function<void(State &)> body;
+};
+
+inline std::vector<Case> &Registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+struct Registrar {
+    Registrar(const char *name, std::function<void(State &)> body) {
+        Registry().push_back({name, std::move(body)});
+    }
+};
+
+template<typename T>
+inline void DoNotOptimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T *sink;
+    sink = &value;
+#endif
+}
+
+int RunAll(int argc, char **argv);
+
+} // namespace bench
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+
+#define BENCH(name)                                                                   \
+    static void name(bench::State &state);                                            \
+    static bench::Registrar BENCH_CONCAT(name, _registrar)(#name, name);              \
+    static void name(bench::State &state)
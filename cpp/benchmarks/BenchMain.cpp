@@ -0,0 +1,62 @@
+// Host-side benchmark runner, built as dcsp_bench by cpp/CMakeLists.txt together with every
+// *Benchmark.cpp file and the core library. Without CMake:
+//
+//   g++ -O3 -march=native -std=c++20 -I cpp -I <onnxruntime>/include cpp/benchmarks/*.cpp
+//       cpp/Preprocess.cpp cpp/YoloDecode.cpp cpp/Nms.cpp cpp/DetectionOutput.cpp cpp/CpuTopology.cpp
+//       cpp/PerfStats.cpp $(pkg-config --cflags --libs opencv4) -L <onnxruntime>/lib -lonnxruntime -o dcsp_bench
+//
+// Kernel benchmarks run on synthetic frames and tensors and need no model file. The ORT thread
+// sweep additionally runs against DCSP_BENCH_MODEL=<model.onnx>.
+//
+// Usage: dcsp_bench [filter] [--min-time=<seconds>]
+
+#include "BenchHarness.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace bench {
+
+int RunAll(int argc, char **argv) {
+    std::string filter;
+    double minSeconds = 1.0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+            minSeconds = std::atof(argv[i] + 11);
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    std::printf("%-48s %12s %12s %12s %10s\n", "benchmark", "median(us)", "p90(us)", "min(us)", "iters");
+    for (const Case &c: Registry()) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        State state(minSeconds, 100000);
+        c.body(state);
+        std::vector<double> samples = state.samples();
+        if (samples.empty()) {
+            std::printf("%-48s %12s\n", c.name.c_str(), "skipped");
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        double median = samples[samples.size() / 2] / 1000.0;
+        double p90 = samples[std::min(samples.size() - 1, samples.size() * 9 / 10)] / 1000.0;
+        double fastest = samples.front() / 1000.0;
+        std::printf("%-48s %12.2f %12.2f %12.2f %10zu", c.name.c_str(), median, p90, fastest, samples.size());
+        if (state.itemsPerIteration() > 0) {
+            std::printf("  %.1f Mitems/s", state.itemsPerIteration() / median);
+        }
+        if (!state.label().empty()) {
+            std::printf("  %s", state.label().c_str());
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
+
+} // namespace bench
+
+int main(int argc, char **argv) {
+    return bench::RunAll(argc, argv);
+}
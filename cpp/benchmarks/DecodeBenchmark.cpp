@@ -0,0 +1,117 @@
+// Blocked DecodeYoloV8 vs. the original transpose + per-anchor minMaxLoc loop from TensorProcess,
+// on synthetic [84, 8400] heads (YOLOv8 at 640x640, 80 classes) with a controlled number of
+// anchors above the confidence threshold.
+
+#include "BenchHarness.h"
+#include "Nms.h"
+#include "YoloDecode.h"
+#include <opencv2/opencv.hpp>
+#include <random>
+
+namespace {
+
+constexpr int kNumClasses = 80;
+constexpr int kNumAnchors = 8400;
+constexpr float kThreshold = 0.5f;
+
+// Every score is below kThreshold except one class of `candidates` evenly spread anchors.
+std::vector<float> SyntheticHead(int candidates) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    int channels = 4 + kNumClasses;
+    std::vector<float> head(static_cast<size_t>(channels) * kNumAnchors);
+    for (int a = 0; a < kNumAnchors; a++) {
+        head[a] = unit(rng) * 640.f;
+        head[kNumAnchors + a] = unit(rng) * 640.f;
+        head[2 * kNumAnchors + a] = 8.f + unit(rng) * 200.f;
+        head[3 * kNumAnchors + a] = 8.f + unit(rng) * 200.f;
+    }
+    for (size_t i = 4 * static_cast<size_t>(kNumAnchors); i < head.size(); i++) {
+        head[i] = unit(rng) * 0.3f;
+    }
+    for (int k = 0; k < candidates; k++) {
+        int anchor = static_cast<int>(static_cast<long long>(k) * kNumAnchors / candidates);
+        int classId = static_cast<int>(rng() % kNumClasses);
+        head[static_cast<size_t>(4 + classId) * kNumAnchors + anchor] = 0.6f + 0.4f * unit(rng);
+    }
+    return head;
+}
+
+LETTERBOX_INFO FrameLetterbox() {
+    // 1920x1080 letterboxed into 640x640.
+    LETTERBOX_INFO info;
+    info.scaleX = info.scaleY = 640.f / 1920.f;
+    info.padX = 0.f;
+    info.padY = (640.f - 1080.f * info.scaleY) * 0.5f;
+    return info;
+}
+
+void RunReference(bench::State &state, int candidates) {
+    std::vector<float> head = SyntheticHead(candidates);
+    int channels = 4 + kNumClasses;
+    std::vector<int> classIds;
+    std::vector<float> confidences;
+    std::vector<cv::Rect> boxes;
+    while (state.KeepRunning()) {
+        classIds.clear();
+        confidences.clear();
+        boxes.clear();
+        cv::Mat rawData = cv::Mat(channels, kNumAnchors, CV_32F, head.data()).t();
+        float *data = reinterpret_cast<float *>(rawData.data);
+        for (int i = 0; i < kNumAnchors; i++) {
+            cv::Mat scores(1, kNumClasses, CV_32FC1, data + 4);
+            cv::Point classId;
+            double maxClassScore;
+            cv::minMaxLoc(scores, nullptr, &maxClassScore, nullptr, &classId);
+            if (maxClassScore > kThreshold) {
+                confidences.push_back(static_cast<float>(maxClassScore));
+                classIds.push_back(classId.x);
+                boxes.emplace_back(int((data[0] - 0.5f * data[2]) * 3.f), int((data[1] - 0.5f * data[3]) * 3.f),
+                                   int(data[2] * 3.f), int(data[3] * 3.f));
+            }
+            data += channels;
+        }
+        bench::DoNotOptimize(boxes.size());
+    }
+    state.SetItemsProcessed(kNumAnchors);
+}
+
+void RunBlocked(bench::State &state, int candidates) {
+    std::vector<float> head = SyntheticHead(candidates);
+    LETTERBOX_INFO letterbox = FrameLetterbox();
+    std::vector<DCSP_CANDIDATE> decoded;
+    while (state.KeepRunning()) {
+        DecodeYoloV8(head.data(), 4 + kNumClasses, kNumAnchors, kThreshold, letterbox, decoded);
+        bench::DoNotOptimize(decoded.size());
+    }
+    state.SetItemsProcessed(kNumAnchors);
+}
+
+// Everything TensorProcess does after session->Run for an FP32 head.
+void RunDecodeNms(bench::State &state, int candidates) {
+    std::vector<float> head = SyntheticHead(candidates);
+    LETTERBOX_INFO letterbox = FrameLetterbox();
+    std::vector<DCSP_CANDIDATE> decoded;
+    NmsEngine engine;
+    NMS_PARAM param;
+    std::vector<int> keep;
+    while (state.KeepRunning()) {
+        DecodeYoloV8(head.data(), 4 + kNumClasses, kNumAnchors, kThreshold, letterbox, decoded);
+        engine.Run(decoded, param, keep);
+        bench::DoNotOptimize(keep.size());
+    }
+    state.SetItemsProcessed(kNumAnchors);
+}
+
+} // namespace
+
+BENCH(Decode_Reference_0cand) { RunReference(state, 0); }
+BENCH(Decode_Blocked_0cand) { RunBlocked(state, 0); }
+BENCH(Decode_Reference_100cand) { RunReference(state, 100); }
+BENCH(Decode_Blocked_100cand) { RunBlocked(state, 100); }
+BENCH(Decode_Reference_1000cand) { RunReference(state, 1000); }
+BENCH(Decode_Blocked_1000cand) { RunBlocked(state, 1000); }
+BENCH(Decode_Reference_8400cand) { RunReference(state, kNumAnchors); }
+BENCH(Decode_Blocked_8400cand) { RunBlocked(state, kNumAnchors); }
+BENCH(DecodeNms_Blocked_100cand) { RunDecodeNms(state, 100); }
+BENCH(DecodeNms_Blocked_1000cand) { RunDecodeNms(state, 1000); }
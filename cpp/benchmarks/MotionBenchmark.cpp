@@ -0,0 +1,52 @@
+// MotionGate pre-stage: luma thumbnails of full camera frames and the SAD between two of them.
+
+#include "BenchHarness.h"
+#include "MotionGate.h"
+#include <random>
+
+namespace {
+
+std::vector<uint8_t> NoisyPlane(size_t bytes, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> plane(bytes);
+    for (uint8_t &value: plane) {
+        value = static_cast<uint8_t>(rng());
+    }
+    return plane;
+}
+
+void RunYuvThumbnail(bench::State &state, int width, int height) {
+    std::vector<uint8_t> nv21 = NoisyPlane(static_cast<size_t>(width) * height * 3 / 2, 1);
+    YUV_IMAGE image = WrapNV21(nv21.data(), width, height, width);
+    uint8_t thumb[MOTION_THUMB_PIXELS];
+    while (state.KeepRunning()) {
+        LumaThumbnail(image, thumb);
+        bench::DoNotOptimize(thumb[0]);
+    }
+}
+
+void RunBgrThumbnail(bench::State &state, int width, int height) {
+    std::vector<uint8_t> bgr = NoisyPlane(static_cast<size_t>(width) * height * 3, 2);
+    cv::Mat image(height, width, CV_8UC3, bgr.data());
+    uint8_t thumb[MOTION_THUMB_PIXELS];
+    while (state.KeepRunning()) {
+        LumaThumbnail(image, thumb);
+        bench::DoNotOptimize(thumb[0]);
+    }
+}
+
+void RunSad(bench::State &state) {
+    std::vector<uint8_t> a = NoisyPlane(MOTION_THUMB_PIXELS, 3);
+    std::vector<uint8_t> b = NoisyPlane(MOTION_THUMB_PIXELS, 4);
+    while (state.KeepRunning()) {
+        bench::DoNotOptimize(SumAbsDiff(a.data(), b.data(), MOTION_THUMB_PIXELS));
+    }
+    state.SetItemsProcessed(MOTION_THUMB_PIXELS);
+}
+
+} // namespace
+
+BENCH(Motion_Sad_Thumbnail) { RunSad(state); }
+BENCH(Motion_Thumbnail_Yuv_1080p) { RunYuvThumbnail(state, 1920, 1080); }
+BENCH(Motion_Thumbnail_Bgr_1080p) { RunBgrThumbnail(state, 1920, 1080); }
+BENCH(Motion_Thumbnail_Yuv_4K) { RunYuvThumbnail(state, 3840, 2160); }
@@ -0,0 +1,77 @@
+// NmsEngine vs. cv::dnn::NMSBoxes on synthetic crowded scenes.
+
+#include "BenchHarness.h"
+#include "Nms.h"
+#include <random>
+
+namespace {
+
+// Clusters of jittered boxes around random centres, like a dense crowd at 1080p.
+std::vector<DCSP_CANDIDATE> SyntheticCandidates(int count, int numClasses) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<DCSP_CANDIDATE> candidates;
+    candidates.reserve(count);
+    while (static_cast<int>(candidates.size()) < count) {
+        float cx = unit(rng) * 1920.f;
+        float cy = unit(rng) * 1080.f;
+        float size = 20.f + unit(rng) * 120.f;
+        int classId = static_cast<int>(rng() % numClasses);
+        for (int j = 0; j < 8 && static_cast<int>(candidates.size()) < count; j++) {
+            DCSP_CANDIDATE c;
+            c.width = size * (0.9f + 0.2f * unit(rng));
+            c.height = size * (0.9f + 0.2f * unit(rng));
+            c.x = cx + (unit(rng) - 0.5f) * 0.2f * size - 0.5f * c.width;
+            c.y = cy + (unit(rng) - 0.5f) * 0.2f * size - 0.5f * c.height;
+            c.confidence = 0.25f + 0.75f * unit(rng);
+            c.classId = classId;
+            candidates.push_back(c);
+        }
+    }
+    return candidates;
+}
+
+void RunOpenCv(bench::State &state, int count) {
+    std::vector<DCSP_CANDIDATE> candidates = SyntheticCandidates(count, 80);
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    std::vector<int> keep;
+    while (state.KeepRunning()) {
+        // Include the conversion to integer cv::Rect the old TensorProcess had to do.
+        boxes.clear();
+        scores.clear();
+        for (const DCSP_CANDIDATE &c: candidates) {
+            boxes.emplace_back(int(c.x), int(c.y), int(c.width), int(c.height));
+            scores.push_back(c.confidence);
+        }
+        cv::dnn::NMSBoxes(boxes, scores, 0.25f, 0.5f, keep);
+        bench::DoNotOptimize(keep.size());
+    }
+    state.SetLabel(std::to_string(keep.size()) + " kept");
+}
+
+void RunEngine(bench::State &state, int count, bool classAware) {
+    std::vector<DCSP_CANDIDATE> candidates = SyntheticCandidates(count, 80);
+    NmsEngine engine;
+    NMS_PARAM param;
+    param.topK = 0;
+    param.maxDetections = 0;
+    param.classAware = classAware;
+    std::vector<int> keep;
+    while (state.KeepRunning()) {
+        engine.Run(candidates, param, keep);
+        bench::DoNotOptimize(keep.size());
+    }
+    state.SetLabel(std::to_string(keep.size()) + " kept");
+}
+
+} // namespace
+
+BENCH(Nms_OpenCv_100) { RunOpenCv(state, 100); }
+BENCH(Nms_Engine_100) { RunEngine(state, 100, false); }
+BENCH(Nms_OpenCv_1000) { RunOpenCv(state, 1000); }
+BENCH(Nms_Engine_1000) { RunEngine(state, 1000, false); }
+BENCH(Nms_Engine_1000_ClassAware) { RunEngine(state, 1000, true); }
+BENCH(Nms_OpenCv_5000) { RunOpenCv(state, 5000); }
+BENCH(Nms_Engine_5000) { RunEngine(state, 5000, false); }
+BENCH(Nms_Engine_5000_ClassAware) { RunEngine(state, 5000, true); }
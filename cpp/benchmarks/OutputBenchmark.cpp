@@ -0,0 +1,78 @@
+// Detection marshalling: the per-detection JSON strings (as std::string and formatted into the
+// frame arena detectionsToJsi uses) vs. the packed Float32Array layout. Measures only the C++ side, not the jsi::String / TypedArray creation.
+
+#include "BenchHarness.h"
+#include "DetectionOutput.h"
+#include <random>
+
+namespace {
+
+std::vector<DCSP_RESULT> SyntheticResults(int count) {
+    std::mt19937 rng(11);
+    std::vector<DCSP_RESULT> results(count);
+    for (DCSP_RESULT &result: results) {
+        result.classId = static_cast<int>(rng() % 80);
+        result.confidence = 0.5f + static_cast<float>(rng() % 500) / 1000.f;
+        result.box = cv::Rect(static_cast<int>(rng() % 1800), static_cast<int>(rng() % 1000),
+                              20 + static_cast<int>(rng() % 200), 20 + static_cast<int>(rng() % 200));
+    }
+    return results;
+}
+
+std::vector<std::string> CocoLikeClasses() {
+    std::vector<std::string> classes;
+    for (int i = 0; i < 80; i++) {
+        classes.push_back("class_" + std::to_string(i));
+    }
+    return classes;
+}
+
+void RunJson(bench::State &state, int count) {
+    std::vector<DCSP_RESULT> results = SyntheticResults(count);
+    std::vector<std::string> classes = CocoLikeClasses();
+    std::vector<std::string> formatted;
+    while (state.KeepRunning()) {
+        formatted.clear();
+        for (const DCSP_RESULT &result: results) {
+            formatted.push_back(FormatDetectionJson(result, classes));
+        }
+        bench::DoNotOptimize(formatted.data());
+    }
+    state.SetItemsProcessed(count);
+}
+
+void RunJsonArena(bench::State &state, int count) {
+    std::vector<DCSP_RESULT> results = SyntheticResults(count);
+    std::vector<std::string> classes = CocoLikeClasses();
+    FrameArena arena(4096);
+    while (state.KeepRunning()) {
+        for (const DCSP_RESULT &result: results) {
+            size_t length = 0;
+            bench::DoNotOptimize(FormatDetectionJson(result, classes, arena, length));
+        }
+        arena.Reset();
+    }
+    state.SetItemsProcessed(count);
+}
+
+void RunPacked(bench::State &state, int count) {
+    std::vector<DCSP_RESULT> results = SyntheticResults(count);
+    std::vector<float> packed(PackedDetectionsLength(results.size()));
+    while (state.KeepRunning()) {
+        PackDetections(results, packed.data());
+        bench::DoNotOptimize(packed[0]);
+    }
+    state.SetItemsProcessed(count);
+}
+
+} // namespace
+
+BENCH(Output_Json_10) { RunJson(state, 10); }
+BENCH(Output_JsonArena_10) { RunJsonArena(state, 10); }
+BENCH(Output_Packed_10) { RunPacked(state, 10); }
+BENCH(Output_Json_100) { RunJson(state, 100); }
+BENCH(Output_JsonArena_100) { RunJsonArena(state, 100); }
+BENCH(Output_Packed_100) { RunPacked(state, 100); }
+BENCH(Output_Json_300) { RunJson(state, 300); }
+BENCH(Output_JsonArena_300) { RunJsonArena(state, 300); }
+BENCH(Output_Packed_300) { RunPacked(state, 300); }
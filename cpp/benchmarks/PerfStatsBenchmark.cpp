@@ -0,0 +1,32 @@
+// Cost of a PerfTimer scope with stats disabled (one relaxed load) and enabled (two clock reads
+// plus the histogram update). Timed in batches because a single scope is below clock resolution.
+
+#include "BenchHarness.h"
+#include "PerfStats.h"
+
+namespace {
+
+constexpr int kScopesPerIteration = 1000;
+
+void RunScopes(bench::State &state, bool enabled) {
+    SetPerfStatsEnabled(enabled);
+    state.SetItemsProcessed(kScopesPerIteration);
+    while (state.KeepRunning()) {
+        for (int i = 0; i < kScopesPerIteration; i++) {
+            PerfTimer timer(PERF_DECODE);
+        }
+    }
+    SetPerfStatsEnabled(false);
+    PERF_STAGE_STATS stats[PERF_STAGE_COUNT];
+    GetPerfStats(stats, true);
+}
+
+}  // namespace
+
+BENCH(PerfTimer_Disabled_x1000) {
+    RunScopes(state, false);
+}
+
+BENCH(PerfTimer_Enabled_x1000) {
+    RunScopes(state, true);
+}
@@ -0,0 +1,94 @@
+// Fused letterbox kernel vs. the original PostProcess + BlobFromImage path, plus the YUV variant.
+
+#include "BenchHarness.h"
+#include "Preprocess.h"
+#include "Tiling.h"
+
+namespace {
+
+cv::Mat SyntheticFrame(int width, int height, int channels) {
+    cv::Mat frame(height, width, CV_8UC(channels));
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+    return frame;
+}
+
+void RunReference(bench::State &state, int width, int height) {
+    cv::Mat frame = SyntheticFrame(width, height, 3);
+    std::vector<int> imgSize = {640, 640};
+    std::vector<float> blob(3 * 640 * 640);
+    float *blobPtr = blob.data();
+    while (state.KeepRunning()) {
+        cv::Mat processed;
+        PostProcess(frame, imgSize, processed);
+        BlobFromImage(processed, blobPtr);
+        bench::DoNotOptimize(blobPtr[0]);
+    }
+    state.SetItemsProcessed(static_cast<size_t>(width) * height);
+}
+
+void RunFused(bench::State &state, int width, int height, int channels) {
+    cv::Mat frame = SyntheticFrame(width, height, channels);
+    std::vector<float> blob(3 * 640 * 640);
+    PreprocessWorkspace workspace;
+    LETTERBOX_INFO info;
+    while (state.KeepRunning()) {
+        PreprocessLetterbox(frame, 640, 640, blob.data(), workspace, info);
+        bench::DoNotOptimize(blob[0]);
+    }
+    state.SetItemsProcessed(static_cast<size_t>(width) * height);
+}
+
+// The CPU side of RunTiledSession: every tile (and the whole frame) letterboxed into one batch.
+void RunTiles(bench::State &state, int width, int height, int columns, int rows) {
+    cv::Mat frame = SyntheticFrame(width, height, 3);
+    TILE_PARAM param;
+    param.columns = columns;
+    param.rows = rows;
+    std::vector<cv::Rect> tiles;
+    ComputeTiles(width, height, param, tiles);
+    size_t planeSize = 3 * 640 * 640;
+    std::vector<float> blob(planeSize * tiles.size());
+    PreprocessWorkspace tileWorkspace;
+    PreprocessWorkspace frameWorkspace;
+    LETTERBOX_INFO info;
+    while (state.KeepRunning()) {
+        for (size_t b = 0; b < tiles.size(); b++) {
+            bool whole = tiles[b].width == width && tiles[b].height == height;
+            PreprocessLetterbox(frame(tiles[b]), 640, 640, blob.data() + b * planeSize,
+                                whole ? frameWorkspace : tileWorkspace, info);
+        }
+        bench::DoNotOptimize(blob[0]);
+    }
+    state.SetLabel(std::to_string(tiles.size()) + " batch entries");
+}
+
+void RunYuv(bench::State &state, int width, int height) {
+    // NV21 as delivered by the camera: full-resolution Y plane followed by interleaved VU.
+    std::vector<uint8_t> nv21(static_cast<size_t>(width) * height * 3 / 2);
+    cv::Mat wrapped(1, static_cast<int>(nv21.size()), CV_8UC1, nv21.data());
+    cv::randu(wrapped, cv::Scalar::all(0), cv::Scalar::all(255));
+    YUV_IMAGE image = WrapNV21(nv21.data(), width, height, width);
+    std::vector<float> blob(3 * 640 * 640);
+    PreprocessWorkspace workspace;
+    LETTERBOX_INFO info;
+    while (state.KeepRunning()) {
+        PreprocessYuvLetterbox(image, 640, 640, blob.data(), workspace, info);
+        bench::DoNotOptimize(blob[0]);
+    }
+    state.SetItemsProcessed(static_cast<size_t>(width) * height);
+}
+
+} // namespace
+
+BENCH(Preprocess_Reference_480p) { RunReference(state, 640, 480); }
+BENCH(Preprocess_Fused_480p) { RunFused(state, 640, 480, 3); }
+BENCH(Preprocess_Reference_720p) { RunReference(state, 1280, 720); }
+BENCH(Preprocess_Fused_720p) { RunFused(state, 1280, 720, 3); }
+BENCH(Preprocess_Reference_1080p) { RunReference(state, 1920, 1080); }
+BENCH(Preprocess_Fused_1080p) { RunFused(state, 1920, 1080, 3); }
+BENCH(Preprocess_Fused_1080p_RGBA) { RunFused(state, 1920, 1080, 4); }
+BENCH(Preprocess_Yuv_480p) { RunYuv(state, 640, 480); }
+BENCH(Preprocess_Yuv_720p) { RunYuv(state, 1280, 720); }
+BENCH(Preprocess_Yuv_1080p) { RunYuv(state, 1920, 1080); }
+BENCH(Preprocess_Tiles_2x2_1080p) { RunTiles(state, 1920, 1080, 2, 2); }
+BENCH(Preprocess_Tiles_3x2_1080p) { RunTiles(state, 1920, 1080, 3, 2); }
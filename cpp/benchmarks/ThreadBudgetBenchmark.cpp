@@ -0,0 +1,128 @@
+// Sweeps the THREAD_BUDGET knobs on the host: OpenCV pool size for cv::resize, and, when built
+// against ONNX Runtime with DCSP_BENCH_MODEL=<model.onnx> set, ORT intra-op threads x spinning
+// x big-core pinning for a full session->Run. Each ORT case uses its own per-session pool so
+// the whole grid runs in one process.
+
+#include "BenchHarness.h"
+#include "CpuTopology.h"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <opencv2/opencv.hpp>
+
+#if __has_include("onnxruntime_cxx_api.h")
+#include "onnxruntime_cxx_api.h"
+#define DCSP_BENCH_HAVE_ORT 1
+#endif
+
+namespace {
+
+std::vector<int> ThreadCounts() {
+    int cores = GetCpuTopology().coreCount;
+    std::vector<int> counts = {1, 2, 4, cores};
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    counts.erase(std::remove_if(counts.begin(), counts.end(), [cores](int n) { return n > cores; }), counts.end());
+    return counts;
+}
+
+void RunOpenCvResize(bench::State &state, int threads) {
+    cv::Mat frame(1080, 1920, CV_8UC3);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::Mat resized;
+    int previous = cv::getNumThreads();
+    cv::setNumThreads(threads);
+    while (state.KeepRunning()) {
+        cv::resize(frame, resized, cv::Size(640, 360), 0, 0, cv::INTER_LINEAR);
+        bench::DoNotOptimize(resized.data);
+    }
+    cv::setNumThreads(previous);
+    state.SetItemsProcessed(1920 * 1080);
+}
+
+#ifdef DCSP_BENCH_HAVE_ORT
+std::vector<int> AllCores() {
+    std::vector<int> cores(GetCpuTopology().coreCount);
+    for (size_t i = 0; i < cores.size(); i++) {
+        cores[i] = static_cast<int>(i);
+    }
+    return cores;
+}
+
+Ort::Env &BenchEnv() {
+    static Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "ThreadBudgetBenchmark");
+    return env;
+}
+
+void RunOrtSession(bench::State &state, int threads, bool spinning, bool pinBig) {
+    const char *modelPath = std::getenv("DCSP_BENCH_MODEL");
+    if (modelPath == nullptr) {
+        return;
+    }
+    const CPU_TOPOLOGY &topology = GetCpuTopology();
+    const std::vector<int> cores = pinBig ? topology.bigCores : AllCores();
+
+    Ort::SessionOptions options;
+    options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    options.SetIntraOpNumThreads(threads);
+    options.AddConfigEntry("session.intra_op.allow_spinning", spinning ? "1" : "0");
+    std::string affinity = IntraOpAffinityString(threads, cores);
+    if (!affinity.empty()) {
+        options.AddConfigEntry("session.intra_op_thread_affinities", affinity.c_str());
+    }
+    Ort::Session session(BenchEnv(), modelPath, options);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    Ort::AllocatedStringPtr inputName = session.GetInputNameAllocated(0, allocator);
+    Ort::AllocatedStringPtr outputName = session.GetOutputNameAllocated(0, allocator);
+    std::vector<int64_t> dims = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    size_t elements = 1;
+    for (int64_t &dim: dims) {
+        dim = dim > 0 ? dim : 1;
+        elements *= static_cast<size_t>(dim);
+    }
+    std::vector<float> input(elements, 0.5f);
+    Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(memoryInfo, input.data(), input.size(),
+                                                             dims.data(), dims.size());
+    const char *inputNames[] = {inputName.get()};
+    const char *outputNames[] = {outputName.get()};
+
+    // The calling thread is one of the intra-op workers.
+    PinCurrentThread(cores);
+    session.Run(Ort::RunOptions{nullptr}, inputNames, &inputTensor, 1, outputNames, 1);
+    while (state.KeepRunning()) {
+        auto outputs = session.Run(Ort::RunOptions{nullptr}, inputNames, &inputTensor, 1, outputNames, 1);
+        bench::DoNotOptimize(outputs.front().GetTensorData<float>());
+    }
+    PinCurrentThread(AllCores());
+    state.SetLabel("intra=" + std::to_string(threads) + (spinning ? " spin" : " nospin") +
+                   (pinBig ? " big" : " any"));
+}
+#endif
+
+struct SweepRegistrar {
+    SweepRegistrar() {
+        for (int threads: ThreadCounts()) {
+            bench::Registry().push_back({"ThreadBudget_OpenCvResize_1080p/threads=" + std::to_string(threads),
+                                         [threads](bench::State &state) { RunOpenCvResize(state, threads); }});
+        }
+#ifdef DCSP_BENCH_HAVE_ORT
+        for (int threads: ThreadCounts()) {
+            for (bool spinning: {false, true}) {
+                for (bool pinBig: {false, true}) {
+                    std::string name = "ThreadBudget_OrtRun/threads=" + std::to_string(threads) +
+                                       "/spin=" + (spinning ? "1" : "0") + "/big=" + (pinBig ? "1" : "0");
+                    bench::Registry().push_back({name, [threads, spinning, pinBig](bench::State &state) {
+                        RunOrtSession(state, threads, spinning, pinBig);
+                    }});
+                }
+            }
+        }
+#endif
+    }
+};
+
+SweepRegistrar sweepRegistrar;
+
+} // namespace
@@ -0,0 +1,74 @@
+// Tracker association (vectorized IoU + greedy matching) on synthetic moving crowds.
+
+#include "BenchHarness.h"
+#include "Tracker.h"
+#include <random>
+
+namespace {
+
+// `count` boxes drifting across a 1080p frame, with a little jitter per frame like detector noise.
+std::vector<std::vector<DCSP_RESULT>> SyntheticSequence(int count, int frames) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<float> cx(count), cy(count), vx(count), vy(count), size(count);
+    for (int i = 0; i < count; i++) {
+        cx[i] = unit(rng) * 1920.f;
+        cy[i] = unit(rng) * 1080.f;
+        vx[i] = (unit(rng) - 0.5f) * 8.f;
+        vy[i] = (unit(rng) - 0.5f) * 8.f;
+        size[i] = 30.f + unit(rng) * 90.f;
+    }
+    std::vector<std::vector<DCSP_RESULT>> sequence(frames);
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < count; i++) {
+            DCSP_RESULT r;
+            r.classId = i % 4;
+            r.confidence = 0.3f + 0.7f * unit(rng);
+            float jitter = (unit(rng) - 0.5f) * 2.f;
+            int w = static_cast<int>(size[i] + jitter);
+            int h = static_cast<int>(size[i] - jitter);
+            r.box = cv::Rect(static_cast<int>(cx[i] + vx[i] * f) - w / 2, static_cast<int>(cy[i] + vy[i] * f) - h / 2, w, h);
+            sequence[f].push_back(r);
+        }
+    }
+    return sequence;
+}
+
+void RunIou(bench::State &state, int n) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<float> x1(n), y1(n), x2(n), y2(n), area(n), iou(n);
+    for (int i = 0; i < n; i++) {
+        x1[i] = unit(rng) * 1800.f;
+        y1[i] = unit(rng) * 1000.f;
+        x2[i] = x1[i] + 20.f + unit(rng) * 100.f;
+        y2[i] = y1[i] + 20.f + unit(rng) * 100.f;
+        area[i] = (x2[i] - x1[i]) * (y2[i] - y1[i]);
+    }
+    while (state.KeepRunning()) {
+        IouOneToMany(900.f, 500.f, 980.f, 600.f, x1.data(), y1.data(), x2.data(), y2.data(), area.data(), n,
+                     iou.data());
+        bench::DoNotOptimize(iou[0]);
+    }
+    state.SetItemsProcessed(n);
+}
+
+void RunUpdate(bench::State &state, int count) {
+    std::vector<std::vector<DCSP_RESULT>> sequence = SyntheticSequence(count, 64);
+    Tracker tracker;
+    std::vector<DCSP_RESULT> detections;
+    size_t frame = 0;
+    while (state.KeepRunning()) {
+        detections = sequence[frame++ % sequence.size()];
+        tracker.Update(detections);
+        bench::DoNotOptimize(detections.size());
+    }
+    state.SetLabel(std::to_string(tracker.TrackCount()) + " tracks");
+}
+
+} // namespace
+
+BENCH(Tracker_Iou_64) { RunIou(state, 64); }
+BENCH(Tracker_Iou_512) { RunIou(state, 512); }
+BENCH(Tracker_Update_20) { RunUpdate(state, 20); }
+BENCH(Tracker_Update_200) { RunUpdate(state, 200); }
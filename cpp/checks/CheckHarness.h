@@ -0,0 +1,85 @@
+#pragma once
+
+// Minimal assertion harness for the host-side correctness checks, the counterpart of
+// benchmarks/BenchHarness.h:
+//
+//   CHECK_CASE(MyKernel) {
+//       EXPECT_TRUE(Run() == RET_OK);
+//       EXPECT_LE(MaxAbsDiff(out, reference), 1e-3);
+//   }
+//
+// A failed expectation is reported and the case keeps running; dcsp_check exits non-zero when
+// any case had a failure.
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace check {
+
+struct Case {
+    std::string name;
+    std::function<void()> body;
+};
+
+inline std::vector<Case> &Registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+struct Registrar {
+    Registrar(const char *name, std::function<void()> body) {
+        Registry().push_back({name, std::move(body)});
+    }
+};
+
+// Failed expectations of the case currently running.
+inline int &Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void Fail(const char *file, int line, const std::string &message) {
+    Failures()++;
+    std::printf("    %s:%d: %s\n", file, line, message.c_str());
+}
+
+int RunAll(int argc, char **argv);
+
+} // namespace check
+
+#define CHECK_CONCAT_INNER(a, b) a##b
+#define CHECK_CONCAT(a, b) CHECK_CONCAT_INNER(a, b)
+
+#define CHECK_CASE(name)                                                              \
+    static void name();                                                               \
+    static check::Registrar CHECK_CONCAT(name, _registrar)(#name, name);              \
+    static void name()
+
+#define EXPECT_TRUE(cond)                                                             \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            check::Fail(__FILE__, __LINE__, "expected " #cond);                       \
+        }                                                                             \
+    } while (0)
+
+#define EXPECT_EQ(a, b)                                                               \
+    do {                                                                              \
+        auto checkA = (a);                                                            \
+        auto checkB = (b);                                                            \
+        if (!(checkA == checkB)) {                                                    \
+            check::Fail(__FILE__, __LINE__, std::string(#a " == " #b ": ") +          \
+                        std::to_string(checkA) + " vs " + std::to_string(checkB));    \
+        }                                                                             \
+    } while (0)
+
+#define EXPECT_LE(a, b)                                                               \
+    do {                                                                              \
+        auto checkA = (a);                                                            \
+        auto checkB = (b);                                                            \
+        if (!(checkA <= checkB)) {                                                    \
+            check::Fail(__FILE__, __LINE__, std::string(#a " <= " #b ": ") +          \
+                        std::to_string(checkA) + " vs " + std::to_string(checkB));    \
+        }                                                                             \
+    } while (0)
@@ -0,0 +1,37 @@
+// Host-side correctness checks, built as dcsp_check by cpp/CMakeLists.txt together with every
+// *Check.cpp file and the core library, and registered with CTest. The checks compare the
+// optimized kernels against straightforward reference implementations on synthetic data and
+// need no model file.
+//
+// Usage: dcsp_check [filter]
+
+#include "CheckHarness.h"
+
+namespace check {
+
+int RunAll(int argc, char **argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    int failedCases = 0;
+    int ran = 0;
+    for (const Case &c: Registry()) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        std::printf("%s\n", c.name.c_str());
+        Failures() = 0;
+        c.body();
+        ran++;
+        if (Failures() > 0) {
+            failedCases++;
+            std::printf("  FAILED (%d)\n", Failures());
+        }
+    }
+    std::printf("%d of %d checks passed\n", ran - failedCases, ran);
+    return failedCases == 0 ? 0 : 1;
+}
+
+} // namespace check
+
+int main(int argc, char **argv) {
+    return check::RunAll(argc, argv);
+}
@@ -0,0 +1,152 @@
+// DecodeYoloV8 (blocked SIMD argmax plus the scalar tail) vs. the transpose + per-anchor
+// minMaxLoc loop it replaced, with the reference boxes mapped back through the same letterbox.
+
+#include "CheckHarness.h"
+#include "YoloDecode.h"
+#include <cmath>
+#include <opencv2/opencv.hpp>
+#include <random>
+
+namespace {
+
+constexpr float kThreshold = 0.5f;
+
+// Class scores quantized to sixteenths, so ties between classes and scores exactly at
+// kThreshold (8/16) are common.
+std::vector<float> RandomHead(std::mt19937 &rng, int numClasses, int numAnchors) {
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<float> head(static_cast<size_t>(4 + numClasses) * numAnchors);
+    for (int a = 0; a < numAnchors; a++) {
+        head[a] = unit(rng) * 640.f;
+        head[numAnchors + a] = unit(rng) * 640.f;
+        head[2 * static_cast<size_t>(numAnchors) + a] = 4.f + unit(rng) * 300.f;
+        head[3 * static_cast<size_t>(numAnchors) + a] = 4.f + unit(rng) * 300.f;
+    }
+    for (size_t i = 4 * static_cast<size_t>(numAnchors); i < head.size(); i++) {
+        head[i] = std::floor(unit(rng) * 11.f) / 16.f;
+    }
+    return head;
+}
+
+// The decode TensorProcess used to run: transpose to [anchors, 4 + classes] and take each
+// anchor's first maximal class with minMaxLoc.
+std::vector<DCSP_CANDIDATE> ReferenceDecode(std::vector<float> &head, int numClasses, int numAnchors,
+                                            float threshold, const LETTERBOX_INFO &letterbox) {
+    int channels = 4 + numClasses;
+    cv::Mat rawData = cv::Mat(channels, numAnchors, CV_32F, head.data()).t();
+    std::vector<DCSP_CANDIDATE> candidates;
+    for (int i = 0; i < numAnchors; i++) {
+        float *data = rawData.ptr<float>(i);
+        cv::Mat scores(1, numClasses, CV_32FC1, data + 4);
+        cv::Point classId;
+        double maxClassScore;
+        cv::minMaxLoc(scores, nullptr, &maxClassScore, nullptr, &classId);
+        if (maxClassScore > threshold) {
+            DCSP_CANDIDATE c;
+            c.x = (data[0] - 0.5f * data[2] - letterbox.padX) / letterbox.scaleX;
+            c.y = (data[1] - 0.5f * data[3] - letterbox.padY) / letterbox.scaleY;
+            c.width = data[2] / letterbox.scaleX;
+            c.height = data[3] / letterbox.scaleY;
+            c.confidence = static_cast<float>(maxClassScore);
+            c.classId = classId.x;
+            candidates.push_back(c);
+        }
+    }
+    return candidates;
+}
+
+// Candidates that differ from the reference in order, class, score, or box by more than a pixel
+// fraction; a count mismatch counts as one.
+int Mismatches(const std::vector<DCSP_CANDIDATE> &decoded, const std::vector<DCSP_CANDIDATE> &reference) {
+    if (decoded.size() != reference.size()) {
+        return 1;
+    }
+    int mismatches = 0;
+    for (size_t i = 0; i < decoded.size(); i++) {
+        const DCSP_CANDIDATE &a = decoded[i];
+        const DCSP_CANDIDATE &b = reference[i];
+        mismatches += a.classId != b.classId || a.confidence != b.confidence || std::fabs(a.x - b.x) > 1e-3f ||
+                      std::fabs(a.y - b.y) > 1e-3f || std::fabs(a.width - b.width) > 1e-3f ||
+                      std::fabs(a.height - b.height) > 1e-3f;
+    }
+    return mismatches;
+}
+
+} // namespace
+
+CHECK_CASE(DecodeMatchesReference) {
+    std::mt19937 rng(5);
+    LETTERBOX_INFO letterbox = ComputeLetterbox(1920, 1080, 640, 640);
+    std::vector<DCSP_CANDIDATE> decoded;
+    size_t emitted = 0;
+    // Anchor counts below, at and around multiples of DECODE_ANCHOR_BLOCK, so both the blocked
+    // path and the scalar tail run.
+    for (int numAnchors: {1, 7, DECODE_ANCHOR_BLOCK - 1, DECODE_ANCHOR_BLOCK, DECODE_ANCHOR_BLOCK + 1,
+                          3 * DECODE_ANCHOR_BLOCK + 5, 8400, 8405}) {
+        for (int numClasses: {1, 2, 5, 80}) {
+            std::vector<float> head = RandomHead(rng, numClasses, numAnchors);
+            EXPECT_TRUE(DecodeYoloV8(head.data(), 4 + numClasses, numAnchors, kThreshold, letterbox, decoded) ==
+                        RET_OK);
+            std::vector<DCSP_CANDIDATE> reference = ReferenceDecode(head, numClasses, numAnchors, kThreshold,
+                                                                    letterbox);
+            int mismatches = Mismatches(decoded, reference);
+            if (mismatches > 0) {
+                std::printf("    %d anchors, %d classes: %zu decoded, %zu reference\n", numAnchors, numClasses,
+                            decoded.size(), reference.size());
+            }
+            EXPECT_EQ(mismatches, 0);
+            emitted += decoded.size();
+        }
+    }
+    EXPECT_TRUE(emitted > 0);
+
+    EXPECT_TRUE(DecodeYoloV8(nullptr, 84, 8400, kThreshold, letterbox, decoded) != RET_OK);
+    std::vector<float> boxesOnly(4 * 16);
+    EXPECT_TRUE(DecodeYoloV8(boxesOnly.data(), 4, 16, kThreshold, letterbox, decoded) != RET_OK);
+}
+
+CHECK_CASE(DecodeTiesPickFirstClass) {
+    // Every anchor of the block and the tail scores 0.75 on two classes; the lower class wins,
+    // as with minMaxLoc. Anchor a ties classes a % 7 and a % 7 + 1 + a % 3.
+    constexpr int numClasses = 12;
+    constexpr int numAnchors = 2 * DECODE_ANCHOR_BLOCK + 3;
+    std::vector<float> head(static_cast<size_t>(4 + numClasses) * numAnchors, 0.25f);
+    for (int a = 0; a < numAnchors; a++) {
+        int first = a % 7;
+        int second = first + 1 + a % 3;
+        head[static_cast<size_t>(4 + first) * numAnchors + a] = 0.75f;
+        head[static_cast<size_t>(4 + second) * numAnchors + a] = 0.75f;
+    }
+    LETTERBOX_INFO letterbox = ComputeLetterbox(640, 640, 640, 640);
+    std::vector<DCSP_CANDIDATE> decoded;
+    EXPECT_TRUE(DecodeYoloV8(head.data(), 4 + numClasses, numAnchors, kThreshold, letterbox, decoded) == RET_OK);
+    EXPECT_EQ(decoded.size(), static_cast<size_t>(numAnchors));
+    int wrongClass = 0;
+    for (size_t i = 0; i < decoded.size(); i++) {
+        wrongClass += decoded[i].classId != static_cast<int>(i) % 7;
+    }
+    EXPECT_EQ(wrongClass, 0);
+    EXPECT_EQ(Mismatches(decoded, ReferenceDecode(head, numClasses, numAnchors, kThreshold, letterbox)), 0);
+}
+
+CHECK_CASE(DecodeThresholdIsExclusive) {
+    // Alternate anchors score exactly the threshold and the next float above it; only the
+    // latter are candidates, in the blocked path and in the tail alike.
+    constexpr int numClasses = 3;
+    constexpr int numAnchors = DECODE_ANCHOR_BLOCK + 9;
+    float above = std::nextafter(kThreshold, 1.f);
+    std::vector<float> head(static_cast<size_t>(4 + numClasses) * numAnchors, 0.f);
+    for (int a = 0; a < numAnchors; a++) {
+        head[static_cast<size_t>(4 + a % numClasses) * numAnchors + a] = a % 2 == 0 ? kThreshold : above;
+    }
+    LETTERBOX_INFO letterbox = ComputeLetterbox(1280, 720, 640, 640);
+    std::vector<DCSP_CANDIDATE> decoded;
+    EXPECT_TRUE(DecodeYoloV8(head.data(), 4 + numClasses, numAnchors, kThreshold, letterbox, decoded) == RET_OK);
+    EXPECT_EQ(decoded.size(), static_cast<size_t>(numAnchors / 2));
+    int atThreshold = 0;
+    for (const DCSP_CANDIDATE &candidate: decoded) {
+        atThreshold += candidate.confidence != above;
+    }
+    EXPECT_EQ(atThreshold, 0);
+    EXPECT_EQ(Mismatches(decoded, ReferenceDecode(head, numClasses, numAnchors, kThreshold, letterbox)), 0);
+}
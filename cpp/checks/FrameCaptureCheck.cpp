@@ -0,0 +1,191 @@
+// FrameRecorder / FrameCaptureReader round trip, the reader's validation of damaged records, and
+// ReplayCapture's parity and precision.
+
+#include "CheckHarness.h"
+#include "FrameCapture.h"
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char *kCapturePath = "dcsp_capture_check.dcap";
+
+// A capture of one record built by hand, so the header can say anything.
+void WriteRawCapture(const CAPTURE_RECORD_HEADER &header, size_t payloadBytes, uint32_t version = CAPTURE_VERSION) {
+    FILE *file = std::fopen(kCapturePath, "wb");
+    CAPTURE_FILE_HEADER fileHeader = {};
+    std::memcpy(fileHeader.magic, CAPTURE_MAGIC, sizeof(fileHeader.magic));
+    fileHeader.version = version;
+    fileHeader.settings.inputWidth = 320;
+    std::fwrite(&fileHeader, version == 1 ? CAPTURE_FILE_HEADER_V1_BYTES : sizeof(fileHeader), 1, file);
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::vector<uint8_t> payload((payloadBytes + 7) & ~static_cast<size_t>(7), 0);
+    std::fwrite(payload.data(), 1, payload.size(), file);
+    std::fclose(file);
+}
+
+CAPTURE_RECORD_HEADER BgrHeader(int width, int height) {
+    CAPTURE_RECORD_HEADER header = {};
+    header.format = CAPTURE_BGR8;
+    header.width = width;
+    header.height = height;
+    header.stride = width * 3;
+    header.payloadBytes = static_cast<uint64_t>(header.stride) * height;
+    return header;
+}
+
+} // namespace
+
+CHECK_CASE(CaptureRoundTrip) {
+    cv::Mat bgr(37, 53, CV_8UC3);
+    cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(255));
+    std::vector<uint8_t> i420(54 * 21 + 2 * 27 * 11);
+    for (size_t i = 0; i < i420.size(); i++) {
+        i420[i] = static_cast<uint8_t>(i * 31);
+    }
+    YUV_IMAGE yuv = WrapI420(i420.data(), 53, 21, 54);
+    std::vector<DCSP_RESULT> detections(1);
+    detections[0].classId = 3;
+    detections[0].confidence = 0.75f;
+    detections[0].box = cv::Rect(1, 2, 30, 40);
+
+    FrameRecorder recorder;
+    CAPTURE_SETTINGS settings = MakeCaptureSettings(0.35f, 0.6f, 416, 320, false);
+    EXPECT_TRUE(recorder.Open(kCapturePath) == RET_OK);
+    EXPECT_TRUE(recorder.Write(yuv, CAPTURE_META(), nullptr, nullptr) == RET_OK);
+    EXPECT_TRUE(recorder.Write(bgr, CAPTURE_META(), &detections, &settings) == RET_OK);
+    recorder.Close();
+    CAPTURE_SETTINGS header;
+    EXPECT_TRUE(ReadCaptureSettings(kCapturePath, header) == RET_OK);
+    EXPECT_EQ(header.inputWidth, 416);
+
+    FrameCaptureReader reader;
+    EXPECT_TRUE(reader.Open(kCapturePath) == RET_OK);
+    EXPECT_EQ(reader.Settings().confidenceThreshold, 0.35f);
+    EXPECT_EQ(reader.Settings().nmsThreshold, 0.6f);
+    EXPECT_EQ(reader.Settings().inputWidth, 416);
+    EXPECT_EQ(reader.Settings().inputHeight, 320);
+    EXPECT_EQ(reader.Settings().classAware, 0u);
+    EXPECT_EQ(reader.Count(), static_cast<size_t>(2));
+    if (reader.Count() != 2) {
+        return;
+    }
+    EXPECT_EQ(reader.Frame(1).detectionCount, 1);
+    EXPECT_EQ(reader.Frame(1).detections[0].width, 30);
+    cv::Mat replayed = CaptureFrameMat(reader.Frame(1));
+    bool same = true;
+    for (int r = 0; r < bgr.rows; r++) {
+        same = same && std::memcmp(bgr.ptr(r), replayed.ptr(r), 53 * 3) == 0;
+    }
+    EXPECT_TRUE(same);
+    YUV_IMAGE replayedYuv = CaptureFrameYuv(reader.Frame(0));
+    EXPECT_EQ(replayedYuv.width, 53);
+    EXPECT_TRUE(std::memcmp(replayedYuv.y + 20 * replayedYuv.yRowStride, yuv.y + 20 * yuv.yRowStride, 53) == 0);
+    EXPECT_TRUE(std::memcmp(replayedYuv.v + 10 * replayedYuv.uvRowStride, yuv.v + 10 * yuv.uvRowStride, 27) == 0);
+    std::remove(kCapturePath);
+}
+
+CHECK_CASE(CaptureRejectsDamagedRecords) {
+    FrameCaptureReader reader;
+
+    CAPTURE_RECORD_HEADER header = BgrHeader(64, 48);
+    header.stride = 64 * 3 - 1;
+    WriteRawCapture(header, header.payloadBytes);
+    EXPECT_TRUE(reader.Open(kCapturePath) != RET_OK);
+
+    header = BgrHeader(64, 48);
+    header.stride = 0;
+    WriteRawCapture(header, header.payloadBytes);
+    EXPECT_TRUE(reader.Open(kCapturePath) != RET_OK);
+
+    header = BgrHeader(64, 48);
+    header.payloadBytes -= 1;
+    WriteRawCapture(header, header.payloadBytes);
+    EXPECT_TRUE(reader.Open(kCapturePath) != RET_OK);
+    EXPECT_EQ(reader.Count(), static_cast<size_t>(0));
+
+    // I420 needs the chroma planes too, and stride / 2 must hold a chroma row.
+    header = BgrHeader(63, 48);
+    header.format = CAPTURE_I420;
+    header.stride = 64;
+    header.payloadBytes = 64 * 48;
+    WriteRawCapture(header, header.payloadBytes);
+    EXPECT_TRUE(reader.Open(kCapturePath) != RET_OK);
+    header.stride = 63;
+    header.payloadBytes = 63 * 48 + 2 * 31 * 24;
+    WriteRawCapture(header, header.payloadBytes);
+    EXPECT_TRUE(reader.Open(kCapturePath) != RET_OK);
+    header.stride = 64;
+    header.payloadBytes = 64 * 48 + 2 * 32 * 24;
+    WriteRawCapture(header, header.payloadBytes);
+    EXPECT_TRUE(reader.Open(kCapturePath) == RET_OK);
+    EXPECT_EQ(reader.Count(), static_cast<size_t>(1));
+
+    // Sizes that would wrap around when rounded up are a truncated tail, not a record.
+    header = BgrHeader(64, 48);
+    header.payloadBytes = std::numeric_limits<uint64_t>::max() - 3;
+    WriteRawCapture(header, 64 * 3 * 48);
+    EXPECT_TRUE(reader.Open(kCapturePath) == RET_OK);
+    EXPECT_EQ(reader.Count(), static_cast<size_t>(0));
+    header = BgrHeader(64, 48);
+    header.detectionCount = std::numeric_limits<uint32_t>::max();
+    WriteRawCapture(header, header.payloadBytes);
+    EXPECT_TRUE(reader.Open(kCapturePath) == RET_OK);
+    EXPECT_EQ(reader.Count(), static_cast<size_t>(0));
+
+    // Version 1 headers have no settings; their records still read.
+    header = BgrHeader(64, 48);
+    WriteRawCapture(header, header.payloadBytes, 1);
+    EXPECT_TRUE(reader.Open(kCapturePath) == RET_OK);
+    EXPECT_EQ(reader.Count(), static_cast<size_t>(1));
+    EXPECT_EQ(reader.Settings().inputWidth, 0);
+    WriteRawCapture(header, header.payloadBytes, CAPTURE_VERSION + 1);
+    EXPECT_TRUE(reader.Open(kCapturePath) != RET_OK);
+    std::remove(kCapturePath);
+}
+
+CHECK_CASE(ReplayParityAndPrecision) {
+    // Frame 0 has two reference boxes, frame 1 none. The replay finds one of the two, adds a
+    // false positive on frame 0 and two detections on frame 1.
+    cv::Mat bgr(48, 64, CV_8UC3, cv::Scalar::all(0));
+    std::vector<DCSP_RESULT> reference(2);
+    reference[0].classId = 1;
+    reference[0].box = cv::Rect(0, 0, 20, 20);
+    reference[1].classId = 2;
+    reference[1].box = cv::Rect(30, 10, 20, 30);
+    std::vector<DCSP_RESULT> none;
+    CAPTURE_SETTINGS settings = MakeCaptureSettings(0.5f, 0.5f, 640, 640, true);
+    FrameRecorder recorder;
+    EXPECT_TRUE(recorder.Open(kCapturePath) == RET_OK);
+    EXPECT_TRUE(recorder.Write(bgr, CAPTURE_META(), &reference, &settings) == RET_OK);
+    EXPECT_TRUE(recorder.Write(bgr, CAPTURE_META(), &none, &settings) == RET_OK);
+    recorder.Close();
+
+    FrameCaptureReader reader;
+    EXPECT_TRUE(reader.Open(kCapturePath) == RET_OK);
+    int call = 0;
+    auto run = [&](const CAPTURE_FRAME &, std::vector<DCSP_RESULT> &oResult) -> char * {
+        oResult.resize(2);
+        oResult[0].classId = 1;
+        oResult[0].box = cv::Rect(1, 1, 20, 20);
+        oResult[1].classId = call == 0 ? 2 : 5;
+        oResult[1].box = cv::Rect(0, 40, 8, 8);
+        call++;
+        return RET_OK;
+    };
+    REPLAY_PARAM param;
+    REPLAY_STATS stats;
+    EXPECT_TRUE(ReplayCapture(reader, param, run, stats) == RET_OK);
+    EXPECT_EQ(stats.referenceDetections, static_cast<size_t>(2));
+    EXPECT_EQ(stats.matchedDetections, static_cast<size_t>(1));
+    EXPECT_EQ(stats.comparedDetections, static_cast<size_t>(2));
+    EXPECT_EQ(stats.replayDetections, static_cast<size_t>(4));
+    EXPECT_EQ(stats.parity, 0.5);
+    EXPECT_EQ(stats.precision, 0.5);
+
+    param.minParity = 0.75f;
+    call = 0;
+    EXPECT_TRUE(ReplayCapture(reader, param, run, stats) != RET_OK);
+    EXPECT_EQ(stats.parity, 0.5);
+    std::remove(kCapturePath);
+}
@@ -0,0 +1,102 @@
+// NmsEngine (linear and grid paths) vs. a brute-force greedy NMS.
+
+#include "CheckHarness.h"
+#include "Nms.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// Jittered clusters like a crowded frame, plus a share of very large and very small boxes so
+// the grid path sees boxes spanning many cells and boxes far below the cell size. Confidences
+// are quantized to produce ties.
+std::vector<DCSP_CANDIDATE> RandomCandidates(std::mt19937 &rng, int count, int numClasses) {
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<DCSP_CANDIDATE> candidates;
+    while (static_cast<int>(candidates.size()) < count) {
+        float cx = unit(rng) * 1920.f;
+        float cy = unit(rng) * 1080.f;
+        float kind = unit(rng);
+        float size = kind < 0.1f ? 400.f + unit(rng) * 800.f : kind < 0.2f ? 2.f + unit(rng) * 6.f
+                                                                            : 20.f + unit(rng) * 120.f;
+        int classId = static_cast<int>(rng() % numClasses);
+        int clusterSize = 1 + static_cast<int>(rng() % 12);
+        for (int j = 0; j < clusterSize && static_cast<int>(candidates.size()) < count; j++) {
+            DCSP_CANDIDATE c;
+            c.width = size * (0.7f + 0.6f * unit(rng));
+            c.height = size * (0.7f + 0.6f * unit(rng));
+            c.x = cx + (unit(rng) - 0.5f) * 0.5f * size - 0.5f * c.width;
+            c.y = cy + (unit(rng) - 0.5f) * 0.5f * size - 0.5f * c.height;
+            c.confidence = std::round((0.25f + 0.75f * unit(rng)) * 64.f) / 64.f;
+            c.classId = unit(rng) < 0.8f ? classId : static_cast<int>(rng() % numClasses);
+            candidates.push_back(c);
+        }
+    }
+    return candidates;
+}
+
+// Textbook greedy NMS: sort by confidence (ties by index), cut to topK, then keep every box
+// whose IoU with all kept boxes (of its class when classAware) is at most the threshold.
+std::vector<int> BruteForceNms(const std::vector<DCSP_CANDIDATE> &candidates, const NMS_PARAM &param) {
+    std::vector<int> order(candidates.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<int>(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&candidates](int a, int b) {
+        return candidates[a].confidence > candidates[b].confidence;
+    });
+    if (param.topK > 0 && static_cast<int>(order.size()) > param.topK) {
+        order.resize(param.topK);
+    }
+    std::vector<int> keep;
+    for (int idx: order) {
+        bool suppressed = false;
+        for (int kept: keep) {
+            if ((!param.classAware || candidates[kept].classId == candidates[idx].classId) &&
+                BoxIou(candidates[idx], candidates[kept]) > param.iouThreshold) {
+                suppressed = true;
+                break;
+            }
+        }
+        if (suppressed) {
+            continue;
+        }
+        keep.push_back(idx);
+        if (param.maxDetections > 0 && static_cast<int>(keep.size()) >= param.maxDetections) {
+            break;
+        }
+    }
+    return keep;
+}
+
+} // namespace
+
+CHECK_CASE(NmsMatchesBruteForce) {
+    std::mt19937 rng(7);
+    // One engine throughout, so scratch left over from a larger run cannot leak into the next.
+    NmsEngine engine;
+    std::vector<int> keep;
+    // Both sides of NMS_GRID_MIN_CANDIDATES, up to a dense low-threshold frame.
+    const int counts[] = {1, 40, NMS_GRID_MIN_CANDIDATES - 1, NMS_GRID_MIN_CANDIDATES, 1000, 4000};
+    for (int round = 0; round < 3; round++) {
+        for (int count: counts) {
+            std::vector<DCSP_CANDIDATE> candidates = RandomCandidates(rng, count, round == 0 ? 1 : 5);
+            for (float iou: {0.1f, 0.3f, 0.45f, 0.5f, 0.7f, 0.95f}) {
+                for (bool classAware: {true, false}) {
+                    NMS_PARAM param;
+                    param.iouThreshold = iou;
+                    param.classAware = classAware;
+                    param.topK = round == 2 ? 300 : 0;
+                    param.maxDetections = round == 1 ? 25 : 0;
+                    EXPECT_TRUE(engine.Run(candidates, param, keep) == RET_OK);
+                    std::vector<int> expected = BruteForceNms(candidates, param);
+                    if (keep != expected) {
+                        std::printf("    %d candidates, iou %.2f, classAware %d: kept %zu, expected %zu\n", count,
+                                    iou, classAware, keep.size(), expected.size());
+                    }
+                    EXPECT_TRUE(keep == expected);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,242 @@
+// Fused letterbox kernels vs. the pre-fusion cv::resize + PostProcess + BlobFromImage path, and
+// the YUV kernel vs. cv::cvtColor followed by that same reference letterbox.
+
+#include "CheckHarness.h"
+#include "Preprocess.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// cv::resize rounds every resampled pixel to 8 bits and uses fixed-point weights; the fused
+// kernel stays in float, so the two may differ by about one level.
+constexpr float kLetterboxTolerance = 1.5f / 255.f;
+
+cv::Mat SyntheticFrame(int width, int height, int channels) {
+    cv::Mat frame(height, width, CV_8UC(channels));
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+    return frame;
+}
+
+// The pre-fusion path with the letterbox the fused kernel applies: resize to the letterboxed
+// size, colour conversion and HWC->CHW through PostProcess / BlobFromImage, then pasted onto a
+// LETTERBOX_PAD_VALUE canvas.
+std::vector<float> ReferenceLetterbox(const cv::Mat &iImg, int dstWidth, int dstHeight) {
+    cv::Mat bgr = iImg;
+    if (iImg.channels() == 4) {
+        cv::cvtColor(iImg, bgr, cv::COLOR_BGRA2BGR);
+    }
+    LETTERBOX_INFO info = ComputeLetterbox(bgr.cols, bgr.rows, dstWidth, dstHeight);
+    int resizedWidth = static_cast<int>(std::lround(bgr.cols * info.scaleX));
+    int resizedHeight = static_cast<int>(std::lround(bgr.rows * info.scaleY));
+    cv::Mat processed;
+    PostProcess(bgr, {resizedWidth, resizedHeight}, processed);
+    std::vector<float> resized(static_cast<size_t>(3) * resizedWidth * resizedHeight);
+    float *resizedPtr = resized.data();
+    BlobFromImage(processed, resizedPtr);
+
+    size_t planeSize = static_cast<size_t>(dstWidth) * dstHeight;
+    std::vector<float> blob(3 * planeSize, LETTERBOX_PAD_VALUE);
+    int padX = static_cast<int>(info.padX);
+    int padY = static_cast<int>(info.padY);
+    for (int c = 0; c < 3; c++) {
+        for (int y = 0; y < resizedHeight; y++) {
+            const float *src = resizedPtr + (static_cast<size_t>(c) * resizedHeight + y) * resizedWidth;
+            float *dst = blob.data() + c * planeSize + static_cast<size_t>(padY + y) * dstWidth + padX;
+            std::copy(src, src + resizedWidth, dst);
+        }
+    }
+    return blob;
+}
+
+float MaxAbsDiff(const std::vector<float> &a, const std::vector<float> &b) {
+    float worst = 0.f;
+    for (size_t i = 0; i < a.size(); i++) {
+        worst = std::max(worst, std::fabs(a[i] - b[i]));
+    }
+    return worst;
+}
+
+void ExpectMatchesReference(const cv::Mat &frame, int dstWidth, int dstHeight, PreprocessWorkspace &workspace) {
+    std::vector<float> blob(static_cast<size_t>(3) * dstWidth * dstHeight, -1.f);
+    LETTERBOX_INFO info;
+    EXPECT_TRUE(PreprocessLetterbox(frame, dstWidth, dstHeight, blob.data(), workspace, info) == RET_OK);
+    std::vector<float> reference = ReferenceLetterbox(frame, dstWidth, dstHeight);
+    float diff = MaxAbsDiff(blob, reference);
+    if (diff > kLetterboxTolerance) {
+        std::printf("    %dx%d x%d -> %dx%d\n", frame.cols, frame.rows, frame.channels(), dstWidth, dstHeight);
+    }
+    EXPECT_LE(diff, kLetterboxTolerance);
+}
+
+// The kernel samples chroma nearest, the reference interpolates it after conversion: one chroma
+// level apart is 1.772 levels of blue, plus the 8-bit rounding of cv::cvtColor and cv::resize.
+constexpr float kYuvTolerance = 4.f / 255.f;
+
+// Slowly varying chroma in 128 +- 20: nearest and interpolated chroma then differ by at most one
+// level, and R, G, B stay inside [0, 255] so clamping cannot mask a misread plane.
+uint8_t ChromaSample(int cx, int cy, float phase) {
+    return static_cast<uint8_t>(std::lround(128.f + 20.f * std::sin(phase + cx / 128.f + cy / 96.f)));
+}
+
+uint8_t USample(int cx, int cy) { return ChromaSample(cx, cy, 0.f); }
+
+uint8_t VSample(int cx, int cy) { return ChromaSample(cx, cy, 2.f); }
+
+// Random luma in [40, 215] plus the chroma fields above, laid out into camera buffers by the callers.
+struct YUV_SOURCE {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> luma;
+
+    YUV_SOURCE(int w, int h) : width(w), height(h), luma(static_cast<size_t>(w) * h) {
+        for (uint8_t &value: luma) {
+            value = static_cast<uint8_t>(40 + std::rand() % 176);
+        }
+    }
+
+    int chromaWidth() const { return (width + 1) / 2; }
+
+    int chromaHeight() const { return (height + 1) / 2; }
+
+    // Full-range BT.601 conversion by OpenCV (COLOR_YCrCb2BGR) from the nearest-upsampled chroma.
+    cv::Mat ToBgr() const {
+        cv::Mat ycrcb(height, width, CV_8UC3);
+        for (int y = 0; y < height; y++) {
+            uint8_t *row = ycrcb.ptr<uint8_t>(y);
+            for (int x = 0; x < width; x++) {
+                row[3 * x] = luma[static_cast<size_t>(y) * width + x];
+                row[3 * x + 1] = VSample(x / 2, y / 2);
+                row[3 * x + 2] = USample(x / 2, y / 2);
+            }
+        }
+        cv::Mat bgr;
+        cv::cvtColor(ycrcb, bgr, cv::COLOR_YCrCb2BGR);
+        return bgr;
+    }
+};
+
+// Buffer of size bytes whose padding is random, so reading past a row shows up in the output.
+std::vector<uint8_t> NoiseBuffer(size_t size) {
+    std::vector<uint8_t> buffer(size);
+    for (uint8_t &value: buffer) {
+        value = static_cast<uint8_t>(std::rand() & 255);
+    }
+    return buffer;
+}
+
+std::vector<uint8_t> PackNV21(const YUV_SOURCE &source, int rowStride) {
+    std::vector<uint8_t> buffer = NoiseBuffer(static_cast<size_t>(rowStride) * (source.height + source.chromaHeight()));
+    for (int y = 0; y < source.height; y++) {
+        std::copy_n(source.luma.data() + static_cast<size_t>(y) * source.width, source.width,
+                    buffer.data() + static_cast<size_t>(y) * rowStride);
+    }
+    uint8_t *vu = buffer.data() + static_cast<size_t>(rowStride) * source.height;
+    for (int cy = 0; cy < source.chromaHeight(); cy++) {
+        uint8_t *row = vu + static_cast<size_t>(cy) * rowStride;
+        for (int cx = 0; cx < source.chromaWidth(); cx++) {
+            row[2 * cx] = VSample(cx, cy);
+            row[2 * cx + 1] = USample(cx, cy);
+        }
+    }
+    return buffer;
+}
+
+std::vector<uint8_t> PackI420(const YUV_SOURCE &source, int rowStride) {
+    int chromaStride = rowStride / 2;
+    size_t lumaSize = static_cast<size_t>(rowStride) * source.height;
+    size_t chromaSize = static_cast<size_t>(chromaStride) * source.chromaHeight();
+    std::vector<uint8_t> buffer = NoiseBuffer(lumaSize + 2 * chromaSize);
+    for (int y = 0; y < source.height; y++) {
+        std::copy_n(source.luma.data() + static_cast<size_t>(y) * source.width, source.width,
+                    buffer.data() + static_cast<size_t>(y) * rowStride);
+    }
+    for (int cy = 0; cy < source.chromaHeight(); cy++) {
+        uint8_t *u = buffer.data() + lumaSize + static_cast<size_t>(cy) * chromaStride;
+        uint8_t *v = u + chromaSize;
+        for (int cx = 0; cx < source.chromaWidth(); cx++) {
+            u[cx] = USample(cx, cy);
+            v[cx] = VSample(cx, cy);
+        }
+    }
+    return buffer;
+}
+
+void ExpectYuvMatchesReference(const YUV_IMAGE &image, const YUV_SOURCE &source, int dstWidth, int dstHeight,
+                               PreprocessWorkspace &workspace, const char *layout) {
+    std::vector<float> blob(static_cast<size_t>(3) * dstWidth * dstHeight, -1.f);
+    LETTERBOX_INFO info;
+    EXPECT_TRUE(PreprocessYuvLetterbox(image, dstWidth, dstHeight, blob.data(), workspace, info) == RET_OK);
+    std::vector<float> reference = ReferenceLetterbox(source.ToBgr(), dstWidth, dstHeight);
+    float diff = MaxAbsDiff(blob, reference);
+    if (diff > kYuvTolerance) {
+        std::printf("    %s %dx%d -> %dx%d\n", layout, source.width, source.height, dstWidth, dstHeight);
+    }
+    EXPECT_LE(diff, kYuvTolerance);
+}
+
+int PaddedStride(int width) {
+    return (width + 63) / 64 * 64 + 64;
+}
+
+} // namespace
+
+CHECK_CASE(LetterboxOddSizes) {
+    // One workspace for all of them, so every geometry change goes through prepare() again.
+    PreprocessWorkspace workspace;
+    const int sizes[][2] = {{641, 479}, {1279, 719}, {333, 517}, {97, 61}, {640, 640}, {1921, 1081}};
+    for (const auto &size: sizes) {
+        for (int channels: {1, 3, 4}) {
+            cv::Mat frame = SyntheticFrame(size[0], size[1], channels);
+            ExpectMatchesReference(frame, 640, 640, workspace);
+            ExpectMatchesReference(frame, 321, 193, workspace);
+        }
+    }
+}
+
+CHECK_CASE(LetterboxRoiAndStride) {
+    PreprocessWorkspace workspace;
+    cv::Mat parent = SyntheticFrame(1000, 800, 3);
+    // ROI views: row step of the parent, non-zero origin, odd extents.
+    ExpectMatchesReference(parent(cv::Rect(13, 7, 641, 479)), 640, 640, workspace);
+    ExpectMatchesReference(parent(cv::Rect(1, 0, 999, 799)), 640, 640, workspace);
+    ExpectMatchesReference(parent(cv::Rect(500, 401, 317, 399)), 416, 416, workspace);
+
+    // Externally owned rows padded to a 64-byte stride, like a camera buffer.
+    const int width = 637;
+    const int height = 355;
+    const size_t step = (static_cast<size_t>(width) * 4 + 63) / 64 * 64;
+    std::vector<uint8_t> pixels(step * height);
+    cv::Mat flat(1, static_cast<int>(pixels.size()), CV_8UC1, pixels.data());
+    cv::randu(flat, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::Mat padded(height, width, CV_8UC4, pixels.data(), step);
+    ExpectMatchesReference(padded, 640, 640, workspace);
+}
+
+CHECK_CASE(YuvLetterboxNV21) {
+    PreprocessWorkspace workspace;
+    const int sizes[][2] = {{640, 480}, {1280, 720}, {641, 479}, {480, 640}, {97, 61}};
+    for (const auto &size: sizes) {
+        YUV_SOURCE source(size[0], size[1]);
+        for (int rowStride: {size[0] + size[0] % 2, PaddedStride(size[0])}) {
+            std::vector<uint8_t> nv21 = PackNV21(source, rowStride);
+            YUV_IMAGE image = WrapNV21(nv21.data(), source.width, source.height, rowStride);
+            ExpectYuvMatchesReference(image, source, 640, 640, workspace, "NV21");
+            ExpectYuvMatchesReference(image, source, 321, 193, workspace, "NV21");
+        }
+    }
+}
+
+CHECK_CASE(YuvLetterboxI420) {
+    PreprocessWorkspace workspace;
+    const int sizes[][2] = {{640, 480}, {1280, 720}, {641, 479}, {480, 640}, {97, 61}};
+    for (const auto &size: sizes) {
+        YUV_SOURCE source(size[0], size[1]);
+        for (int rowStride: {size[0] + size[0] % 2, PaddedStride(size[0])}) {
+            std::vector<uint8_t> i420 = PackI420(source, rowStride);
+            YUV_IMAGE image = WrapI420(i420.data(), source.width, source.height, rowStride);
+            ExpectYuvMatchesReference(image, source, 640, 640, workspace, "I420");
+            ExpectYuvMatchesReference(image, source, 321, 193, workspace, "I420");
+        }
+    }
+}
@@ -0,0 +1,114 @@
+// ComputeTiles edge coverage and alignment over many frame sizes, and MergeTileDetections on
+// objects cut by a seam.
+
+#include "CheckHarness.h"
+#include "Tiling.h"
+#include <algorithm>
+
+namespace {
+
+// Whether the tile intervals along one axis cover [0, extent) and stay inside it.
+bool CoversAxis(const std::vector<std::pair<int, int>> &intervals, int extent) {
+    std::vector<char> covered(extent, 0);
+    for (const std::pair<int, int> &interval: intervals) {
+        if (interval.first < 0 || interval.second <= 0 || interval.first + interval.second > extent) {
+            return false;
+        }
+        std::fill(covered.begin() + interval.first, covered.begin() + interval.first + interval.second, 1);
+    }
+    return std::find(covered.begin(), covered.end(), 0) == covered.end();
+}
+
+DCSP_CANDIDATE Candidate(float x, float y, float width, float height, float confidence, int classId) {
+    DCSP_CANDIDATE c;
+    c.x = x;
+    c.y = y;
+    c.width = width;
+    c.height = height;
+    c.confidence = confidence;
+    c.classId = classId;
+    return c;
+}
+
+} // namespace
+
+CHECK_CASE(TilesCoverFrameEdges) {
+    int failures = 0;
+    std::vector<cv::Rect> tiles;
+    for (int width = 2; width <= 700; width += width < 80 ? 1 : 37) {
+        for (int height: {2, 3, 9, 64, 161, 480, 1080}) {
+            for (int grid = 1; grid <= 5; grid++) {
+                for (float overlap: {0.f, 0.1f, 0.2f, 0.5f, 0.9f}) {
+                    TILE_PARAM param;
+                    param.columns = grid;
+                    param.rows = 6 - grid;
+                    param.overlap = overlap;
+                    param.fullFrame = false;
+                    if (ComputeTiles(width, height, param, tiles) != RET_OK) {
+                        failures++;
+                        continue;
+                    }
+                    std::vector<std::pair<int, int>> xs;
+                    std::vector<std::pair<int, int>> ys;
+                    bool ok = static_cast<int>(tiles.size()) == param.columns * param.rows;
+                    for (const cv::Rect &tile: tiles) {
+                        // Identical sizes and even origins, as CropYuv and the shared workspace need.
+                        ok = ok && tile.width == tiles[0].width && tile.height == tiles[0].height &&
+                             tile.x % 2 == 0 && tile.y % 2 == 0;
+                        xs.emplace_back(tile.x, tile.width);
+                        ys.emplace_back(tile.y, tile.height);
+                    }
+                    ok = ok && CoversAxis(xs, width) && CoversAxis(ys, height);
+                    if (!ok) {
+                        if (failures < 5) {
+                            std::printf("    %dx%d, %dx%d tiles, overlap %.2f\n", width, height, param.columns,
+                                        param.rows, overlap);
+                        }
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_EQ(failures, 0);
+
+    // The whole frame is appended last when requested.
+    TILE_PARAM param;
+    EXPECT_TRUE(ComputeTiles(1920, 1080, param, tiles) == RET_OK);
+    EXPECT_EQ(tiles.size(), static_cast<size_t>(5));
+    EXPECT_TRUE(tiles.back().x == 0 && tiles.back().y == 0 && tiles.back().width == 1920 &&
+                tiles.back().height == 1080);
+    EXPECT_EQ(tiles[1].x + tiles[1].width, 1920);
+    EXPECT_EQ(tiles[2].y + tiles[2].height, 1080);
+}
+
+CHECK_CASE(TileSeamMerge) {
+    // A car cut by the vertical seam between tiles 0 and 1: each tile sees a part, overlapping
+    // by the tile overlap. Their IoU is low, but the intersection covers most of the smaller part.
+    std::vector<DCSP_CANDIDATE> candidates = {
+            Candidate(900.f, 400.f, 160.f, 80.f, 0.9f, 2),
+            Candidate(960.f, 402.f, 140.f, 78.f, 0.8f, 2),
+            // Same place, other class: stays separate.
+            Candidate(985.f, 400.f, 110.f, 80.f, 0.7f, 5),
+            // Two same-class boxes from one tile were already arbitrated by NMS.
+            Candidate(100.f, 100.f, 50.f, 50.f, 0.6f, 0),
+            Candidate(120.f, 100.f, 50.f, 50.f, 0.5f, 0),
+    };
+    std::vector<int> candidateTiles = {0, 1, 1, 2, 2};
+    std::vector<int> keep = {0, 1, 2, 3, 4};
+    MergeTileDetections(candidates, candidateTiles, 0.6f, keep);
+    EXPECT_TRUE((keep == std::vector<int>{0, 2, 3, 4}));
+    EXPECT_EQ(candidates[0].x, 900.f);
+    EXPECT_EQ(candidates[0].y, 400.f);
+    EXPECT_EQ(candidates[0].x + candidates[0].width, 1100.f);
+    EXPECT_EQ(candidates[0].y + candidates[0].height, 480.f);
+    EXPECT_EQ(candidates[0].confidence, 0.9f);
+
+    // Below the threshold, or with merging off, nothing changes.
+    candidates[0] = Candidate(900.f, 400.f, 160.f, 80.f, 0.9f, 2);
+    keep = {0, 1};
+    MergeTileDetections(candidates, candidateTiles, 0.95f, keep);
+    EXPECT_EQ(keep.size(), static_cast<size_t>(2));
+    MergeTileDetections(candidates, candidateTiles, 0.f, keep);
+    EXPECT_EQ(keep.size(), static_cast<size_t>(2));
+}
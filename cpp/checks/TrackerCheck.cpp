@@ -0,0 +1,139 @@
+// Tracker on synthetic detection sequences: stable IDs through a crossing, release after maxAge,
+// and the detector cadence reported by NeedsDetection.
+
+#include "CheckHarness.h"
+#include "Tracker.h"
+#include <cstdlib>
+
+namespace {
+
+DCSP_RESULT Detection(int classId, float confidence, int cx, int cy, int width, int height) {
+    DCSP_RESULT detection;
+    detection.classId = classId;
+    detection.confidence = confidence;
+    detection.box = cv::Rect(cx - width / 2, cy - height / 2, width, height);
+    return detection;
+}
+
+// The track ID the tracker gave the detection nearest to (cx, cy), -1 if there is none.
+int TrackIdNear(const std::vector<DCSP_RESULT> &results, int cx, int cy) {
+    int best = -1;
+    long bestDistance = 0;
+    for (const DCSP_RESULT &result: results) {
+        long dx = result.box.x + result.box.width / 2 - cx;
+        long dy = result.box.y + result.box.height / 2 - cy;
+        long distance = dx * dx + dy * dy;
+        if (best < 0 || distance < bestDistance) {
+            best = result.trackId;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+CHECK_CASE(TrackerKeepsIdsThroughCrossing) {
+    // Two people of the same class walking past each other, overlapping for several frames,
+    // with a few pixels of detector jitter.
+    Tracker tracker;
+    int firstId = -1;
+    int secondId = -1;
+    int swaps = 0;
+    for (int frame = 0; frame < 60; frame++) {
+        int jitter = (frame * 7) % 5 - 2;
+        int firstX = 100 + 12 * frame;
+        int secondX = 800 - 12 * frame;
+        std::vector<DCSP_RESULT> detections = {Detection(0, 0.9f, firstX + jitter, 300, 60, 160),
+                                               Detection(0, 0.85f, secondX - jitter, 320 + jitter, 64, 170)};
+        tracker.Update(detections);
+        int first = TrackIdNear(detections, firstX, 300);
+        int second = TrackIdNear(detections, secondX, 320);
+        if (frame == 0) {
+            firstId = first;
+            secondId = second;
+            continue;
+        }
+        if (std::abs(firstX - secondX) < 40) {
+            // Boxes nearly coincide; which is which is only known again once they separate.
+            continue;
+        }
+        swaps += first != firstId || second != secondId;
+    }
+    EXPECT_TRUE(firstId > 0 && secondId > 0 && firstId != secondId);
+    EXPECT_EQ(swaps, 0);
+    EXPECT_EQ(tracker.TrackCount(), static_cast<size_t>(2));
+}
+
+CHECK_CASE(TrackerReleasesIdsAfterMaxAge) {
+    TRACKER_PARAM param;
+    param.maxAge = 5;
+    Tracker tracker(param);
+    std::vector<DCSP_RESULT> detections;
+    for (int frame = 0; frame < 10; frame++) {
+        detections = {Detection(2, 0.9f, 200 + 4 * frame, 200, 80, 80)};
+        tracker.Update(detections);
+    }
+    int id = detections[0].trackId;
+
+    // Missed for maxAge frames: the track survives and picks the object up again.
+    for (int frame = 0; frame < param.maxAge; frame++) {
+        detections.clear();
+        tracker.Update(detections);
+    }
+    EXPECT_EQ(tracker.TrackCount(), static_cast<size_t>(1));
+    detections = {Detection(2, 0.9f, 260, 200, 80, 80)};
+    tracker.Update(detections);
+    EXPECT_EQ(detections[0].trackId, id);
+
+    // Missed for one frame more than maxAge: the track is dropped and the object gets a new ID.
+    for (int frame = 0; frame <= param.maxAge; frame++) {
+        detections.clear();
+        tracker.Update(detections);
+    }
+    EXPECT_EQ(tracker.TrackCount(), static_cast<size_t>(0));
+    detections = {Detection(2, 0.9f, 260, 200, 80, 80)};
+    tracker.Update(detections);
+    EXPECT_TRUE(detections[0].trackId > 0 && detections[0].trackId != id);
+}
+
+CHECK_CASE(TrackerDetectsEveryNthFrame) {
+    TRACKER_PARAM param;
+    param.detectInterval = 4;
+    Tracker tracker(param);
+    std::vector<int> detectorFrames;
+    std::vector<DCSP_RESULT> results;
+    int lostFrames = 0;
+    for (int frame = 0; frame < 20; frame++) {
+        if (tracker.NeedsDetection()) {
+            detectorFrames.push_back(frame);
+            results = {Detection(1, 0.9f, 300 + 5 * frame, 240, 90, 120)};
+            tracker.Update(results);
+        } else {
+            tracker.Predict(results);
+            // Once two detector runs have given the filter a velocity, the predicted box follows
+            // the object between runs.
+            int error = results.size() == 1 ? std::abs(results[0].box.x + 45 - (300 + 5 * frame)) : 1000;
+            lostFrames += results.size() != 1 || (detectorFrames.size() > 1 && error > 6);
+        }
+    }
+    EXPECT_TRUE((detectorFrames == std::vector<int>{0, 4, 8, 12, 16}));
+    EXPECT_EQ(lostFrames, 0);
+
+    // A visible track decaying below minTrackConfidence brings the next detector run forward:
+    // 0.3 * 0.95^4 < 0.25, so after four predicted frames.
+    param.detectInterval = 10;
+    param.highThreshold = 0.2f;
+    Tracker early(param);
+    detectorFrames.clear();
+    for (int frame = 0; frame < 12; frame++) {
+        if (early.NeedsDetection()) {
+            detectorFrames.push_back(frame);
+            results = {Detection(1, 0.3f, 300, 240, 90, 120)};
+            early.Update(results);
+        } else {
+            early.Predict(results);
+        }
+    }
+    EXPECT_TRUE((detectorFrames == std::vector<int>{0, 5, 10}));
+}
@@ -0,0 +1,183 @@
+// Steady-state heap allocation checks, built as dcsp_alloc_check by cpp/CMakeLists.txt from the
+// per-frame kernels and AllocationCounter.cpp with DCSP_COUNT_ALLOCATIONS defined, so it needs
+// neither a model nor an ONNX Runtime library. Every case runs a kernel over a few warm-up frames,
+// which may size its scratch, and then fails on any operator new during the measured frames.
+//
+// Usage: dcsp_alloc_check [filter]
+
+#include "../CheckHarness.h"
+#include "AllocationCounter.h"
+#include "DetectionOutput.h"
+#include "FrameArena.h"
+#include "Nms.h"
+#include "Preprocess.h"
+#include "YoloDecode.h"
+#include <random>
+
+static_assert(AllocationCountingEnabled(), "dcsp_alloc_check must be built with DCSP_COUNT_ALLOCATIONS");
+
+namespace {
+
+constexpr int kWarmUpFrames = 8;
+constexpr int kMeasuredFrames = 32;
+constexpr int kInputSize = 640;
+constexpr int kNumClasses = 80;
+constexpr int kNumAnchors = 8400;
+
+// Runs frame(i) kWarmUpFrames times, then returns the allocations made by the next
+// kMeasuredFrames calls.
+template<typename Frame>
+uint64_t SteadyStateAllocations(Frame frame) {
+    for (int i = 0; i < kWarmUpFrames; i++) {
+        frame(i);
+    }
+    uint64_t before = ThreadAllocationCount();
+    for (int i = kWarmUpFrames; i < kWarmUpFrames + kMeasuredFrames; i++) {
+        frame(i);
+    }
+    return ThreadAllocationCount() - before;
+}
+
+// A YOLOv8 head ([4 + classes, anchors], channel-major) with about `objects` anchors above 0.5,
+// spread over the 640x640 input in clusters like real detections.
+std::vector<float> SyntheticHead(std::mt19937 &rng, int objects) {
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<float> head(static_cast<size_t>(4 + kNumClasses) * kNumAnchors);
+    for (int a = 0; a < kNumAnchors; a++) {
+        head[a] = unit(rng) * kInputSize;
+        head[kNumAnchors + a] = unit(rng) * kInputSize;
+        head[2 * kNumAnchors + a] = 8.f + unit(rng) * 200.f;
+        head[3 * kNumAnchors + a] = 8.f + unit(rng) * 200.f;
+        for (int c = 0; c < kNumClasses; c++) {
+            head[static_cast<size_t>(4 + c) * kNumAnchors + a] = unit(rng) * 0.3f;
+        }
+    }
+    for (int i = 0; i < objects; i++) {
+        int a = static_cast<int>(rng() % kNumAnchors);
+        int c = static_cast<int>(rng() % kNumClasses);
+        head[static_cast<size_t>(4 + c) * kNumAnchors + a] = 0.5f + 0.5f * unit(rng);
+    }
+    return head;
+}
+
+// Heads on both sides of NMS_GRID_MIN_CANDIDATES, cycled frame by frame.
+const std::vector<std::vector<float>> &Heads() {
+    static const std::vector<std::vector<float>> heads = [] {
+        std::mt19937 rng(11);
+        std::vector<std::vector<float>> result;
+        for (int objects: {12, 180, 1500}) {
+            result.push_back(SyntheticHead(rng, objects));
+        }
+        return result;
+    }();
+    return heads;
+}
+
+std::vector<DCSP_RESULT> SyntheticResults(int count) {
+    std::vector<DCSP_RESULT> results(count);
+    for (int i = 0; i < count; i++) {
+        results[i].classId = i % (kNumClasses + 3);
+        results[i].confidence = 0.25f + 0.7f * static_cast<float>(i % 17) / 17.f;
+        results[i].box = cv::Rect(i * 7 % 1900, i * 13 % 1060, 10 + i % 300, 12 + i % 200);
+        results[i].trackId = i % 3 == 0 ? -1 : i;
+    }
+    return results;
+}
+
+} // namespace
+
+CHECK_CASE(PreprocessLetterboxSteadyState) {
+    // Camera-sized BGRA and a strided BGR ROI, alternated so the workspace is rebuilt each frame.
+    cv::Mat bgra(1080, 1920, CV_8UC4);
+    cv::randu(bgra, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::Mat canvas(500, 800, CV_8UC3);
+    cv::randu(canvas, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::Mat roi = canvas(cv::Rect(13, 7, 641, 479));
+    std::vector<float> blob(3 * kInputSize * kInputSize);
+    PreprocessWorkspace workspace;
+    LETTERBOX_INFO letterbox;
+    char *Ret = RET_OK;
+    uint64_t allocations = SteadyStateAllocations([&](int i) {
+        const cv::Mat &frame = i % 2 == 0 ? bgra : roi;
+        Ret = PreprocessLetterbox(frame, kInputSize, kInputSize, blob.data(), workspace, letterbox);
+    });
+    EXPECT_TRUE(Ret == RET_OK);
+    EXPECT_EQ(allocations, static_cast<uint64_t>(0));
+}
+
+CHECK_CASE(PreprocessYuvLetterboxSteadyState) {
+    std::vector<uint8_t> nv21(1920 * 1080 * 3 / 2, 128);
+    std::vector<uint8_t> i420(1280 * 720 * 3 / 2, 128);
+    YUV_IMAGE nv21Frame = WrapNV21(nv21.data(), 1920, 1080, 1920);
+    YUV_IMAGE i420Frame = WrapI420(i420.data(), 1280, 720, 1280);
+    std::vector<float> blob(3 * kInputSize * kInputSize);
+    PreprocessWorkspace workspace;
+    LETTERBOX_INFO letterbox;
+    char *Ret = RET_OK;
+    uint64_t allocations = SteadyStateAllocations([&](int i) {
+        const YUV_IMAGE &frame = i % 2 == 0 ? nv21Frame : i420Frame;
+        Ret = PreprocessYuvLetterbox(frame, kInputSize, kInputSize, blob.data(), workspace, letterbox);
+    });
+    EXPECT_TRUE(Ret == RET_OK);
+    EXPECT_EQ(allocations, static_cast<uint64_t>(0));
+}
+
+CHECK_CASE(DecodeAndNmsSteadyState) {
+    const std::vector<std::vector<float>> &heads = Heads();
+    LETTERBOX_INFO letterbox = ComputeLetterbox(1920, 1080, kInputSize, kInputSize);
+    std::vector<DCSP_CANDIDATE> candidates;
+    NmsEngine engine;
+    NMS_PARAM param;
+    std::vector<int> keep;
+    char *Ret = RET_OK;
+    size_t kept = 0;
+    uint64_t allocations = SteadyStateAllocations([&](int i) {
+        const std::vector<float> &head = heads[i % heads.size()];
+        candidates.clear();
+        Ret = DecodeYoloV8(head.data(), 4 + kNumClasses, kNumAnchors, 0.5f, letterbox, candidates);
+        if (Ret == RET_OK) {
+            Ret = engine.Run(candidates, param, keep);
+        }
+        kept += keep.size();
+    });
+    EXPECT_TRUE(Ret == RET_OK);
+    EXPECT_TRUE(kept > 0);
+    EXPECT_EQ(allocations, static_cast<uint64_t>(0));
+}
+
+CHECK_CASE(DetectionOutputSteadyState) {
+    std::vector<std::string> classes;
+    for (int c = 0; c < kNumClasses; c++) {
+        classes.push_back("class_" + std::to_string(c));
+    }
+    std::vector<DCSP_RESULT> frames[] = {SyntheticResults(3), SyntheticResults(120), SyntheticResults(0)};
+    std::vector<float> packed(PackedDetectionsLength(120));
+    FrameArena arena;
+    size_t textBytes = 0;
+    uint64_t allocations = SteadyStateAllocations([&](int i) {
+        const std::vector<DCSP_RESULT> &results = frames[i % 3];
+        PackDetections(results, packed.data());
+        for (const DCSP_RESULT &result: results) {
+            size_t length = 0;
+            FormatDetectionJson(result, classes, arena, length);
+            textBytes += length;
+        }
+        arena.Reset();
+    });
+    EXPECT_TRUE(textBytes > 0);
+    EXPECT_EQ(allocations, static_cast<uint64_t>(0));
+}
+
+CHECK_CASE(FrameArenaSteadyState) {
+    // Starts far too small, so warm-up has to chain blocks and fold them on Reset.
+    FrameArena arena(256);
+    uint64_t allocations = SteadyStateAllocations([&](int i) {
+        std::vector<float, ArenaAllocator<float>> scratch{ArenaAllocator<float>(arena)};
+        scratch.resize(1000 + 500 * (i % 4));
+        for (int k = 0; k < 24; k++) {
+            arena.Allocate(64 + 32 * k, k % 2 == 0 ? 16 : 64);
+        }
+        arena.Reset();
+    });
+    EXPECT_EQ(allocations, static_cast<uint64_t>(0));
+}
@@ -1,11 +1,14 @@
 #include <jni.h>
 #include <jsi/jsi.h>
-#include <android/log.h>
+#include <fbjni/fbjni.h>
+#include <CallInvokerHolder.h>
+#include "Log.h"
 #include <thread>
 #include <sstream>
 #include <mutex>
 #include <chrono>
 #include "react-native-vision-jsi-processor.h"
+#include "onnxFrameProcessor.h"
 
 using namespace facebook;
 
@@ -20,19 +23,36 @@ static std::timed_mutex installMutex;
 
 extern "C"
 JNIEXPORT void JNICALL
-Java_com_visionjsiprocessoronnx_VisionJsiProcessorModule_nativeInstall(JNIEnv *env, jclass clazz, jlong runtimePtr) {
+Java_com_visionjsiprocessoronnx_VisionJsiProcessorModule_nativeInstall(JNIEnv *env, jclass clazz, jlong runtimePtr,
+                                                                       jobject callInvokerHolder,
+                                                                       jstring modelCacheDir) {
     auto *runtime = reinterpret_cast<jsi::Runtime *>(runtimePtr);
-    __android_log_print(ANDROID_LOG_DEBUG, "VisionJSIProcessor",
+    DCSP_LOGD("VisionJSIProcessor",
                           "Runtime pointer: %p, Thread: %s",
                           (void *)runtime, getThreadId().c_str());
 
     if (!runtime) {
-        __android_log_print(ANDROID_LOG_ERROR, "VisionJSIProcessor", "JSI Runtime is null!");
+        DCSP_LOGE("VisionJSIProcessor", "JSI Runtime is null!");
         return;
     }
 
+    std::shared_ptr<react::CallInvoker> callInvoker;
+    if (callInvokerHolder != nullptr) {
+        jni::alias_ref<react::CallInvokerHolder::javaobject> holder{
+            reinterpret_cast<react::CallInvokerHolder::javaobject>(callInvokerHolder)};
+        callInvoker = holder->cthis()->getCallInvoker();
+    } else {
+        DCSP_LOGW("VisionJSIProcessor", "No CallInvoker, detectAsync will be unavailable");
+    }
+
+    if (modelCacheDir != nullptr) {
+        const char *directory = env->GetStringUTFChars(modelCacheDir, nullptr);
+        OnnxFrameProcessor::setCacheDirectory(directory);
+        env->ReleaseStringUTFChars(modelCacheDir, directory);
+    }
+
     installMutex.lock();
-    __android_log_print(ANDROID_LOG_DEBUG, "VisionJSIProcessor", "Acquired mutex, calling install");
-    visionjsiprocessor::install(*runtime);
+    DCSP_LOGD("VisionJSIProcessor", "Acquired mutex, calling install");
+    visionjsiprocessor::install(*runtime, callInvoker);
     installMutex.unlock();
 }
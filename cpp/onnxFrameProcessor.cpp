@@ -1,17 +1,43 @@
 #include "onnxFrameProcessor.h"
 #include "TypedArray.h"
+#include "ModelRegistry.h"
+#include "Promise.h"
+#include "ThreadBudget.h"
+#include "MotionGate.h"
 #include <opencv2/imgproc.hpp>
-#include <sstream>
-#include <iomanip>
+#include <atomic>
 #include <cmath>
 #include <chrono>
+#include <stdexcept>
 
 using namespace facebook;
 using namespace jsi;
 
+static std::mutex gCacheDirectoryMutex;
+static std::string gCacheDirectory;
+
+// Applies to processOnnxFrame; detectors configure their own gate in createDetector. Bumping the
+// generation tells each frame processor thread to copy the parameters again, so frames only take
+// the mutex after setMotionGateOptions.
+static std::mutex gMotionGateMutex;
+static MOTION_GATE_PARAM gMotionGateParam;
+static std::atomic<uint64_t> gMotionGateGeneration{1};
+
+void OnnxFrameProcessor::setCacheDirectory(const std::string &directory) {
+  std::lock_guard<std::mutex> lock(gCacheDirectoryMutex);
+  gCacheDirectory = directory;
+  DCSP_LOGI("OnnxFrameProcessor", "Model cache directory: %s",
+            directory.empty() ? "(disabled)" : directory.c_str());
+}
+
+std::string OnnxFrameProcessor::cacheDirectory() {
+  std::lock_guard<std::mutex> lock(gCacheDirectoryMutex);
+  return gCacheDirectory;
+}
+
 OnnxFrameProcessor::OnnxFrameProcessor()
     : modelLoaded(false) {
-  __android_log_print(ANDROID_LOG_DEBUG, "OnnxFrameProcessor", "Processor created (using ONNX Runtime via DCSP_CORE)");
+  DCSP_LOGD("OnnxFrameProcessor", "Processor created (using ONNX Runtime via DCSP_CORE)");
 }
 
 OnnxFrameProcessor::~OnnxFrameProcessor() {
@@ -24,13 +50,14 @@ void OnnxFrameProcessor::clearState() {
   currentModelType.clear();
   currentModelInputSize.clear();
   modelLoaded = false;
-  __android_log_print(ANDROID_LOG_DEBUG, "OnnxFrameProcessor", "State cleared");
+  DCSP_LOGD("OnnxFrameProcessor", "State cleared");
 }
 
-void OnnxFrameProcessor::loadModel(const std::string &modelPath, const std::string &modelType, int inputWidth, int inputHeight) {
-  if (modelLoaded && currentModelPath == modelPath && currentModelType == modelType &&
+void OnnxFrameProcessor::loadModel(const std::string &modelPath, const std::string &modelType, int inputWidth, int inputHeight,
+                                   EXECUTION_PROVIDER provider) {
+  if (modelLoaded && currentModelPath == modelPath && currentModelType == modelType && requestedProvider == provider &&
       currentModelInputSize.size() == 2 && currentModelInputSize[0] == inputHeight && currentModelInputSize[1] == inputWidth) {
-    __android_log_print(ANDROID_LOG_DEBUG, "OnnxFrameProcessor", "Model %s (%dx%d) already loaded", modelPath.c_str(), inputWidth, inputHeight);
+    DCSP_LOGD("OnnxFrameProcessor", "Model %s (%dx%d) already loaded", modelPath.c_str(), inputWidth, inputHeight);
     return;
   }
 
@@ -39,11 +66,12 @@ void OnnxFrameProcessor::loadModel(const std::string &modelPath, const std::stri
   currentModelPath = modelPath;
   currentModelType = modelType;
   currentModelInputSize = {inputHeight, inputWidth};
+  requestedProvider = provider;
 
-  __android_log_print(ANDROID_LOG_INFO, "OnnxFrameProcessor", "Loading ONNX model from: %s with input size %dx%d", modelPath.c_str(), inputWidth, inputHeight);
+  DCSP_LOGI("OnnxFrameProcessor", "Loading ONNX model from: %s with input size %dx%d", modelPath.c_str(), inputWidth, inputHeight);
 
   if (modelType != "onnx") {
-      __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Invalid model type for DCSP_CORE integration: %s. Only 'onnx' is supported.", modelType.c_str());
+      DCSP_LOGE("OnnxFrameProcessor", "Invalid model type for DCSP_CORE integration: %s. Only 'onnx' is supported.", modelType.c_str());
       throw std::runtime_error("Invalid model type for DCSP_CORE, expected 'onnx'");
   }
 
@@ -59,150 +87,269 @@ void OnnxFrameProcessor::loadModel(const std::string &modelPath, const std::stri
     params.iouThreshold = 0.5;
 
     params.CudaEnable = false;
-
-    params.IntraOpNumThreads = 2;
+    params.Provider = provider;
+
+    // Also fixes ORT's global pools on the first load, see ThreadBudget.h.
+    THREAD_BUDGET budget = GetThreadBudget();
+    params.IntraOpNumThreads = budget.IntraOpNumThreads;
+    params.AllowSpinning = budget.AllowSpinning;
+    if (budget.PinToBigCores) {
+      params.IntraOpAffinity = IntraOpAffinityString(budget.IntraOpNumThreads, GetCpuTopology().bigCores);
+    }
     params.LogSeverityLevel = 3;
+    params.CacheDir = cacheDirectory();
 
     char* createResult = dcspCore->CreateSession(params);
     if (createResult != RET_OK) {
         std::string errorMsg = "Failed to create ONNX Runtime session: ";
         errorMsg += createResult;
-        __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "%s", errorMsg.c_str());
+        DCSP_LOGE("OnnxFrameProcessor", "%s", errorMsg.c_str());
         dcspCore.reset();
         throw std::runtime_error(errorMsg);
     }
 
     modelLoaded = true;
-    __android_log_print(ANDROID_LOG_INFO, "OnnxFrameProcessor", "ONNX Runtime session created successfully for %s", modelPath.c_str());
+    loadMs = dcspCore->sessionCreateMs;
+    loadedFromCache = dcspCore->sessionFromCache;
+    loadedProvider = dcspCore->provider;
+    DCSP_LOGI("OnnxFrameProcessor", "ONNX Runtime session created successfully for %s in %.1f ms (%s, %s)",
+              modelPath.c_str(), dcspCore->sessionCreateMs,
+              params.CacheDir.empty() ? "cache off" : dcspCore->sessionFromCache ? "cache hit" : "cache miss",
+              ExecutionProviderName(loadedProvider));
 
   } catch (const std::exception &e) {
-    __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Exception during model loading: %s", e.what());
+    DCSP_LOGE("OnnxFrameProcessor", "Exception during model loading: %s", e.what());
     clearState();
     throw;
   } catch (...) {
-    __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Unknown exception during model loading");
+    DCSP_LOGE("OnnxFrameProcessor", "Unknown exception during model loading");
     clearState();
     throw std::runtime_error("Unknown error during model loading");
   }
 }
 
-std::vector<std::string> OnnxFrameProcessor::processFrame(const cv::Mat &image,
-                                                          const std::vector<std::string> &classes,
-                                                          float modelConfidenceThreshold,
-                                                          float modelNmsThreshold,
-                                                          float modelScoreThreshold) {
+char *OnnxFrameProcessor::processFrame(const cv::Mat &image,
+                                       float modelConfidenceThreshold,
+                                       float modelNmsThreshold,
+                                       float modelScoreThreshold,
+                                       std::vector<DCSP_RESULT> &oResults) {
+    return detect(image, modelConfidenceThreshold, modelNmsThreshold, modelScoreThreshold, oResults);
+}
+
+char *OnnxFrameProcessor::processFrame(const YUV_IMAGE &image,
+                                       float modelConfidenceThreshold,
+                                       float modelNmsThreshold,
+                                       float modelScoreThreshold,
+                                       std::vector<DCSP_RESULT> &oResults) {
+    return detect(image, modelConfidenceThreshold, modelNmsThreshold, modelScoreThreshold, oResults);
+}
+
+char *OnnxFrameProcessor::processFrame(const DCSP_BLOB &blob,
+                                       float modelConfidenceThreshold,
+                                       float modelNmsThreshold,
+                                       float modelScoreThreshold,
+                                       std::vector<DCSP_RESULT> &oResults) {
+    return detect(blob, modelConfidenceThreshold, modelNmsThreshold, modelScoreThreshold, oResults);
+}
+
+char *OnnxFrameProcessor::processFrameTiled(const cv::Mat &image,
+                                            const TILE_PARAM &tiles,
+                                            float modelConfidenceThreshold,
+                                            float modelNmsThreshold,
+                                            std::vector<DCSP_RESULT> &oResults) {
+    return detect(image, modelConfidenceThreshold, modelNmsThreshold, 0.f, oResults, &tiles);
+}
+
+char *OnnxFrameProcessor::processFrameTiled(const YUV_IMAGE &image,
+                                            const TILE_PARAM &tiles,
+                                            float modelConfidenceThreshold,
+                                            float modelNmsThreshold,
+                                            std::vector<DCSP_RESULT> &oResults) {
+    return detect(image, modelConfidenceThreshold, modelNmsThreshold, 0.f, oResults, &tiles);
+}
+
+template<typename Image>
+char *OnnxFrameProcessor::detect(Image &image,
+                                 float modelConfidenceThreshold,
+                                 float modelNmsThreshold,
+                                 float modelScoreThreshold,
+                                 std::vector<DCSP_RESULT> &results,
+                                 const TILE_PARAM *tiles) {
+    std::lock_guard<std::mutex> lock(runMutex);
+    // Callers hand in the same vector every frame, so once it has grown this does not allocate.
+    results.clear();
     if (!modelLoaded || !dcspCore) {
-        __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Model not loaded, cannot process frame.");
-        return {};
+        DCSP_LOGE("OnnxFrameProcessor", "Model not loaded, cannot process frame.");
+        return "[DCSP_ONNX]:Model is not loaded.";
     }
 
-    __android_log_print(ANDROID_LOG_DEBUG, "OnnxFrameProcessor", 
+    DCSP_LOGD("OnnxFrameProcessor", 
         "Processing frame with thresholds - Confidence: %.3f, NMS: %.3f",
         modelConfidenceThreshold, modelNmsThreshold);
 
-    dcspCore->classes = classes;
-
     modelConfidenceThreshold = std::max(0.0f, std::min(1.0f, modelConfidenceThreshold));
     modelNmsThreshold = std::max(0.0f, std::min(1.0f, modelNmsThreshold));
 
     dcspCore->rectConfidenceThreshold = modelConfidenceThreshold;
     dcspCore->iouThreshold = modelNmsThreshold;
 
-    std::vector<DCSP_RESULT> results;
-    results.reserve(20);
-
     auto start = std::chrono::high_resolution_clock::now();
 
-    cv::Mat mutableImage = image.clone();
-    char* runResult = dcspCore->RunSession(mutableImage, results);
+    char* runResult = nullptr;
+    if constexpr (std::is_same<std::decay_t<Image>, DCSP_BLOB>::value) {
+        // Blobs are letterboxed whole by InferencePipeline; there is nothing left to tile.
+        runResult = dcspCore->RunSession(image, results);
+    } else {
+        runResult = tiles != nullptr ? dcspCore->RunTiledSession(image, *tiles, results)
+                                     : dcspCore->RunSession(image, results);
+    }
 
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::milli> duration = end - start;
-    __android_log_print(ANDROID_LOG_DEBUG, "OnnxFrameProcessor", 
+    DCSP_LOGD("OnnxFrameProcessor", 
         "RunSession completed in %.2f ms, found %zu results.", 
         duration.count(), results.size());
 
     if (runResult != RET_OK) {
         std::string errorMsg = "Error during ONNX Runtime RunSession: ";
         errorMsg += runResult;
-        __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "%s", errorMsg.c_str());
-        return {};
+        DCSP_LOGE("OnnxFrameProcessor", "%s", errorMsg.c_str());
+        results.clear();
+        return runResult;
     }
 
-    std::vector<std::string> detections;
-    detections.reserve(results.size());
+    DCSP_LOGD("OnnxFrameProcessor",
+        "Processing complete. Returning %zu detections", results.size());
+    return RET_OK;
+}
 
-    for (const auto& res : results) {
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(5);
-        oss << "{ \"class_id\": " << res.classId
-            << ", \"class_name\": \"" << getClassName(res.classId, classes) << "\""
-            << ", \"confidence\": " << res.confidence
-            << ", \"box\": [" << res.box.x << ", " << res.box.y
-            << ", " << res.box.width << ", " << res.box.height << "] }";
-        detections.push_back(oss.str());
+void OnnxFrameProcessor::registerInputBlobs(const std::vector<float *> &blobs) {
+    std::lock_guard<std::mutex> lock(runMutex);
+    if (dcspCore) {
+        dcspCore->RegisterInputBlobs(blobs);
     }
+}
 
-    __android_log_print(ANDROID_LOG_DEBUG, "OnnxFrameProcessor", 
-        "Processing complete. Returning %zu detections", detections.size());
+void OnnxFrameProcessor::unregisterInputBlobs(const std::vector<float *> &blobs) {
+    std::lock_guard<std::mutex> lock(runMutex);
+    if (dcspCore) {
+        dcspCore->UnregisterInputBlobs(blobs);
+    }
+}
 
-    return detections;
+static int orientationDegrees(const std::string &orientation) {
+  if (orientation == "landscape-right") return 90;
+  if (orientation == "portrait-upside-down") return 180;
+  if (orientation == "landscape-left") return 270;
+  return 0;
 }
 
-static std::shared_ptr<OnnxFrameProcessor> gProcessor = std::make_shared<OnnxFrameProcessor>();
+LockedYuvFrame::LockedYuvFrame(const jni::global_ref<vision::JFrame> &frame) {
+#if __ANDROID_API__ >= 29
+  if (FrameCaptureActive()) {
+    captureMeta.timestampNs = static_cast<int64_t>(frame->getTimestamp());
+    captureMeta.orientation = orientationDegrees(frame->getOrientation()->getUnionValue()->toStdString());
+  }
+  buffer = frame->getHardwareBuffer();
+  AHardwareBuffer_acquire(buffer);
+
+  AHardwareBuffer_Desc description;
+  AHardwareBuffer_describe(buffer, &description);
+  if (description.format != AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420) {
+    AHardwareBuffer_release(buffer);
+    throw std::runtime_error("Camera frame is not YUV_420_888, set pixelFormat=\"yuv\" on the Camera");
+  }
 
-void OnnxFrameProcessor::registerOnnxFrameProcessor(jsi::Runtime &runtime) {
-  auto onnxProcessorFunc = [=](jsi::Runtime &runtime,
-                               const jsi::Value &thisArg,
-                               const jsi::Value *args,
-                               size_t count) -> jsi::Value {
-    auto start_time = std::chrono::high_resolution_clock::now();
-    __android_log_print(ANDROID_LOG_DEBUG, "OnnxFrameProcessor", "JSI processOnnxFrame called");
+  AHardwareBuffer_Planes planes;
+  if (AHardwareBuffer_lockPlanes(buffer, AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN, -1, nullptr, &planes) != 0) {
+    AHardwareBuffer_release(buffer);
+    throw std::runtime_error("Failed to lock HardwareBuffer for reading");
+  }
+  if (planes.planeCount != 3 || planes.planes[1].pixelStride != planes.planes[2].pixelStride ||
+      planes.planes[1].rowStride != planes.planes[2].rowStride) {
+    AHardwareBuffer_unlock(buffer, nullptr);
+    AHardwareBuffer_release(buffer);
+    throw std::runtime_error("Unsupported YUV plane layout");
+  }
 
-    const int expectedArgCount = 12;
-    if (count != expectedArgCount) {
-      __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Expected %d arguments, received %zu", expectedArgCount, count);
-      throw jsi::JSError(runtime, "Expected " + std::to_string(expectedArgCount) + " arguments");
+  yuv.width = static_cast<int>(description.width);
+  yuv.height = static_cast<int>(description.height);
+  yuv.y = static_cast<const uint8_t *>(planes.planes[0].data);
+  yuv.u = static_cast<const uint8_t *>(planes.planes[1].data);
+  yuv.v = static_cast<const uint8_t *>(planes.planes[2].data);
+  yuv.yRowStride = static_cast<int>(planes.planes[0].rowStride);
+  yuv.uvRowStride = static_cast<int>(planes.planes[1].rowStride);
+  yuv.uvPixelStride = static_cast<int>(planes.planes[1].pixelStride);
+#else
+  throw std::runtime_error("Reading camera frames natively requires minSdkVersion 29 or higher");
+#endif
+}
+
+LockedYuvFrame::~LockedYuvFrame() {
+#if __ANDROID_API__ >= 29
+  AHardwareBuffer_unlock(buffer, nullptr);
+  AHardwareBuffer_release(buffer);
+#endif
+}
+
+jsi::Value detectionsToJsi(jsi::Runtime &runtime, const std::vector<DCSP_RESULT> &results,
+                           const std::vector<std::string> &classes, DETECTION_OUTPUT_FORMAT format) {
+    PerfTimer marshalTimer(PERF_MARSHAL);
+    if (format == DETECTION_OUTPUT_PACKED) {
+        // Written in place into the JS-owned buffer, no intermediate vector.
+        mrousavy::TypedArray<mrousavy::TypedArrayKind::Float32Array> packed(runtime, PackedDetectionsLength(results.size()));
+        PackDetections(results, reinterpret_cast<float *>(packed.data(runtime)));
+        return packed;
     }
+    // The JSON text only has to live until JSI has copied it, so it is formatted into a per-thread
+    // arena instead of one std::string per detection.
+    static thread_local FrameArena textArena(4096);
+    jsi::Array jsiDetections(runtime, results.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        size_t length = 0;
+        const char *text = FormatDetectionJson(results[i], classes, textArena, length);
+        jsiDetections.setValueAtIndex(runtime, i,
+            jsi::String::createFromUtf8(runtime, reinterpret_cast<const uint8_t *>(text), length));
+    }
+    textArena.Reset();
+    return jsiDetections;
+}
 
-    double rows = args[0].asNumber();
-    double cols = args[1].asNumber();
-    double channels = args[2].asNumber();
-    jsi::Object input = args[3].asObject(runtime);
-    
+cv::Mat typedArrayToMat(jsi::Runtime &runtime, jsi::Object input, double rows, double cols, double channels) {
     auto inputBuffer = mrousavy::getTypedArray(runtime, std::move(input));
     auto kind = inputBuffer.getKind(runtime);
     bool isFloat32 = (kind == mrousavy::TypedArrayKind::Float32Array);
-    
+
     int type = -1;
-    if (channels == 1) { 
+    if (channels == 1) {
         type = isFloat32 ? CV_32F : CV_8U;
     } else if (channels == 3) {
         type = isFloat32 ? CV_32FC3 : CV_8UC3;
     } else if (channels == 4) {
         type = isFloat32 ? CV_32FC4 : CV_8UC4;
     } else {
-        __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Invalid channel count: %f", channels);
+        DCSP_LOGE("OnnxFrameProcessor", "Invalid channel count: %f", channels);
         throw jsi::JSError(runtime, "Invalid channel count passed to frameBufferToMat!");
     }
 
-    __android_log_print(ANDROID_LOG_DEBUG, "OnnxFrameProcessor", 
-        "Image dims: %.0fx%.0f, channels: %.0f, data type: %s", 
+    DCSP_LOGD("OnnxFrameProcessor",
+        "Image dims: %.0fx%.0f, channels: %.0f, data type: %s",
         rows, cols, channels, isFloat32 ? "float32" : "uint8");
 
-    auto vec = inputBuffer.toVector(runtime);
-    cv::Mat image(static_cast<int>(rows), static_cast<int>(cols), type);
-    
+    // Wrap the ArrayBuffer memory in a Mat header instead of copying it; the caller's
+    // jsi::Value keeps the buffer alive until the host function returns.
+    size_t byteLength = inputBuffer.byteLength(runtime);
+    uint8_t *pixels = inputBuffer.getBuffer(runtime).data(runtime) + inputBuffer.byteOffset(runtime);
+    cv::Mat image(static_cast<int>(rows), static_cast<int>(cols), type, pixels);
+
     size_t expectedSize = image.total() * image.elemSize();
-    if (vec.size() != expectedSize) {
-        __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", 
-            "TypedArray size (%zu) does not match image buffer size (%zu) for %s data", 
-            vec.size(), expectedSize, isFloat32 ? "float32" : "uint8");
+    if (byteLength != expectedSize) {
+        DCSP_LOGE("OnnxFrameProcessor",
+            "TypedArray size (%zu) does not match image buffer size (%zu) for %s data",
+            byteLength, expectedSize, isFloat32 ? "float32" : "uint8");
         throw jsi::JSError(runtime, "TypedArray size mismatch");
     }
 
-    memcpy(image.data, vec.data(), vec.size());
-
     cv::Mat processImage;
     if (isFloat32) {
         image.convertTo(processImage, CV_8UC3, 255.0);
@@ -211,9 +358,101 @@ void OnnxFrameProcessor::registerOnnxFrameProcessor(jsi::Runtime &runtime) {
     }
 
     if (processImage.empty()) {
-        __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Image is empty after conversion");
+        DCSP_LOGE("OnnxFrameProcessor", "Image is empty after conversion");
         throw jsi::JSError(runtime, "Empty image");
     }
+    return processImage;
+}
+
+// The model fields shared by preloadModel and replayFrameCapture configs.
+static MODEL_KEY modelKeyFromConfig(jsi::Runtime &runtime, const jsi::Object &config, const char *caller) {
+  MODEL_KEY key;
+  jsi::Value modelPath = config.getProperty(runtime, "modelPath");
+  if (!modelPath.isString()) {
+    throw jsi::JSError(runtime, std::string(caller) + ": modelPath is required");
+  }
+  key.modelPath = modelPath.asString(runtime).utf8(runtime);
+  jsi::Value modelType = config.getProperty(runtime, "modelType");
+  if (modelType.isString()) key.modelType = modelType.asString(runtime).utf8(runtime);
+  jsi::Value inputWidth = config.getProperty(runtime, "inputWidth");
+  if (inputWidth.isNumber()) key.inputWidth = static_cast<int>(inputWidth.asNumber());
+  jsi::Value inputHeight = config.getProperty(runtime, "inputHeight");
+  if (inputHeight.isNumber()) key.inputHeight = static_cast<int>(inputHeight.asNumber());
+  jsi::Value executionProvider = config.getProperty(runtime, "executionProvider");
+  if (executionProvider.isString() &&
+      !ParseExecutionProvider(executionProvider.asString(runtime).utf8(runtime), key.provider)) {
+    throw jsi::JSError(runtime, std::string(caller) + ": executionProvider must be " + EXECUTION_PROVIDER_NAMES);
+  }
+  if (key.inputWidth <= 0 || key.inputHeight <= 0) {
+    throw jsi::JSError(runtime, "Invalid model input dimensions provided");
+  }
+  return key;
+}
+
+static bool sameModelKey(const MODEL_KEY &a, const MODEL_KEY &b) {
+  return a.modelPath == b.modelPath && a.modelType == b.modelType && a.inputWidth == b.inputWidth &&
+         a.inputHeight == b.inputHeight && a.provider == b.provider;
+}
+
+// processOnnxFrame's gate, one per frame processor thread like its detections. The cached
+// detections are only valid for the model and thresholds they were produced with.
+static MotionGate &processOnnxFrameGate(const MODEL_KEY &key, float confidenceThreshold, float nmsThreshold,
+                                        float scoreThreshold) {
+  static thread_local MotionGate gate;
+  static thread_local uint64_t gateGeneration = 0;
+  static thread_local MODEL_KEY gateKey;
+  static thread_local float gateThresholds[3] = {-1.f, -1.f, -1.f};
+  uint64_t generation = gMotionGateGeneration.load(std::memory_order_acquire);
+  if (gateGeneration != generation) {
+    std::lock_guard<std::mutex> lock(gMotionGateMutex);
+    gate.SetParam(gMotionGateParam);
+    gateGeneration = generation;
+  }
+  if (!sameModelKey(gateKey, key) || gateThresholds[0] != confidenceThreshold ||
+      gateThresholds[1] != nmsThreshold || gateThresholds[2] != scoreThreshold) {
+    gate.Reset();
+    gateKey = key;
+    gateThresholds[0] = confidenceThreshold;
+    gateThresholds[1] = nmsThreshold;
+    gateThresholds[2] = scoreThreshold;
+  }
+  return gate;
+}
+
+void OnnxFrameProcessor::registerOnnxFrameProcessor(jsi::Runtime &runtime,
+                                                    std::shared_ptr<react::CallInvoker> callInvoker) {
+  auto onnxProcessorFunc = [=](jsi::Runtime &runtime,
+                               const jsi::Value &thisArg,
+                               const jsi::Value *args,
+                               size_t count) -> jsi::Value {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    DCSP_LOGD("OnnxFrameProcessor", "JSI processOnnxFrame called");
+
+    const int expectedArgCount = 12;
+    if (count != expectedArgCount && count != expectedArgCount + 1) {
+      DCSP_LOGE("OnnxFrameProcessor", "Expected %d arguments, received %zu", expectedArgCount, count);
+      throw jsi::JSError(runtime, "Expected " + std::to_string(expectedArgCount) + " arguments");
+    }
+
+    DETECTION_OUTPUT_FORMAT outputFormat = DETECTION_OUTPUT_JSON;
+    if (count > expectedArgCount && !args[12].isUndefined() &&
+        !ParseDetectionOutputFormat(args[12].asString(runtime).utf8(runtime), outputFormat)) {
+      throw jsi::JSError(runtime, "outputFormat must be \"json\" or \"packed\"");
+    }
+
+    double rows = args[0].asNumber();
+    double cols = args[1].asNumber();
+    double channels = args[2].asNumber();
+    jsi::Object input = args[3].asObject(runtime);
+
+    // A VisionCamera Frame is read straight from its HardwareBuffer; anything else must be a TypedArray.
+    std::shared_ptr<vision::FrameHostObject> cameraFrame;
+    cv::Mat processImage;
+    if (input.isHostObject<vision::FrameHostObject>(runtime)) {
+        cameraFrame = input.getHostObject<vision::FrameHostObject>(runtime);
+    } else {
+        processImage = typedArrayToMat(runtime, std::move(input), rows, cols, channels);
+    }
 
     std::string modelPath = args[4].asString(runtime).utf8(runtime);
     float modelConfidenceThreshold = static_cast<float>(args[5].asNumber());
@@ -240,29 +479,67 @@ void OnnxFrameProcessor::registerOnnxFrameProcessor(jsi::Runtime &runtime) {
     }
 
     try {
-        gProcessor->loadModel(modelPath, modelType, inputWidth, inputHeight);
-
-        auto detections = gProcessor->processFrame(processImage, classes,
-                                                   modelConfidenceThreshold,
-                                                   modelNmsThreshold,
-                                                   modelScoreThreshold);
+        MODEL_KEY key;
+        key.modelPath = modelPath;
+        key.modelType = modelType;
+        key.inputWidth = inputWidth;
+        key.inputHeight = inputHeight;
+        // The first call only starts loading; frames return null until the session is warm.
+        std::shared_ptr<OnnxFrameProcessor> processor = ModelRegistry::instance().acquireIfReady(key);
+        if (!processor) {
+          DCSP_LOGD("OnnxFrameProcessor", "Model %s not ready yet", modelPath.c_str());
+          return jsi::Value::null();
+        }
 
-        jsi::Array jsiDetections(runtime, detections.size());
-        for (size_t i = 0; i < detections.size(); i++) {
-          jsiDetections.setValueAtIndex(runtime, i,
-              jsi::Value(runtime, jsi::String::createFromUtf8(runtime, detections[i])));
+        // Reused across frames on the frame processor thread.
+        static thread_local std::vector<DCSP_RESULT> detections;
+        MotionGate &gate = processOnnxFrameGate(key, modelConfidenceThreshold, modelNmsThreshold,
+                                                modelScoreThreshold);
+        // Registry sessions keep DCSP_INIT_PARAM's class-aware NMS.
+        CAPTURE_SETTINGS captureSettings = MakeCaptureSettings(modelConfidenceThreshold, modelNmsThreshold,
+                                                               inputWidth, inputHeight, true);
+        if (cameraFrame) {
+            LockedYuvFrame frame(cameraFrame->getFrame());
+            if (gate.NeedsInference(frame.image())) {
+                char *runResult = processor->processFrame(frame.image(),
+                                                          modelConfidenceThreshold,
+                                                          modelNmsThreshold,
+                                                          modelScoreThreshold,
+                                                          detections);
+                // A failed run leaves the previous reference and its detections in place.
+                if (runResult != RET_OK) throw std::runtime_error(runResult);
+                gate.Commit(detections);
+            } else {
+                detections = gate.Cached();
+            }
+            if (FrameCaptureActive()) CaptureFrame(frame.image(), frame.meta(), &detections, &captureSettings);
+        } else {
+            if (gate.NeedsInference(processImage)) {
+                char *runResult = processor->processFrame(processImage,
+                                                          modelConfidenceThreshold,
+                                                          modelNmsThreshold,
+                                                          modelScoreThreshold,
+                                                          detections);
+                if (runResult != RET_OK) throw std::runtime_error(runResult);
+                gate.Commit(detections);
+            } else {
+                detections = gate.Cached();
+            }
+            if (FrameCaptureActive()) CaptureFrame(processImage, CaptureMetaNow(), &detections, &captureSettings);
         }
 
+        jsi::Value jsiDetections = detectionsToJsi(runtime, detections, classes, outputFormat);
+
         auto end_time = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double, std::milli> total_duration = end_time - start_time;
-        __android_log_print(ANDROID_LOG_INFO, "OnnxFrameProcessor", "JSI processOnnxFrame finished in %.2f ms, returning %zu detections", total_duration.count(), detections.size());
+        DCSP_LOGI("OnnxFrameProcessor", "JSI processOnnxFrame finished in %.2f ms, returning %zu detections", total_duration.count(), detections.size());
         return jsiDetections;
 
     } catch (const std::exception& e) {
-        __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Exception in JSI call: %s", e.what());
+        DCSP_LOGE("OnnxFrameProcessor", "Exception in JSI call: %s", e.what());
         throw jsi::JSError(runtime, std::string("ONNX Processing Error: ") + e.what());
     } catch (...) {
-        __android_log_print(ANDROID_LOG_ERROR, "OnnxFrameProcessor", "Unknown exception in JSI call");
+        DCSP_LOGE("OnnxFrameProcessor", "Unknown exception in JSI call");
         throw jsi::JSError(runtime, "Unknown ONNX Processing Error");
     }
   };
@@ -272,5 +549,369 @@ void OnnxFrameProcessor::registerOnnxFrameProcessor(jsi::Runtime &runtime) {
                  12,
                  onnxProcessorFunc);
   runtime.global().setProperty(runtime, "processOnnxFrame", func);
-  __android_log_print(ANDROID_LOG_INFO, "OnnxFrameProcessor", "JSI function 'processOnnxFrame' (ONNX Runtime backend) registered");
+  DCSP_LOGI("OnnxFrameProcessor", "JSI function 'processOnnxFrame' (ONNX Runtime backend) registered");
+
+  auto preloadModel = [callInvoker](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                                    size_t count) -> jsi::Value {
+    if (count != 1 || !args[0].isObject()) {
+      throw jsi::JSError(runtime, "preloadModel(config) expects a config object");
+    }
+    if (!callInvoker) {
+      throw jsi::JSError(runtime, "preloadModel: no JS CallInvoker available");
+    }
+    MODEL_KEY key = modelKeyFromConfig(runtime, args[0].asObject(runtime), "preloadModel");
+    // An explicit preload is the place to retry a model that failed to load.
+    ModelRegistry::instance().load(key, true);
+    return mrousavy::Promise::createPromise(runtime, [callInvoker, key](std::shared_ptr<mrousavy::Promise> promise) {
+      // Queued behind the load on the registry's loader thread, so it finds the model ready and the
+      // JS thread never blocks. The promise is moved on to the JS thread, its jsi::Values must not
+      // be released anywhere else.
+      ModelRegistry::instance().post([callInvoker, key, promise]() mutable {
+        std::shared_ptr<OnnxFrameProcessor> processor;
+        std::string error;
+        try {
+          processor = ModelRegistry::instance().acquire(key);
+        } catch (const std::exception &e) {
+          error = e.what();
+        }
+        callInvoker->invokeAsync([promise = std::move(promise), processor, error, key](jsi::Runtime &runtime) {
+          if (!processor) {
+            promise->reject("Failed to load " + key.modelPath + ": " + error);
+            return;
+          }
+          jsi::Object info(runtime);
+          info.setProperty(runtime, "modelPath", jsi::String::createFromUtf8(runtime, key.modelPath));
+          info.setProperty(runtime, "sessionCreateMs", processor->sessionCreateMs());
+          info.setProperty(runtime, "fromCache", processor->sessionFromCache());
+          info.setProperty(runtime, "executionProvider",
+                           jsi::String::createFromUtf8(runtime, ExecutionProviderName(processor->executionProvider())));
+          promise->resolve(std::move(info));
+        });
+      });
+    });
+  };
+  runtime.global().setProperty(runtime, "preloadModel",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "preloadModel"), 1,
+                                            preloadModel));
+
+  auto startFrameCapture = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                              size_t count) -> jsi::Value {
+    if (count < 1 || !args[0].isString()) {
+      throw jsi::JSError(runtime, "startFrameCapture(path, maxFrames?) expects a file path");
+    }
+    size_t maxFrames = count > 1 && args[1].isNumber() ? static_cast<size_t>(args[1].asNumber()) : 0;
+    char *result = StartFrameCapture(args[0].asString(runtime).utf8(runtime), maxFrames);
+    if (result != RET_OK) {
+      throw jsi::JSError(runtime, std::string("startFrameCapture: ") + result);
+    }
+    return jsi::Value::undefined();
+  };
+  runtime.global().setProperty(runtime, "startFrameCapture",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "startFrameCapture"), 2,
+                                            startFrameCapture));
+
+  auto stopFrameCapture = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                             size_t count) -> jsi::Value {
+    return jsi::Value(static_cast<double>(StopFrameCapture()));
+  };
+  runtime.global().setProperty(runtime, "stopFrameCapture",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "stopFrameCapture"), 0,
+                                            stopFrameCapture));
+
+  auto replayFrameCapture = [callInvoker](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                                          size_t count) -> jsi::Value {
+    if (count != 2 || !args[0].isString() || !args[1].isObject()) {
+      throw jsi::JSError(runtime, "replayFrameCapture(path, config) expects a file path and a config object");
+    }
+    if (!callInvoker) {
+      throw jsi::JSError(runtime, "replayFrameCapture: no JS CallInvoker available");
+    }
+    std::string path = args[0].asString(runtime).utf8(runtime);
+    jsi::Object config = args[1].asObject(runtime);
+    MODEL_KEY key = modelKeyFromConfig(runtime, config, "replayFrameCapture");
+    // Input size and thresholds default to the ones the capture was recorded with, so parity
+    // compares like with like; a capture that does not say falls back to 640 and 0.5.
+    CAPTURE_SETTINGS recorded;
+    char *settingsResult = ReadCaptureSettings(path, recorded);
+    if (settingsResult != RET_OK) {
+      throw jsi::JSError(runtime, std::string("replayFrameCapture: ") + settingsResult);
+    }
+    bool fromCapture = recorded.inputWidth > 0 && recorded.inputHeight > 0;
+    if (fromCapture && !config.getProperty(runtime, "inputWidth").isNumber() &&
+        !config.getProperty(runtime, "inputHeight").isNumber()) {
+      key.inputWidth = recorded.inputWidth;
+      key.inputHeight = recorded.inputHeight;
+    }
+    if (fromCapture && recorded.classAware == 0) {
+      DCSP_LOGW("OnnxFrameProcessor", "%s was recorded with class-agnostic NMS; replay uses class-aware NMS",
+                path.c_str());
+    }
+    REPLAY_PARAM param;
+    jsi::Value realTime = config.getProperty(runtime, "realTime");
+    if (realTime.isBool()) param.realTime = realTime.getBool();
+    jsi::Value minParity = config.getProperty(runtime, "minParity");
+    if (minParity.isNumber()) param.minParity = static_cast<float>(minParity.asNumber());
+    jsi::Value confidence = config.getProperty(runtime, "confidenceThreshold");
+    float confidenceThreshold = confidence.isNumber() ? static_cast<float>(confidence.asNumber())
+                                : fromCapture ? recorded.confidenceThreshold : 0.5f;
+    jsi::Value nms = config.getProperty(runtime, "nmsThreshold");
+    float nmsThreshold = nms.isNumber() ? static_cast<float>(nms.asNumber())
+                         : fromCapture ? recorded.nmsThreshold : 0.5f;
+
+    ModelRegistry::instance().load(key);
+    return mrousavy::Promise::createPromise(runtime, [callInvoker, key, path, param, confidenceThreshold,
+                                                      nmsThreshold](std::shared_ptr<mrousavy::Promise> promise) {
+      // Runs on the registry's loader thread, so loads queued meanwhile wait for the replay.
+      ModelRegistry::instance().post([callInvoker, key, path, param, confidenceThreshold, nmsThreshold,
+                                      promise]() mutable {
+        REPLAY_STATS stats;
+        std::string error;
+        try {
+          std::shared_ptr<OnnxFrameProcessor> processor = ModelRegistry::instance().acquire(key);
+          FrameCaptureReader reader;
+          char *result = reader.Open(path);
+          if (result == RET_OK) {
+            auto run = [&](const CAPTURE_FRAME &frame, std::vector<DCSP_RESULT> &oResult) -> char * {
+              if (frame.format == CAPTURE_I420) {
+                return processor->processFrame(CaptureFrameYuv(frame), confidenceThreshold, nmsThreshold, 0.f,
+                                               oResult);
+              }
+              return processor->processFrame(CaptureFrameMat(frame), confidenceThreshold, nmsThreshold, 0.f,
+                                             oResult);
+            };
+            result = ReplayCapture(reader, param, run, stats);
+          }
+          if (result != RET_OK) error = result;
+        } catch (const std::exception &e) {
+          error = e.what();
+        }
+        DCSP_LOGI("OnnxFrameProcessor", "Replayed %zu frames of %s at %.1f FPS, %zu/%zu reference detections matched",
+                  stats.frames, path.c_str(), stats.fps, stats.matchedDetections, stats.referenceDetections);
+        callInvoker->invokeAsync([promise = std::move(promise), stats, error, path](jsi::Runtime &runtime) {
+          if (!error.empty()) {
+            promise->reject("Failed to replay " + path + ": " + error + " (" + std::to_string(stats.matchedDetections) +
+                            "/" + std::to_string(stats.referenceDetections) + " reference detections matched)");
+            return;
+          }
+          jsi::Object info(runtime);
+          info.setProperty(runtime, "frames", static_cast<double>(stats.frames));
+          info.setProperty(runtime, "elapsedMs", stats.elapsedMs);
+          info.setProperty(runtime, "fps", stats.fps);
+          info.setProperty(runtime, "latencyP50Ms", stats.latencyP50Ms);
+          info.setProperty(runtime, "latencyP95Ms", stats.latencyP95Ms);
+          info.setProperty(runtime, "latencyMaxMs", stats.latencyMaxMs);
+          info.setProperty(runtime, "referenceDetections", static_cast<double>(stats.referenceDetections));
+          info.setProperty(runtime, "replayDetections", static_cast<double>(stats.replayDetections));
+          info.setProperty(runtime, "matchedDetections", static_cast<double>(stats.matchedDetections));
+          info.setProperty(runtime, "meanMatchedIou", stats.meanMatchedIou);
+          info.setProperty(runtime, "parity", stats.parity);
+          info.setProperty(runtime, "precision", stats.precision);
+          promise->resolve(std::move(info));
+        });
+      });
+    });
+  };
+  runtime.global().setProperty(runtime, "replayFrameCapture",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "replayFrameCapture"), 2,
+                                            replayFrameCapture));
+
+  auto setThreadBudget = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                            size_t count) -> jsi::Value {
+    if (count != 1 || !args[0].isObject()) {
+      throw jsi::JSError(runtime, "setThreadBudget(options) expects an options object");
+    }
+    jsi::Object options = args[0].asObject(runtime);
+    THREAD_BUDGET budget;
+    jsi::Value value = options.getProperty(runtime, "intraOpThreads");
+    if (value.isNumber()) budget.IntraOpNumThreads = static_cast<int>(value.asNumber());
+    value = options.getProperty(runtime, "interOpThreads");
+    if (value.isNumber()) budget.InterOpNumThreads = static_cast<int>(value.asNumber());
+    value = options.getProperty(runtime, "openCvThreads");
+    if (value.isNumber()) budget.OpenCvNumThreads = static_cast<int>(value.asNumber());
+    value = options.getProperty(runtime, "pinToBigCores");
+    if (value.isBool()) budget.PinToBigCores = value.getBool();
+    value = options.getProperty(runtime, "allowSpinning");
+    if (value.isBool()) budget.AllowSpinning = value.getBool();
+
+    char *result = SetThreadBudget(budget);
+    if (result != RET_OK) {
+      throw jsi::JSError(runtime, std::string("setThreadBudget must be called before any model is loaded: ") + result);
+    }
+    return jsi::Value::undefined();
+  };
+  runtime.global().setProperty(runtime, "setThreadBudget",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "setThreadBudget"), 1,
+                                            setThreadBudget));
+
+  auto getThreadBudget = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                            size_t count) -> jsi::Value {
+    THREAD_BUDGET budget = GetThreadBudget();
+    const CPU_TOPOLOGY &topology = GetCpuTopology();
+    jsi::Object info(runtime);
+    info.setProperty(runtime, "intraOpThreads", budget.IntraOpNumThreads);
+    info.setProperty(runtime, "interOpThreads", budget.InterOpNumThreads);
+    info.setProperty(runtime, "openCvThreads", budget.OpenCvNumThreads);
+    info.setProperty(runtime, "pinToBigCores", budget.PinToBigCores);
+    info.setProperty(runtime, "allowSpinning", budget.AllowSpinning);
+    info.setProperty(runtime, "cores", topology.coreCount);
+    info.setProperty(runtime, "bigCores", static_cast<int>(topology.bigCores.size()));
+    return info;
+  };
+  runtime.global().setProperty(runtime, "getThreadBudget",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "getThreadBudget"), 0,
+                                            getThreadBudget));
+
+  auto setPerfStatsEnabled = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                                size_t count) -> jsi::Value {
+    if (count != 1 || !args[0].isBool()) {
+      throw jsi::JSError(runtime, "setPerfStatsEnabled(enabled) expects a boolean");
+    }
+    SetPerfStatsEnabled(args[0].getBool());
+    return jsi::Value::undefined();
+  };
+  runtime.global().setProperty(runtime, "setPerfStatsEnabled",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "setPerfStatsEnabled"), 1,
+                                            setPerfStatsEnabled));
+
+  auto getPerfStats = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                         size_t count) -> jsi::Value {
+    bool reset = count > 0 && args[0].isBool() && args[0].getBool();
+    PERF_STAGE_STATS stats[PERF_STAGE_COUNT];
+    GetPerfStats(stats, reset);
+    jsi::Object result(runtime);
+    for (int stage = 0; stage < PERF_STAGE_COUNT; stage++) {
+      jsi::Object entry(runtime);
+      entry.setProperty(runtime, "count", static_cast<double>(stats[stage].count));
+      entry.setProperty(runtime, "meanMs", stats[stage].meanMs);
+      entry.setProperty(runtime, "p50Ms", stats[stage].p50Ms);
+      entry.setProperty(runtime, "p95Ms", stats[stage].p95Ms);
+      entry.setProperty(runtime, "p99Ms", stats[stage].p99Ms);
+      entry.setProperty(runtime, "maxMs", stats[stage].maxMs);
+      result.setProperty(runtime, PerfStageName(static_cast<PERF_STAGE>(stage)), entry);
+    }
+    // Decision counters are kept even while timing is off.
+    MOTION_GATE_STATS motion;
+    GetMotionGateStats(motion, reset);
+    jsi::Object motionGate(runtime);
+    motionGate.setProperty(runtime, "checked", static_cast<double>(motion.checked));
+    motionGate.setProperty(runtime, "skipped", static_cast<double>(motion.skipped));
+    motionGate.setProperty(runtime, "ran", static_cast<double>(motion.checked - motion.skipped));
+    motionGate.setProperty(runtime, "lastDifference", motion.lastDifference);
+    result.setProperty(runtime, "motionGate", motionGate);
+    result.setProperty(runtime, "enabled", PerfStatsEnabled());
+    return result;
+  };
+  runtime.global().setProperty(runtime, "getPerfStats",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "getPerfStats"), 1,
+                                            getPerfStats));
+
+  auto setMotionGateOptions = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                                 size_t count) -> jsi::Value {
+    if (count != 1 || !args[0].isObject()) {
+      throw jsi::JSError(runtime, "setMotionGateOptions(options) expects an options object");
+    }
+    jsi::Object options = args[0].asObject(runtime);
+    std::lock_guard<std::mutex> lock(gMotionGateMutex);
+    MOTION_GATE_PARAM param = gMotionGateParam;
+    jsi::Value value = options.getProperty(runtime, "threshold");
+    if (value.isNumber()) {
+      if (value.asNumber() < 0) {
+        throw jsi::JSError(runtime, "setMotionGateOptions: threshold must be non-negative");
+      }
+      param.threshold = static_cast<float>(value.asNumber());
+    }
+    value = options.getProperty(runtime, "maxSkipFrames");
+    if (value.isNumber()) param.maxSkipFrames = std::max(0, static_cast<int>(value.asNumber()));
+    gMotionGateParam = param;
+    gMotionGateGeneration.fetch_add(1, std::memory_order_release);
+    return jsi::Value::undefined();
+  };
+  runtime.global().setProperty(runtime, "setMotionGateOptions",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "setMotionGateOptions"), 1,
+                                            setMotionGateOptions));
+
+  auto setModelCacheBudget = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                                size_t count) -> jsi::Value {
+    if (count != 1 || !args[0].isNumber() || args[0].asNumber() < 0) {
+      throw jsi::JSError(runtime, "setModelCacheBudget(bytes) expects a non-negative number");
+    }
+    ModelRegistry::instance().setMemoryBudget(static_cast<size_t>(args[0].asNumber()));
+    return jsi::Value::undefined();
+  };
+  runtime.global().setProperty(runtime, "setModelCacheBudget",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "setModelCacheBudget"), 1,
+                                            setModelCacheBudget));
+
+  auto getModelCacheInfo = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                              size_t count) -> jsi::Value {
+    ModelRegistry &registry = ModelRegistry::instance();
+    jsi::Object info(runtime);
+    info.setProperty(runtime, "budget", static_cast<double>(registry.memoryBudget()));
+    info.setProperty(runtime, "inUse", static_cast<double>(registry.memoryInUse()));
+    info.setProperty(runtime, "models", static_cast<double>(registry.size()));
+    return info;
+  };
+  runtime.global().setProperty(runtime, "getModelCacheInfo",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "getModelCacheInfo"), 0,
+                                            getModelCacheInfo));
+
+  auto setTensorPoolOptions = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                                 size_t count) -> jsi::Value {
+    if (count != 1 || !args[0].isObject()) {
+      throw jsi::JSError(runtime, "setTensorPoolOptions(options) expects an options object");
+    }
+    jsi::Object options = args[0].asObject(runtime);
+    TENSOR_POOL_PARAM param = TensorPool::Shared().Param();
+    jsi::Value value = options.getProperty(runtime, "budgetBytes");
+    if (value.isNumber()) {
+      if (value.asNumber() < 0) {
+        throw jsi::JSError(runtime, "setTensorPoolOptions: budgetBytes must be non-negative");
+      }
+      param.BudgetBytes = static_cast<size_t>(value.asNumber());
+    }
+    value = options.getProperty(runtime, "hugePages");
+    if (value.isBool()) param.HugePages = value.getBool();
+    TensorPool::Shared().SetParam(param);
+    return jsi::Value::undefined();
+  };
+  runtime.global().setProperty(runtime, "setTensorPoolOptions",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "setTensorPoolOptions"), 1,
+                                            setTensorPoolOptions));
+
+  auto getTensorPoolInfo = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                              size_t count) -> jsi::Value {
+    TENSOR_POOL_STATS stats = TensorPool::Shared().Stats();
+    jsi::Object info(runtime);
+    info.setProperty(runtime, "budget", static_cast<double>(stats.budgetBytes));
+    info.setProperty(runtime, "inUse", static_cast<double>(stats.liveBytes));
+    info.setProperty(runtime, "cached", static_cast<double>(stats.cachedBytes));
+    info.setProperty(runtime, "peak", static_cast<double>(stats.peakBytes));
+    info.setProperty(runtime, "allocations", static_cast<double>(stats.allocations));
+    info.setProperty(runtime, "reused", static_cast<double>(stats.reused));
+    info.setProperty(runtime, "refused", static_cast<double>(stats.refused));
+    return info;
+  };
+  runtime.global().setProperty(runtime, "getTensorPoolInfo",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "getTensorPoolInfo"), 0,
+                                            getTensorPoolInfo));
+
+  auto setModelCacheDirectory = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                                   size_t count) -> jsi::Value {
+    std::string directory = count > 0 && args[0].isString() ? args[0].asString(runtime).utf8(runtime) : "";
+    OnnxFrameProcessor::setCacheDirectory(directory);
+    return jsi::Value::undefined();
+  };
+  runtime.global().setProperty(runtime, "setModelCacheDirectory",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "setModelCacheDirectory"), 1,
+                                            setModelCacheDirectory));
+
+  auto evictModel = [](jsi::Runtime &runtime, const jsi::Value &thisArg, const jsi::Value *args,
+                       size_t count) -> jsi::Value {
+    std::string modelPath = count > 0 && args[0].isString() ? args[0].asString(runtime).utf8(runtime) : "";
+    ModelRegistry::instance().evict(modelPath);
+    return jsi::Value::undefined();
+  };
+  runtime.global().setProperty(runtime, "evictModel",
+      jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forUtf8(runtime, "evictModel"), 1,
+                                            evictModel));
 }
\ No newline at end of file
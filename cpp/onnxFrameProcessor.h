@@ -8,42 +8,128 @@
 #include <string>
 #include <stdexcept>
 #include <cmath>
-#include <android/log.h>
+#include "Log.h"
 #include <memory>
+#include <mutex>
+#include <ReactCommon/CallInvoker.h>
 
 #include "Inference.h"
+#include "DetectionOutput.h"
+#include "FrameCapture.h"
+#include "FrameHostObject.h"
 
 using namespace facebook;
 using namespace jsi;
 
-inline std::string getClassName(int id, const std::vector<std::string>& classes) {
-  return (id >= 0 && id < static_cast<int>(classes.size())) ? classes[id] : "unknown";
-}
+// Holds a CPU read lock on a camera frame's YUV_420_888 HardwareBuffer for the scope of one inference.
+class LockedYuvFrame {
+public:
+  explicit LockedYuvFrame(const jni::global_ref<vision::JFrame> &frame);
+  ~LockedYuvFrame();
+
+  LockedYuvFrame(const LockedYuvFrame &) = delete;
+  LockedYuvFrame &operator=(const LockedYuvFrame &) = delete;
+
+  const YUV_IMAGE &image() const { return yuv; }
+
+  // Timestamp and orientation, only read from the Frame while a capture is recording.
+  const CAPTURE_META &meta() const { return captureMeta; }
+
+private:
+  AHardwareBuffer *buffer = nullptr;
+  YUV_IMAGE yuv;
+  CAPTURE_META captureMeta;
+};
+
+Value detectionsToJsi(Runtime &runtime, const std::vector<DCSP_RESULT> &results,
+                      const std::vector<std::string> &classes, DETECTION_OUTPUT_FORMAT format);
+
+cv::Mat typedArrayToMat(Runtime &runtime, Object input, double rows, double cols, double channels);
 
 class OnnxFrameProcessor {
 public:
   OnnxFrameProcessor();
   ~OnnxFrameProcessor();
 
-  void loadModel(const std::string &modelPath, const std::string &modelType, int inputWidth, int inputHeight);
+  void loadModel(const std::string &modelPath, const std::string &modelType, int inputWidth, int inputHeight,
+                 EXECUTION_PROVIDER provider = EP_CPU);
 
-  std::vector<std::string> processFrame(const cv::Mat &image,
-                                          const std::vector<std::string> &classes,
-                                          float modelConfidenceThreshold,
-                                          float modelNmsThreshold,
-                                          float modelScoreThreshold);
+  // RET_OK, or the error of the run with oResults left empty.
+  char *processFrame(const cv::Mat &image,
+                     float modelConfidenceThreshold,
+                     float modelNmsThreshold,
+                     float modelScoreThreshold,
+                     std::vector<DCSP_RESULT> &oResults);
+
+  char *processFrame(const YUV_IMAGE &image,
+                     float modelConfidenceThreshold,
+                     float modelNmsThreshold,
+                     float modelScoreThreshold,
+                     std::vector<DCSP_RESULT> &oResults);
+
+  char *processFrame(const DCSP_BLOB &blob,
+                     float modelConfidenceThreshold,
+                     float modelNmsThreshold,
+                     float modelScoreThreshold,
+                     std::vector<DCSP_RESULT> &oResults);
+
+  // Sliced inference, see DCSP_CORE::RunTiledSession.
+  char *processFrameTiled(const cv::Mat &image,
+                          const TILE_PARAM &tiles,
+                          float modelConfidenceThreshold,
+                          float modelNmsThreshold,
+                          std::vector<DCSP_RESULT> &oResults);
+
+  char *processFrameTiled(const YUV_IMAGE &image,
+                          const TILE_PARAM &tiles,
+                          float modelConfidenceThreshold,
+                          float modelNmsThreshold,
+                          std::vector<DCSP_RESULT> &oResults);
+
+  // Input tensors for InferencePipeline's slots, see DCSP_CORE::RegisterInputBlobs.
+  void registerInputBlobs(const std::vector<float *> &blobs);
+  void unregisterInputBlobs(const std::vector<float *> &blobs);
 
   bool isModelLoaded() const { return modelLoaded; }
 
-  static void registerOnnxFrameProcessor(Runtime &runtime);
+  // Cold-start report of the last loadModel.
+  double sessionCreateMs() const { return loadMs; }
+  bool sessionFromCache() const { return loadedFromCache; }
+  // Provider the session ended up on, resolved when EP_AUTO was requested.
+  EXECUTION_PROVIDER executionProvider() const { return loadedProvider; }
+
+  // {height, width} of the loaded model input.
+  const std::vector<int> &inputSize() const { return currentModelInputSize; }
+
+  // Where optimized models are cached for later loads; empty disables the cache.
+  static void setCacheDirectory(const std::string &directory);
+  static std::string cacheDirectory();
+
+  // callInvoker resolves preloadModel promises on the JS thread.
+  static void registerOnnxFrameProcessor(Runtime &runtime, std::shared_ptr<react::CallInvoker> callInvoker);
 private:
   std::unique_ptr<DCSP_CORE> dcspCore;
+  // A processor can be shared (see ModelRegistry); DCSP_CORE runs one frame at a time.
+  std::mutex runMutex;
   std::string currentModelPath;
   std::string currentModelType;
   std::vector<int> currentModelInputSize;
   bool modelLoaded;
+  double loadMs = 0.0;
+  bool loadedFromCache = false;
+  EXECUTION_PROVIDER requestedProvider = EP_CPU;
+  EXECUTION_PROVIDER loadedProvider = EP_CPU;
 
   void clearState();
+
+  // tiles == nullptr runs the whole frame.
+  template<typename Image>
+  char *detect(Image &image,
+               float modelConfidenceThreshold,
+               float modelNmsThreshold,
+               float modelScoreThreshold,
+               std::vector<DCSP_RESULT> &results,
+               const TILE_PARAM *tiles = nullptr);
 };
 
 #endif
\ No newline at end of file
@@ -3,9 +3,12 @@
 
 #include <jsi/jsilib.h>
 #include <jsi/jsi.h>
+#include <ReactCommon/CallInvoker.h>
+#include <memory>
 
 namespace visionjsiprocessor {
-  void install(facebook::jsi::Runtime& jsiRuntime);
+  // callInvoker schedules work on the JS thread; it delivers asynchronous detector results.
+  void install(facebook::jsi::Runtime& jsiRuntime, std::shared_ptr<facebook::react::CallInvoker> callInvoker);
 }
 
 #endif
@@ -0,0 +1,169 @@
+// Replays a frame capture (see FrameCapture.h) through DCSP_CORE, either as fast as possible or
+// at the recorded frame times, and compares the detections with the ones stored in the capture.
+// Captures come from startFrameCapture() on a device or dcsp_throughput --record on the host.
+//
+//   dcsp_replay --model yolov8n.onnx --capture session.dcap [--size 640] [--confidence T] [--nms T]
+//               [--provider cpu|xnnpack|auto] [--threads N] [--realtime] [--min-parity R]
+//
+// Input size, thresholds and class-aware NMS default to the ones the capture was recorded with
+// (640 and 0.5 for captures that do not say). Parity is recall: the share of reference detections
+// matched. Exits non-zero when a frame fails to run or fewer than R of them match.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "FrameCapture.h"
+#include "ThreadBudget.h"
+
+namespace {
+
+typedef struct _CLI_OPTIONS {
+    std::string modelPath;
+    std::string capturePath;
+    // 0 or negative: from the capture.
+    int inputSize = 0;
+    float confidence = -1.f;
+    float nms = -1.f;
+    EXECUTION_PROVIDER provider = EP_CPU;
+    int threads = 0;
+    bool realTime = false;
+    float minParity = 0.f;
+} CLI_OPTIONS;
+
+
+bool ParseOptions(int argc, char **argv, CLI_OPTIONS &oOptions) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--realtime") {
+            oOptions.realTime = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char *value = argv[++i];
+        if (arg == "--model") {
+            oOptions.modelPath = value;
+        } else if (arg == "--capture") {
+            oOptions.capturePath = value;
+        } else if (arg == "--size") {
+            oOptions.inputSize = std::atoi(value);
+            if (oOptions.inputSize <= 0) {
+                return false;
+            }
+        } else if (arg == "--confidence" || arg == "--nms") {
+            float threshold = static_cast<float>(std::atof(value));
+            if (threshold < 0.f || threshold > 1.f) {
+                return false;
+            }
+            (arg == "--nms" ? oOptions.nms : oOptions.confidence) = threshold;
+        } else if (arg == "--provider") {
+            if (!ParseExecutionProvider(value, oOptions.provider)) {
+                return false;
+            }
+        } else if (arg == "--threads") {
+            oOptions.threads = std::atoi(value);
+        } else if (arg == "--min-parity") {
+            oOptions.minParity = static_cast<float>(std::atof(value));
+        } else {
+            return false;
+        }
+    }
+    return !oOptions.modelPath.empty() && !oOptions.capturePath.empty();
+}
+
+}  // namespace
+
+
+int main(int argc, char **argv) {
+    CLI_OPTIONS options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "Usage: %s --model <model.onnx> --capture <file> [--size 640] [--confidence T] [--nms T]\n"
+                     "          [--provider cpu|xnnpack|nnapi|cuda|auto] [--threads N] [--realtime]\n"
+                     "          [--min-parity R]\n", argv[0]);
+        return 2;
+    }
+
+    THREAD_BUDGET requested;
+    requested.IntraOpNumThreads = options.threads;
+    if (SetThreadBudget(requested) != RET_OK) {
+        std::fprintf(stderr, "Could not apply the thread budget.\n");
+        return 1;
+    }
+    THREAD_BUDGET budget = GetThreadBudget();
+
+    FrameCaptureReader reader;
+    char *Ret = reader.Open(options.capturePath);
+    if (Ret != RET_OK) {
+        std::fprintf(stderr, "%s\n", Ret);
+        return 1;
+    }
+
+    // Decode as the capture was recorded unless told otherwise, so parity compares like with like.
+    const CAPTURE_SETTINGS &recorded = reader.Settings();
+    bool fromCapture = recorded.inputWidth > 0 && recorded.inputHeight > 0;
+    int inputWidth = options.inputSize > 0 ? options.inputSize : fromCapture ? recorded.inputWidth : 640;
+    int inputHeight = options.inputSize > 0 ? options.inputSize : fromCapture ? recorded.inputHeight : 640;
+
+    DCSP_INIT_PARAM params;
+    params.ModelPath = options.modelPath;
+    params.ModelType = YOLO_ORIGIN_V8;
+    params.imgSize = {inputHeight, inputWidth};
+    params.RectConfidenceThreshold = options.confidence >= 0.f ? options.confidence
+                                     : fromCapture ? recorded.confidenceThreshold : 0.5f;
+    params.iouThreshold = options.nms >= 0.f ? options.nms : fromCapture ? recorded.nmsThreshold : 0.5f;
+    params.ClassAwareNms = !fromCapture || recorded.classAware != 0;
+    params.Provider = options.provider;
+    params.IntraOpNumThreads = budget.IntraOpNumThreads;
+    params.AllowSpinning = budget.AllowSpinning;
+    DCSP_CORE core;
+    Ret = core.CreateSession(params);
+    if (Ret != RET_OK) {
+        std::fprintf(stderr, "%s\n", Ret);
+        return 1;
+    }
+
+    REPLAY_PARAM replayParam;
+    replayParam.realTime = options.realTime;
+    replayParam.minParity = options.minParity;
+    REPLAY_STATS stats;
+    auto run = [&core](const CAPTURE_FRAME &frame, std::vector<DCSP_RESULT> &oResult) -> char * {
+        if (frame.format == CAPTURE_I420) {
+            return core.RunSession(CaptureFrameYuv(frame), oResult);
+        }
+        return core.RunSession(CaptureFrameMat(frame), oResult);
+    };
+    char *replayResult = ReplayCapture(reader, replayParam, run, stats);
+    // A parity failure still has complete stats worth printing; a run error does not.
+    bool parityFailed = replayResult != RET_OK && stats.parity < replayParam.minParity;
+    if (replayResult != RET_OK && !parityFailed) {
+        std::fprintf(stderr, "%s\n", replayResult);
+        return 1;
+    }
+
+    std::printf("capture    %s (%zu frames, %s)\n", options.capturePath.c_str(), stats.frames,
+                options.realTime ? "recorded timing" : "max speed");
+    std::printf("model      %s (%dx%d, %s)\n", options.modelPath.c_str(), inputWidth, inputHeight,
+                ExecutionProviderName(core.provider));
+    std::printf("decode     confidence %.3f, NMS IoU %.3f, %s NMS (%s)\n", params.RectConfidenceThreshold,
+                params.iouThreshold, params.ClassAwareNms ? "class-aware" : "class-agnostic",
+                fromCapture ? "as recorded unless overridden" : "not recorded in the capture");
+    std::printf("throughput %.2f FPS over %.1f ms\n", stats.fps, stats.elapsedMs);
+    std::printf("latency    p50 %.3f ms, p95 %.3f ms, max %.3f ms\n", stats.latencyP50Ms, stats.latencyP95Ms,
+                stats.latencyMaxMs);
+    if (stats.referenceDetections > 0) {
+        std::printf("parity     %zu/%zu reference detections matched (%.1f%% recall), mean IoU %.3f\n",
+                    stats.matchedDetections, stats.referenceDetections, 100.0 * stats.parity, stats.meanMatchedIou);
+        std::printf("precision  %zu/%zu replayed detections on reference frames matched (%.1f%%), %zu replayed\n",
+                    stats.matchedDetections, stats.comparedDetections, 100.0 * stats.precision,
+                    stats.replayDetections);
+    } else {
+        std::printf("parity     capture has no reference detections\n");
+    }
+    if (parityFailed) {
+        std::fprintf(stderr, "%s (minimum parity %.1f%%)\n", replayResult, 100.0 * options.minParity);
+        return 1;
+    }
+    return 0;
+}
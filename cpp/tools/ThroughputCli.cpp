@@ -0,0 +1,341 @@
+// Headless throughput runner for DCSP_CORE. Decodes a video file with cv::VideoCapture (or reads
+// every image in a folder), runs each frame through RunSession and reports FPS plus the
+// per-stage latency histograms from PerfStats. Built by cpp/CMakeLists.txt:
+//
+//   dcsp_throughput --model yolov8n.onnx --input clip.mp4 [--size 640] [--provider cpu|xnnpack|auto]
+//                   [--threads N] [--frames N] [--warmup N] [--cache-dir <dir>] [--record <capture>]
+//                   [--tensor-budget MiB] [--huge-pages] [--detect-interval N] [--motion-threshold X]
+//                   [--tiles CxR] [--tile-overlap F] [--assert-no-alloc]
+//
+// --record writes every timed frame and its detections to a capture for dcsp_replay; the writes
+// are part of the timed loop, so leave it off for throughput numbers.
+//
+// --tensor-budget caps TensorPool (ORT intermediates and bound buffers); --huge-pages backs its
+// large blocks with transparent huge pages.
+//
+// --detect-interval N attaches a Tracker and runs the model on at most every Nth frame, predicting
+// the tracks in between, to measure the saving on a given clip.
+//
+// --motion-threshold X puts a MotionGate in front of the model: frames whose mean luma difference
+// from the last inferred frame is below X reuse its detections. Only meaningful on real footage;
+// an image folder rarely has near-identical consecutive frames.
+//
+// --tiles CxR runs RunTiledSession on a C x R grid (plus the whole frame) in one batched run;
+// compare detections/frame and FPS against the default whole-frame pass on footage with small objects.
+//
+// --assert-no-alloc (needs -DDCSP_COUNT_ALLOCATIONS=ON) warms up on every input frame once so all
+// per-frame buffers reach their final size, then exits non-zero if any timed RunSession still
+// allocates from the global heap outside ONNX Runtime.
+//
+// Frames are decoded ahead of the timed loop, so FPS measures the core and not the video codec.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "AllocationCounter.h"
+#include "FrameCapture.h"
+#include "MotionGate.h"
+#include "TensorPool.h"
+#include "Tracker.h"
+#include "ThreadBudget.h"
+
+namespace {
+
+typedef struct _CLI_OPTIONS {
+    std::string modelPath;
+    std::string inputPath;
+    std::string cacheDir;
+    std::string recordPath;
+    int inputSize = 640;
+    EXECUTION_PROVIDER provider = EP_CPU;
+    int threads = 0;
+    int frames = 0;
+    int warmup = 10;
+    bool assertNoAlloc = false;
+    int tensorBudgetMb = 0;
+    bool hugePages = false;
+    int detectInterval = 0;
+    float motionThreshold = 0.f;
+    bool tiled = false;
+    TILE_PARAM tiles;
+} CLI_OPTIONS;
+
+
+void PrintUsage(const char *program) {
+    std::fprintf(stderr,
+                 "Usage: %s --model <model.onnx> --input <video|image dir> [--size 640]\n"
+                 "          [--provider cpu|xnnpack|nnapi|auto] [--threads N] [--frames N] [--warmup N]\n"
+                 "          [--cache-dir <dir>] [--record <capture>] [--tensor-budget MiB] [--huge-pages]\n"
+                 "          [--detect-interval N] [--motion-threshold X] [--tiles CxR] [--tile-overlap F]\n"
+                 "          [--assert-no-alloc]\n", program);
+}
+
+
+bool ParseOptions(int argc, char **argv, CLI_OPTIONS &oOptions) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--assert-no-alloc") {
+            oOptions.assertNoAlloc = true;
+            continue;
+        }
+        if (arg == "--huge-pages") {
+            oOptions.hugePages = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char *value = argv[++i];
+        if (arg == "--model") {
+            oOptions.modelPath = value;
+        } else if (arg == "--input") {
+            oOptions.inputPath = value;
+        } else if (arg == "--cache-dir") {
+            oOptions.cacheDir = value;
+        } else if (arg == "--record") {
+            oOptions.recordPath = value;
+        } else if (arg == "--size") {
+            oOptions.inputSize = std::atoi(value);
+        } else if (arg == "--provider") {
+            if (!ParseExecutionProvider(value, oOptions.provider)) {
+                return false;
+            }
+        } else if (arg == "--threads") {
+            oOptions.threads = std::atoi(value);
+        } else if (arg == "--frames") {
+            oOptions.frames = std::atoi(value);
+        } else if (arg == "--warmup") {
+            oOptions.warmup = std::atoi(value);
+        } else if (arg == "--detect-interval") {
+            oOptions.detectInterval = std::atoi(value);
+        } else if (arg == "--tiles") {
+            if (std::sscanf(value, "%dx%d", &oOptions.tiles.columns, &oOptions.tiles.rows) != 2) {
+                return false;
+            }
+            oOptions.tiled = true;
+        } else if (arg == "--tile-overlap") {
+            oOptions.tiles.overlap = static_cast<float>(std::atof(value));
+        } else if (arg == "--motion-threshold") {
+            oOptions.motionThreshold = static_cast<float>(std::atof(value));
+        } else if (arg == "--tensor-budget") {
+            oOptions.tensorBudgetMb = std::atoi(value);
+        } else {
+            return false;
+        }
+    }
+    return !oOptions.modelPath.empty() && !oOptions.inputPath.empty() && oOptions.inputSize > 0;
+}
+
+
+bool LoadFrames(const std::string &path, std::vector<cv::Mat> &oFrames) {
+    namespace fs = std::filesystem;
+    if (fs::is_directory(path)) {
+        std::vector<fs::path> files;
+        for (const fs::directory_entry &entry: fs::directory_iterator(path)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        for (const fs::path &file: files) {
+            cv::Mat image = cv::imread(file.string(), cv::IMREAD_COLOR);
+            if (!image.empty()) {
+                oFrames.push_back(image);
+            }
+        }
+    } else {
+        cv::VideoCapture capture(path);
+        if (!capture.isOpened()) {
+            return false;
+        }
+        cv::Mat frame;
+        while (capture.read(frame)) {
+            oFrames.push_back(frame.clone());
+        }
+    }
+    return !oFrames.empty();
+}
+
+}  // namespace
+
+
+int main(int argc, char **argv) {
+    CLI_OPTIONS options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    if (options.assertNoAlloc && !AllocationCountingEnabled()) {
+        std::fprintf(stderr, "--assert-no-alloc needs a build configured with -DDCSP_COUNT_ALLOCATIONS=ON\n");
+        return 2;
+    }
+
+    THREAD_BUDGET requested;
+    requested.IntraOpNumThreads = options.threads;
+    if (SetThreadBudget(requested) != RET_OK) {
+        std::fprintf(stderr, "Could not apply the thread budget.\n");
+        return 1;
+    }
+    THREAD_BUDGET budget = GetThreadBudget();
+
+    TENSOR_POOL_PARAM poolParam;
+    poolParam.BudgetBytes = static_cast<size_t>(std::max(options.tensorBudgetMb, 0)) * 1024 * 1024;
+    poolParam.HugePages = options.hugePages;
+    TensorPool::Shared().SetParam(poolParam);
+
+    std::vector<cv::Mat> frames;
+    if (!LoadFrames(options.inputPath, frames)) {
+        std::fprintf(stderr, "No frames could be read from %s\n", options.inputPath.c_str());
+        return 1;
+    }
+    int frameCount = options.frames > 0 ? options.frames : static_cast<int>(frames.size());
+
+    DCSP_INIT_PARAM params;
+    params.ModelPath = options.modelPath;
+    params.ModelType = YOLO_ORIGIN_V8;
+    params.imgSize = {options.inputSize, options.inputSize};
+    params.RectConfidenceThreshold = 0.5;
+    params.iouThreshold = 0.5;
+    params.Provider = options.provider;
+    params.IntraOpNumThreads = budget.IntraOpNumThreads;
+    params.AllowSpinning = budget.AllowSpinning;
+    params.CacheDir = options.cacheDir;
+
+    DCSP_CORE core;
+    char *Ret = core.CreateSession(params);
+    if (Ret != RET_OK) {
+        std::fprintf(stderr, "%s\n", Ret);
+        return 1;
+    }
+
+    TRACKER_PARAM trackerParam;
+    trackerParam.detectInterval = std::max(options.detectInterval, 1);
+    Tracker tracker(trackerParam);
+    MOTION_GATE_PARAM gateParam;
+    gateParam.threshold = std::max(options.motionThreshold, 0.f);
+    MotionGate gate(gateParam);
+
+    std::vector<DCSP_RESULT> results;
+    // Steady state for the allocation check means every frame has been seen at least once.
+    int warmup = options.assertNoAlloc ? std::max(options.warmup, static_cast<int>(frames.size())) : options.warmup;
+    for (int i = 0; i < warmup; i++) {
+        results.clear();
+        const cv::Mat &frame = frames[i % frames.size()];
+        char *warmupRet = options.tiled ? core.RunTiledSession(frame, options.tiles, results) : core.RunSession(frame, results);
+        if (warmupRet == RET_OK && options.detectInterval > 0) {
+            tracker.Update(results);
+        }
+    }
+
+    FrameRecorder recorder;
+    if (!options.recordPath.empty() && (Ret = recorder.Open(options.recordPath)) != RET_OK) {
+        std::fprintf(stderr, "%s\n", Ret);
+        return 1;
+    }
+    CAPTURE_SETTINGS recordSettings = MakeCaptureSettings(params.RectConfidenceThreshold, params.iouThreshold,
+                                                          options.inputSize, options.inputSize, params.ClassAwareNms);
+
+    PERF_STAGE_STATS stats[PERF_STAGE_COUNT];
+    GetPerfStats(stats, true);
+    MOTION_GATE_STATS motion;
+    GetMotionGateStats(motion, true);
+    SetPerfStatsEnabled(true);
+    int detectorRuns = 0;
+    size_t detections = 0;
+    int allocatingFrames = 0;
+    uint64_t allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frameCount; i++) {
+        results.clear();
+        uint64_t allocationsBefore = ThreadAllocationCount();
+        const cv::Mat &frame = frames[i % frames.size()];
+        if (options.detectInterval > 0 && !tracker.NeedsDetection()) {
+            tracker.Predict(results);
+        } else if (!gate.NeedsInference(frame)) {
+            results = gate.Cached();
+        } else {
+            Ret = options.tiled ? core.RunTiledSession(frame, options.tiles, results) : core.RunSession(frame, results);
+            detectorRuns++;
+            if (Ret == RET_OK) {
+                if (options.detectInterval > 0) {
+                    tracker.Update(results);
+                }
+                gate.Commit(results);
+            }
+        }
+        uint64_t frameAllocations = ThreadAllocationCount() - allocationsBefore;
+        if (Ret != RET_OK) {
+            std::fprintf(stderr, "Frame %d: %s\n", i, Ret);
+            return 1;
+        }
+        if (frameAllocations > 0) {
+            allocatingFrames++;
+            allocations += frameAllocations;
+        }
+        detections += results.size();
+        if (!options.recordPath.empty()) {
+            // Synthetic 30 FPS timestamps so --realtime replays pace like a camera.
+            CAPTURE_META meta;
+            meta.timestampNs = static_cast<int64_t>(i) * 33333333;
+            recorder.Write(frame, meta, &results, &recordSettings);
+        }
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    recorder.Close();
+    SetPerfStatsEnabled(false);
+    GetPerfStats(stats, true);
+    GetMotionGateStats(motion, true);
+
+    std::printf("model      %s (%dx%d, %s, %d intra-op threads)\n", options.modelPath.c_str(), options.inputSize,
+                options.inputSize, ExecutionProviderName(core.provider), budget.IntraOpNumThreads);
+    std::printf("session    %.1f ms (%s)\n", core.sessionCreateMs,
+                options.cacheDir.empty() ? "cache off" : core.sessionFromCache ? "cache hit" : "cache miss");
+    std::printf("frames     %d in %.1f ms, %.2f FPS, %.2f detections/frame\n", frameCount, elapsedMs,
+                frameCount * 1000.0 / elapsedMs, static_cast<double>(detections) / frameCount);
+    if (options.tiled) {
+        std::printf("tiles      %dx%d, %.0f%% overlap%s\n", options.tiles.columns, options.tiles.rows,
+                    options.tiles.overlap * 100.f, options.tiles.fullFrame ? ", plus the whole frame" : "");
+    }
+    if (options.detectInterval > 0) {
+        std::printf("tracker    detector ran on %d of %d frames, %zu tracks alive\n", detectorRuns, frameCount,
+                    tracker.TrackCount());
+    }
+    if (gate.Enabled()) {
+        std::printf("motion     skipped %llu of %llu frames (threshold %.2f)\n",
+                    static_cast<unsigned long long>(motion.skipped), static_cast<unsigned long long>(motion.checked),
+                    gate.Param().threshold);
+    }
+    std::printf("%-12s %10s %10s %10s %10s %10s %10s\n", "stage", "count", "mean(ms)", "p50(ms)", "p95(ms)",
+                "p99(ms)", "max(ms)");
+    for (int stage = 0; stage < PERF_STAGE_COUNT; stage++) {
+        const PERF_STAGE_STATS &s = stats[stage];
+        if (s.count == 0) {
+            continue;
+        }
+        std::printf("%-12s %10llu %10.3f %10.3f %10.3f %10.3f %10.3f\n", PerfStageName(static_cast<PERF_STAGE>(stage)),
+                    static_cast<unsigned long long>(s.count), s.meanMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs);
+    }
+    TENSOR_POOL_STATS pool = TensorPool::Shared().Stats();
+    std::printf("tensors    %.1f MiB peak, %.1f%% of %llu allocations reused", pool.peakBytes / 1048576.0,
+                pool.allocations > 0 ? 100.0 * pool.reused / pool.allocations : 0.0,
+                static_cast<unsigned long long>(pool.allocations));
+    if (pool.budgetBytes > 0) {
+        std::printf(", budget %.1f MiB, %llu refused", pool.budgetBytes / 1048576.0,
+                    static_cast<unsigned long long>(pool.refused));
+    }
+    std::printf("\n");
+    if (AllocationCountingEnabled()) {
+        std::printf("heap       %d of %d frames allocated (%llu allocations outside ONNX Runtime)\n", allocatingFrames,
+                    frameCount, static_cast<unsigned long long>(allocations));
+        if (options.assertNoAlloc && allocatingFrames > 0) {
+            std::fprintf(stderr, "Steady-state frames allocated from the global heap.\n");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -19,3 +19,39 @@ const VisionJsiProcessor = VisionJsiProcessorModule
 export function install() {
   VisionJsiProcessor.install();
 }
+
+export interface Detection {
+  classId: number;
+  confidence: number;
+  box: [number, number, number, number];
+  /** Stable across frames when the detector was created with `tracking: true`. */
+  trackId?: number;
+}
+
+/**
+ * Decodes the Float32Array returned by `processOnnxFrame(..., 'packed')`:
+ * `[count, fieldCount, classIds..., confidences..., xs..., ys..., widths..., heights..., trackIds...]`.
+ * Track IDs are -1 for untracked detections and are left out of the decoded objects.
+ */
+export function decodePackedDetections(packed: Float32Array): Detection[] {
+  'worklet';
+  const count = packed[0] ?? 0;
+  const fieldCount = packed[1] ?? 0;
+  const field = (index: number, i: number) => packed[2 + index * count + i] ?? 0;
+  const detections: Detection[] = [];
+  if (fieldCount < 6) {
+    return detections;
+  }
+  for (let i = 0; i < count; i++) {
+    const detection: Detection = {
+      classId: field(0, i),
+      confidence: field(1, i),
+      box: [field(2, i), field(3, i), field(4, i), field(5, i)],
+    };
+    if (fieldCount >= 7 && field(6, i) >= 0) {
+      detection.trackId = field(6, i);
+    }
+    detections.push(detection);
+  }
+  return detections;
+}